@@ -0,0 +1,86 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "accept_lock.h"
+#include "log.h"
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace tinyrpc;
+
+union semun {
+    int val;
+    struct semid_ds* buf;
+    unsigned short* array;
+};
+
+bool AcceptLock::create() {
+    semid_ = semget(IPC_PRIVATE, 1, IPC_CREAT | 0600);
+    if (semid_ < 0) {
+        LOG(Error, "semget failed, err:%s", strerror(errno));
+        return false;
+    }
+
+    union semun arg;
+    arg.val = 1;
+    if (semctl(semid_, 0, SETVAL, arg) < 0) {
+        LOG(Error, "semctl SETVAL failed, err:%s", strerror(errno));
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+void AcceptLock::destroy() {
+    if (semid_ >= 0) {
+        semctl(semid_, 0, IPC_RMID);
+        semid_ = -1;
+    }
+}
+
+bool AcceptLock::tryLock() {
+    if (isLocked_) {
+        return true;
+    }
+
+    struct sembuf op;
+    op.sem_num = 0;
+    op.sem_op = -1;
+    op.sem_flg = IPC_NOWAIT | SEM_UNDO;
+
+    while (semop(semid_, &op, 1) < 0) {
+        if (EINTR == errno) {
+            continue;
+        }
+        if (EAGAIN != errno) {
+            LOG(Error, "semop lock failed, err:%s", strerror(errno));
+        }
+        return false;
+    }
+    isLocked_ = true;
+    return true;
+}
+
+void AcceptLock::unlock() {
+    if (!isLocked_) {
+        return;
+    }
+
+    struct sembuf op;
+    op.sem_num = 0;
+    op.sem_op = 1;
+    op.sem_flg = SEM_UNDO;
+
+    while (semop(semid_, &op, 1) < 0) {
+        if (EINTR == errno) {
+            continue;
+        }
+        LOG(Error, "semop unlock failed, err:%s", strerror(errno));
+        return;
+    }
+    isLocked_ = false;
+}
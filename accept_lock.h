@@ -0,0 +1,39 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __ACCEPT_LOCK_H__
+#define __ACCEPT_LOCK_H__
+
+namespace tinyrpc {
+
+/*
+ * Inter-process accept lock on a SysV semaphore, created before fork.
+ * Only the holder watches the shared listenfd. SEM_UNDO gives the lock
+ * back if the holder dies, a pthread mutex in shm would stay locked.
+ */
+class AcceptLock {
+public:
+    AcceptLock() : semid_(-1), isLocked_(false) {}
+    AcceptLock(const AcceptLock&) = delete;
+    AcceptLock& operator = (const AcceptLock&) = delete;
+    ~AcceptLock() = default;
+
+    // by the watcher, before fork
+    bool create();
+    // by the watcher, when it exits
+    void destroy();
+
+    // non-blocking
+    bool tryLock();
+    void unlock();
+    bool isLocked() const { return isLocked_; }
+
+private:
+    int semid_;
+    bool isLocked_;     // held by this process
+};
+
+} // namespace tinyrpc
+
+#endif // __ACCEPT_LOCK_H__
@@ -87,6 +87,12 @@ bool CcClient::synCall(const REQ& req, std::shared_ptr<RSP>& rsp,
 
     auto startTime = std::chrono::steady_clock::now();
 
+    CallContext ctx(protocolType(), REQ::URI, RSP::URI, nullptr, conn_.get(),
+        &req, nullptr);
+    if (!interceptCall(ctx)) {
+        return false;
+    }
+
     std::string message;
     if (!serialize(req, message)) {
         LOG(Error, "Serialize failed, uri:0x%xu", REQ::URI);
@@ -113,11 +119,20 @@ bool CcClient::synCall(const REQ& req, std::shared_ptr<RSP>& rsp,
         return false;
     }
 
+    ctx.rsp = rsp.get();
+    interceptReply(ctx);
     return true;
 }
 
 template<typename REQ>
 bool CcClient::asynCall(const REQ& req) {
+    // the reply goes through the interceptors in the protocol's dispatch
+    CallContext ctx(protocolType(), REQ::URI, 0, nullptr, conn_.get(), &req,
+        nullptr);
+    if (!interceptCall(ctx)) {
+        return false;
+    }
+
     std::string message;
     if (!serialize(req, message)) {
         LOG(Error, "Serialize failed, uri:0x%xu", REQ::URI);
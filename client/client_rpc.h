@@ -69,6 +69,11 @@ public:
     template<typename T>
     bool serialize(const T& req, std::string& out);
 
+    // runtime interceptors around the calls, see interceptor.h
+    void addInterceptor(const std::shared_ptr<Interceptor>& interceptor) {
+        codec_->addInterceptor(interceptor);
+    }
+
 protected:
     virtual std::shared_ptr<Protocol> getProtocol() = 0;
     virtual ProtocolType protocolType() const = 0;
@@ -76,6 +81,24 @@ protected:
 protected:
     bool connect();
 
+    // false: turned down by an interceptor
+    bool interceptCall(CallContext& ctx) {
+        const InterceptorList& interceptors = codec_->getInterceptors();
+        if (!interceptors.empty() && !interceptors.onCall(ctx)) {
+            LOG(Warn, "call turned down by an interceptor, uri:0x%xu",
+                ctx.reqUri);
+            return false;
+        }
+        return true;
+    }
+
+    void interceptReply(CallContext& ctx) {
+        const InterceptorList& interceptors = codec_->getInterceptors();
+        if (!interceptors.empty()) {
+            interceptors.onReply(ctx);
+        }
+    }
+
     ClientOptions options_;
     std::shared_ptr<Connection> conn_;
     std::shared_ptr<Codec> codec_;
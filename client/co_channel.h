@@ -0,0 +1,373 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __CO_CHANNEL_H__
+#define __CO_CHANNEL_H__
+
+#include "coroutine.h"
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include "codec.h"
+#include "connection.h"
+#include "option.h"
+#include "socket.h"
+#include "util.h"
+#include <google/protobuf/message.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+#include <unordered_map>
+
+namespace tinyrpc {
+namespace co {
+
+/*
+ * Non-blocking rpc connection driven by a Poller, pb and cc requests may
+ * share it. call() sends at once and returns an awaitable; the response is
+ * matched by the traceId the server echoes, so calls may be in flight
+ * concurrently and complete out of order:
+ *
+ *   auto a = channel->call<EchoReq, EchoRsp>(echoReq);
+ *   auto b = channel->call<BookReq, BookRsp>(bookReq);
+ *   std::shared_ptr<EchoRsp> echoRsp = co_await a; // nullptr: fail/timeout
+ *   std::shared_ptr<BookRsp> bookRsp = co_await b;
+ *
+ * Must only be used on the poller's loop thread.
+ */
+class CoChannel : public std::enable_shared_from_this<CoChannel> {
+public:
+    struct CallState {
+        std::coroutine_handle<> handle;
+        VoidPtr result;
+        uint32_t rspUri;
+        uint64_t timerId;   // of the timeout
+        bool isDone;
+        // the channel was destroyed with the call in flight: never resumed
+        bool isAborted;
+
+        CallState() : rspUri(0), timerId(0), isDone(true), isAborted(false) {}
+    };
+    using CallStatePtr = std::shared_ptr<CallState>;
+
+    template<typename RSP>
+    class CallAwaiter {
+    public:
+        explicit CallAwaiter(const CallStatePtr& state) : state_(state) {}
+
+        bool await_ready() const noexcept { return state_->isDone; }
+        void await_suspend(std::coroutine_handle<> h) { state_->handle = h; }
+        std::shared_ptr<RSP> await_resume() {
+            return std::static_pointer_cast<RSP>(state_->result);
+        }
+
+    private:
+        CallStatePtr state_;
+    };
+
+    // connect with opt.connectTimeoutMs (blocking) and attach to poller
+    static std::shared_ptr<CoChannel> create(Poller* poller,
+                                             const ClientOptions& opt) {
+        std::shared_ptr<CoChannel> channel(new CoChannel(poller));
+        if (!channel->connect(opt)) {
+            return nullptr;
+        }
+        return channel;
+    }
+
+    CoChannel(const CoChannel&) = delete;
+    CoChannel& operator = (const CoChannel&) = delete;
+
+    // calls in flight are aborted, not resumed: their coroutines could
+    // touch the channel being destroyed
+    ~CoChannel() {
+        shutdown(false);
+    }
+
+    bool isOk() const { return conn_ && conn_->isOk(); }
+
+    size_t getPendingNum() const { return pending_.size(); }
+
+    // runtime interceptors around the calls, see interceptor.h
+    void addInterceptor(const std::shared_ptr<Interceptor>& interceptor) {
+        codec_.addInterceptor(interceptor);
+    }
+
+    template<typename REQ, typename RSP>
+    CallAwaiter<RSP> call(const REQ& req, uint32_t timeoutMs = 3000);
+
+    // fail all calls in flight with nullptr
+    void close() {
+        // a resumed coroutine may release the last reference
+        std::shared_ptr<CoChannel> self = shared_from_this();
+        shutdown(true);
+    }
+
+private:
+    explicit CoChannel(Poller* poller)
+        : poller_(poller)
+        , conn_(std::make_shared<Connection>())
+        , seq_(0) {}
+
+    template<typename T>
+    static constexpr bool isPb() {
+        return std::is_base_of<google::protobuf::Message, T>::value;
+    }
+
+    template<typename T>
+    bool serialize(const T& req, std::string& out);
+
+    template<typename T>
+    void registerDescriptor();
+
+    bool connect(const ClientOptions& opt);
+    void shutdown(bool isResume);
+    void onRead(int fd, int events, void* arg);
+    void onWrite(int fd, int events, void* arg);
+    void complete(uint64_t seq, uint32_t rspUri, const VoidPtr& result,
+                  bool isTimeout = false);
+    // the seq of a traceId made by call(), false if it is not one
+    static bool parseSeq(const char* traceId, uint64_t& seq);
+
+    Poller* poller_;
+    Codec codec_;
+    std::shared_ptr<Connection> conn_;
+    uint64_t seq_;
+    std::unordered_map<uint64_t, CallStatePtr> pending_;
+};
+
+template<typename T>
+bool CoChannel::serialize(const T& req, std::string& out) {
+    if constexpr (isPb<T>()) {
+        return req.SerializeToString(&out);
+    } else {
+        cc::Payload payload;
+        req.serialize(payload);
+        out = payload.getData();
+        return true;
+    }
+}
+
+template<typename T>
+void CoChannel::registerDescriptor() {
+    if constexpr (isPb<T>()) {
+        auto dispatcher = std::static_pointer_cast<pb::Dispatcher>(
+            codec_.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher());
+        dispatcher->registerDescriptor<T>();
+    } else {
+        auto dispatcher = std::static_pointer_cast<cc::Dispatcher>(
+            codec_.getProtocol(PROTOCOL_TYPE_CC)->getDispatcher());
+        dispatcher->registerDescriptor<T>();
+    }
+}
+
+template<typename REQ, typename RSP>
+CoChannel::CallAwaiter<RSP> CoChannel::call(const REQ& req,
+                                            uint32_t timeoutMs) {
+    // isDone until sent: a failed call resumes at once with nullptr
+    auto state = std::make_shared<CallState>();
+    state->rspUri = RSP::URI;
+
+    if (!isOk()) {
+        LOG(Error, "channel is not connected, uri:0x%xu", REQ::URI);
+        return CallAwaiter<RSP>(state);
+    }
+
+    registerDescriptor<RSP>();
+
+    uint64_t seq = ++seq_;
+    char traceId[PROTOCOL_TRACEID_SIZE] = {0};
+    snprintf(traceId, sizeof(traceId), "co-%016llx", (unsigned long long)seq);
+
+    uint32_t protocolType = isPb<REQ>() ? PROTOCOL_TYPE_PB : PROTOCOL_TYPE_CC;
+    const InterceptorList& interceptors = codec_.getInterceptors();
+    CallContext ctx(protocolType, REQ::URI, RSP::URI, traceId, conn_.get(),
+        &req, nullptr);
+    if (!interceptors.empty() && !interceptors.onCall(ctx)) {
+        LOG(Warn, "call turned down by an interceptor, uri:0x%xu", REQ::URI);
+        return CallAwaiter<RSP>(state);
+    }
+
+    std::string message;
+    if (!serialize(req, message)) {
+        LOG(Error, "Serialize failed, uri:0x%xu", REQ::URI);
+        return CallAwaiter<RSP>(state);
+    }
+    int fd = conn_->getFd();
+    if (!Codec::sendMessage(conn_.get(), protocolType, REQ::URI, message,
+                            traceId)) {
+        LOG(Error, "Send message failed, uri:0x%xu", REQ::URI);
+        return CallAwaiter<RSP>(state);
+    }
+    if (conn_->hasPendingRsp() && !poller_->hasEvent(fd, EV_WRITE)) {
+        poller_->addEvent(fd, EV_WRITE);
+    }
+
+    state->isDone = false;
+    pending_[seq] = state;
+
+    std::weak_ptr<CoChannel> weak = shared_from_this();
+    poller_->addTimer(timeoutMs, false, [weak, seq](int, int, void*) {
+        if (auto channel = weak.lock()) {
+            channel->complete(seq, 0, nullptr, true);
+        }
+    }, nullptr, &state->timerId);
+
+    return CallAwaiter<RSP>(state);
+}
+
+inline bool CoChannel::connect(const ClientOptions& opt) {
+    std::string host = opt.serviceAddrOption.ip_;
+    std::string port = std::to_string(opt.serviceAddrOption.port_);
+
+    int fd = Socket::connect(host, port, opt.connectTimeoutMs);
+    if (fd < 0) {
+        LOG(Error, "connect failed! host:%s, port:%s", host.c_str(),
+            port.c_str());
+        return false;
+    }
+    Util::set_fl(fd, O_NONBLOCK);
+
+    conn_->setFd(fd);
+    conn_->setStatus(CONN_STATUS_OK);
+    AddrInfo* remoteAddr = conn_->getRemoteAddr();
+    strncpy(remoteAddr->ip, host.c_str(), sizeof(remoteAddr->ip) - 1);
+    remoteAddr->port = opt.serviceAddrOption.port_;
+
+    poller_->setFdReadCallback(fd,
+        [this](int fd, int events, void* arg) { onRead(fd, events, arg); },
+        this);
+    poller_->setFdWriteCallback(fd,
+        [this](int fd, int events, void* arg) { onWrite(fd, events, arg); },
+        this);
+    return poller_->addFd(fd, EV_READ);
+}
+
+inline void CoChannel::shutdown(bool isResume) {
+    if (conn_->getFd() >= 0) {
+        int fd = conn_->getFd();
+        poller_->delFd(fd);
+        ::close(fd);
+        conn_->reset();
+    }
+
+    std::unordered_map<uint64_t, CallStatePtr> pending;
+    pending.swap(pending_);
+    for (auto& it : pending) {
+        CallStatePtr& state = it.second;
+        poller_->cancelTimer(state->timerId);
+        state->isDone = true;
+        state->isAborted = !isResume;
+        if (isResume && state->handle) {
+            state->handle.resume();
+        }
+    }
+}
+
+inline bool CoChannel::parseSeq(const char* traceId, uint64_t& seq) {
+    // "co-" and 16 hex digits, the rest of the field zeroed
+    const size_t len = 3 + 16;
+    if (0 != strncmp(traceId, "co-", 3) || '\0' != traceId[len]) {
+        return false;
+    }
+    char digits[17] = {0};
+    memcpy(digits, traceId + 3, 16);
+    char* end = nullptr;
+    seq = strtoull(digits, &end, 16);
+    return end == digits + 16 && isxdigit((unsigned char)digits[0]);
+}
+
+inline void CoChannel::onRead(int fd, int events, void* arg) {
+    // a resumed coroutine may release the last reference
+    std::shared_ptr<CoChannel> self = shared_from_this();
+
+    if (conn_->tcpRecv()) {
+        while (isOk()) {
+            ProtocolHead head;
+            char* package = nullptr;
+            uint32_t packageSize = 0;
+
+            int ret = codec_.unpack(conn_.get(), head, &package, packageSize);
+            if (0 == ret) {
+                break;
+            } else if (ret < 0) {
+                close();
+                return;
+            }
+
+            uint64_t seq = 0;
+            if (!parseSeq(head.traceId, seq)) {
+                LOG(Error, "unknown traceId, uri:0x%x,fd:%d",
+                    head.protocolUri, fd);
+                continue;
+            }
+            VoidPtr message;
+            std::shared_ptr<Protocol> protocol =
+                codec_.getProtocol(head.protocolType);
+            if (isRejectedUri(head.protocolUri)) {
+                LOG(Warn, "rejected! uri:0x%x,protocolType:%u",
+                    head.protocolUri, head.protocolType);
+            } else if (!protocol || !protocol->parseToMessage(package,
+                    packageSize, head.protocolUri, message)) {
+                LOG(Error, "parseToMessage fail, protocolUri:0x%xu",
+                    head.protocolUri);
+            } else if (!codec_.getInterceptors().empty()) {
+                CallContext ctx(head.protocolType, 0, head.protocolUri,
+                    head.traceId, conn_.get(), nullptr, message.get());
+                codec_.getInterceptors().onReply(ctx);
+            }
+            complete(seq, head.protocolUri, message);
+        }
+    }
+
+    if (conn_->getStatus() == CONN_STATUS_BROKEN) {
+        LOG(Info, "sock broken! fd:%d", fd);
+        close();
+    }
+}
+
+inline void CoChannel::onWrite(int fd, int events, void* arg) {
+    if (!conn_->tcpSend() || conn_->getStatus() == CONN_STATUS_BROKEN) {
+        close();
+        return;
+    }
+    if (!conn_->hasPendingRsp()) {
+        poller_->delEvent(fd, EV_WRITE);
+    }
+}
+
+inline void CoChannel::complete(uint64_t seq, uint32_t rspUri,
+                                const VoidPtr& result, bool isTimeout) {
+    auto it = pending_.find(seq);
+    if (it == pending_.end()) {
+        // timed out already, or answered
+        return;
+    }
+
+    CallStatePtr state = it->second;
+    pending_.erase(it);
+    if (!isTimeout) {
+        poller_->cancelTimer(state->timerId);
+    }
+
+    if (result && rspUri != state->rspUri) {
+        LOG(Error, "unexpected rspUri:0x%xu, want:0x%xu", rspUri,
+            state->rspUri);
+    } else {
+        state->result = result;
+    }
+    state->isDone = true;
+
+    if (state->handle) {
+        state->handle.resume();
+    }
+}
+
+} // namespace co
+} // namespace tinyrpc
+
+#endif // __cplusplus >= 202002L
+#endif // __CO_CHANNEL_H__
@@ -5,14 +5,19 @@
 #include "codec.h"
 #include "log.h"
 #include <string.h>
+#include <sys/time.h>
 
 using namespace tinyrpc;
 using namespace tinyrpc::cc;
 using namespace tinyrpc::pb;
 
-Codec::Codec() {
-    protocolMap_[PROTOCOL_TYPE_PB] = std::make_shared<PbProtocol>();
-    protocolMap_[PROTOCOL_TYPE_CC] = std::make_shared<CcProtocol>();
+Codec::Codec()
+    : protocols_()
+    , codel_(nullptr)
+    , rateLimiter_(nullptr)
+    , responseCache_(nullptr) {
+    registerProtocol(PROTOCOL_TYPE_PB, std::make_shared<PbProtocol>());
+    registerProtocol(PROTOCOL_TYPE_CC, std::make_shared<CcProtocol>());
 }
 
 bool Codec::processMessage(Connection* conn) {
@@ -30,17 +35,80 @@ bool Codec::processMessage(Connection* conn) {
 
         //head.dump();
 
-        if (protocolMap_.find(head.protocolType) == protocolMap_.end()) {
+        Protocol* protocol = protocols_[head.protocolType];
+        if (!protocol) {
             LOG(Error, "unknown protocol type:0x%x,fd:%d", 
                 head.protocolType, conn->getFd());
             return false;
         }
         
-        protocolMap_[head.protocolType]->dispatch(package, packageSize, 
-            head.protocolUri, conn);
+        // client side: a call turned down by the server
+        if (isRejectedUri(head.protocolUri)) {
+            LOG(Warn, "rejected! uri:0x%x,fd:%d", head.protocolUri,
+                conn->getFd());
+            continue;
+        }
+
+        if (rateLimiter_ && !rateLimiter_->admit(conn->getRemoteAddr()->ip,
+                head.protocolUri)) {
+            sendMessage(conn, head.protocolType, PROTOCOL_URI_RATE_LIMITED,
+                std::string(), head.traceId);
+            continue;
+        }
+
+        if (codel_ && !admit(conn)) {
+            sendMessage(conn, head.protocolType, PROTOCOL_URI_CONGESTED,
+                std::string(), head.traceId);
+            continue;
+        }
+
+        conn->setLastUri(head.protocolUri);
+        conn->addReqNum();
+        UriCacheTable* cache = responseCache_ ?
+            responseCache_->find(head.protocolUri) : nullptr;
+        if (cache && !protocol->isIntercepted(head.protocolUri)) {
+            dispatchCached(cache, protocol, head, package, packageSize, conn);
+            continue;
+        }
+        protocol->dispatch(package, packageSize, head.protocolUri, conn);
     }
 }
 
+void Codec::dispatchCached(UriCacheTable* table, Protocol* protocol,
+                           const ProtocolHead& head, char* package,
+                           uint32_t packageSize, Connection* conn) {
+    const char* body = package + ProtocolHead::getLen();
+    uint32_t bodyLen = packageSize - ProtocolHead::getLen();
+    int64_t nowMs = Poller::getMonotonicMicros() / 1000;
+    uint64_t hash = ResponseCache::hash(head.protocolType, body, bodyLen);
+    uint32_t rspUri = 0;
+    const std::string* rsp = responseCache_->get(table, hash,
+        head.protocolType, body, bodyLen, nowMs, rspUri);
+    if (rsp) {
+        sendMessage(conn, head.protocolType, rspUri, *rsp, head.traceId);
+        return;
+    }
+
+    InlineResponse kept;
+    protocol->dispatchInline(package, packageSize, head.protocolUri, conn,
+        &kept);
+    if (kept.isSet) {
+        responseCache_->put(table, hash, head.protocolType, body, bodyLen,
+            kept.rspUri, kept.data, nowMs);
+    }
+}
+
+bool Codec::admit(Connection* conn) {
+    // the clock is read per frame: the frames of one read wait for the
+    // ones before them too
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t nowUs = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+    int64_t rxUs = conn->getRxUs();
+    int64_t sojournUs = rxUs > 0 && nowUs > rxUs ? nowUs - rxUs : 0;
+    return codel_->admit(sojournUs, nowUs);
+}
+
 int Codec::unpack(Connection* conn, ProtocolHead& head, char** data, 
                   uint32_t& len) {
     Buffer *rcvbuf = conn->getRcvBuf();
@@ -79,15 +147,17 @@ int Codec::unpack(Connection* conn, ProtocolHead& head, char** data,
 }
 
 bool Codec::sendMessage(Connection* conn, uint32_t protocolType, 
-                        uint32_t protocolUri, const std::string& message) {
-    if (pack(conn, protocolType, protocolUri, message)) {
+                        uint32_t protocolUri, const std::string& message,
+                        const char* traceId) {
+    if (pack(conn, protocolType, protocolUri, message, traceId)) {
         return conn->tcpSend();
     }
     return false;
 }
 
 bool Codec::pack(Connection* conn, uint32_t protocolType,
-                 uint32_t protocolUri, const std::string& message) {
+                 uint32_t protocolUri, const std::string& message,
+                 const char* traceId) {
     const char *body = message.c_str();
     uint32_t payloadLen = message.length();
     uint32_t headLen = ProtocolHead::getLen();
@@ -96,6 +166,9 @@ bool Codec::pack(Connection* conn, uint32_t protocolType,
     head.length = headLen + payloadLen;
     head.protocolType = protocolType;
     head.protocolUri = protocolUri;
+    if (traceId) {
+        memcpy(head.traceId, traceId, PROTOCOL_TRACEID_SIZE);
+    }
 
     // TODO create checksum
     //head.checksum = xxx;
@@ -114,9 +187,52 @@ bool Codec::pack(Connection* conn, uint32_t protocolType,
     return true;
 }
 
+bool Codec::isCacheableUri(uint32_t reqUri) const {
+    for (const Protocol* protocol : protocols_) {
+        if (protocol && protocol->isInline(reqUri)) {
+            return !protocol->isIntercepted(reqUri);
+        }
+    }
+    return false;
+}
+
 std::shared_ptr<Protocol> Codec::getProtocol(uint32_t protocolType) {
-    if (protocolMap_.find(protocolType) == protocolMap_.end()) {
+    if (protocolType >= PROTOCOL_TYPE_MAX) {
         return nullptr;
     }
-    return protocolMap_[protocolType];
+    return holders_[protocolType];
+}
+
+bool Codec::registerProtocol(uint32_t protocolType,
+                             const std::shared_ptr<Protocol>& protocol) {
+    if (protocolType >= PROTOCOL_TYPE_MAX || !protocol ||
+        holders_[protocolType]) {
+        LOG(Error, "registerProtocol failed! protocolType:%u", protocolType);
+        return false;
+    }
+    return replaceProtocol(protocolType, protocol);
+}
+
+bool Codec::replaceProtocol(uint32_t protocolType,
+                            const std::shared_ptr<Protocol>& protocol) {
+    if (protocolType >= PROTOCOL_TYPE_MAX || !protocol) {
+        LOG(Error, "replaceProtocol failed! protocolType:%u", protocolType);
+        return false;
+    }
+
+    // registered after setHandlerContext(): it gets the same context
+    protocol->setHandlerContext(handlerContext_);
+    protocol->setInterceptors(&interceptors_);
+    holders_[protocolType] = protocol;
+    protocols_[protocolType] = protocol.get();
+    return true;
+}
+
+void Codec::setHandlerContext(const HandlerContext& context) {
+    handlerContext_ = context;
+    for (auto& protocol : holders_) {
+        if (protocol) {
+            protocol->setHandlerContext(context);
+        }
+    }
 }
\ No newline at end of file
@@ -7,12 +7,14 @@
 
 #include "protocol.h"
 #include "connection.h"
+#include "codel.h"
+#include "rate_limit.h"
+#include "response_cache.h"
 #include "dispatcher_pb/protocol_pb.h"
 #include "dispatcher_cc/protocol_cc.h"
 #include <stdint.h>
 #include <string>
 #include <poll.h>
-#include <unordered_map>
 
 namespace tinyrpc {
 
@@ -28,18 +30,75 @@ public:
     bool processResponse(Connection* conn, std::shared_ptr<T>& rsp, 
                          uint32_t timeout = 3000);
 
+    // traceId: PROTOCOL_TRACEID_SIZE bytes put in the head, or nullptr
     static bool sendMessage(Connection* conn, uint32_t protocolType,
-                            uint32_t protocolUri, const std::string& message);
+                            uint32_t protocolUri, const std::string& message,
+                            const char* traceId = nullptr);
 
     std::shared_ptr<Protocol> getProtocol(uint32_t protocolType);
 
-private:
+    // reqUri has an inline handler in a protocol and no interceptor around
+    // it, for ResponseCache::setUri
+    bool isCacheableUri(uint32_t reqUri) const;
+
+    // a wire format of your own at a free type(PROTOCOL_TYPE_USER and up),
+    // frames with that type in the head are dispatched to it. false if the
+    // type is out of range or taken
+    bool registerProtocol(uint32_t protocolType,
+                          const std::shared_ptr<Protocol>& protocol);
+
+    // put protocol at protocolType, taken or not. the one there before is
+    // released from the table, protocol may keep it to pass frames on
+    bool replaceProtocol(uint32_t protocolType,
+                         const std::shared_ptr<Protocol>& protocol);
+
+    // runtime interceptors of every protocol, before the loop runs
+    void addInterceptor(const std::shared_ptr<Interceptor>& interceptor) {
+        interceptors_.add(interceptor);
+    }
+
+    const InterceptorList& getInterceptors() const { return interceptors_; }
+
+    // server side: pass the HandlerContext to every protocol
+    void setHandlerContext(const HandlerContext& context);
+
+    // server side: requests are admitted by codel before they are parsed,
+    // the conns need Connection::enableRxTimestamp. nullptr: all admitted
+    void setAdmission(CoDel* codel) { codel_ = codel; }
+    // server side: requests are checked against the buckets of their
+    // remote ip and uri before they are parsed. nullptr: not limited
+    void setRateLimiter(RateLimiter* limiter) { rateLimiter_ = limiter; }
+    // server side: requests of the cached uris are answered from cache, on
+    // a miss the response of the inline handler is kept(see
+    // Protocol::dispatchInline). a uri intercepted since setUri is
+    // dispatched as uncached. nullptr: no cache
+    void setResponseCache(ResponseCache* cache) { responseCache_ = cache; }
+
+    // cut one frame from rcvbuf: >0 frame size, 0 not complete, <0 error
     int unpack(Connection* conn, ProtocolHead& head, char** data, uint32_t& len);
 
+private:
+    // CoDel on the sojourn of the frame just cut from conn
+    bool admit(Connection* conn);
+    // a request of a cached uri: from cache, or dispatched and kept
+    void dispatchCached(UriCacheTable* table, Protocol* protocol,
+                        const ProtocolHead& head, char* package,
+                        uint32_t packageSize, Connection* conn);
+
     static bool pack(Connection* conn, uint32_t protocolType, 
-        uint32_t protocolUri, const std::string& message);
+        uint32_t protocolUri, const std::string& message,
+        const char* traceId);
+
+    // indexed by the protocolType byte of the head: protocols_ is read per
+    // frame, holders_ owns them
+    Protocol* protocols_[PROTOCOL_TYPE_MAX];
+    std::shared_ptr<Protocol> holders_[PROTOCOL_TYPE_MAX];
 
-    std::unordered_map<uint32_t, std::shared_ptr<Protocol>> protocolMap_;
+    HandlerContext handlerContext_;
+    InterceptorList interceptors_;
+    CoDel* codel_;
+    RateLimiter* rateLimiter_;
+    ResponseCache* responseCache_;
 
 };
 
@@ -95,13 +154,20 @@ bool Codec::processResponse(Connection* conn, std::shared_ptr<T>& rsp,
             return false;
         }
 
-        if (protocolMap_.find(head.protocolType) == protocolMap_.end()) {
+        if (isRejectedUri(head.protocolUri)) {
+            LOG(Warn, "rejected! uri:0x%x,fd:%d", head.protocolUri,
+                conn->getFd());
+            return false;
+        }
+
+        Protocol* protocol = protocols_[head.protocolType];
+        if (!protocol) {
             LOG(Error, "unknown protocol type:0x%x", head.protocolType);
             return false;
         }
         
         VoidPtr message;
-        if (!protocolMap_[head.protocolType]->parseToMessage(package,
+        if (!protocol->parseToMessage(package,
                 packageSize, head.protocolUri, message)) {
             return false;
         }
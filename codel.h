@@ -0,0 +1,74 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __CODEL_H__
+#define __CODEL_H__
+
+#include <stdint.h>
+
+namespace tinyrpc {
+
+/*
+ * CoDel(Controlled Delay) admission of a worker. The sojourn of a request is
+ * how long its frame waited, from arrival on the socket(SO_TIMESTAMP, see
+ * Connection::enableRxTimestamp) to dispatch in Codec::processMessage.
+ * Once the sojourn has stayed above target for a whole interval the worker
+ * is congested: requests are answered with PROTOCOL_URI_CONGESTED without
+ * being parsed, until one waited less than target, i.e. the queue drained.
+ *
+ * Like CoDel it looks at the minimum, not the average: one request below
+ * target ends the interval, so a burst that is worked off in time is let
+ * through whole. Loop thread only.
+ */
+class CoDel {
+public:
+    CoDel(uint32_t targetUs, uint32_t intervalUs)
+        : targetUs_(targetUs)
+        , intervalUs_(intervalUs)
+        , intervalEndUs_(0)
+        , isCongested_(false)
+        , congestedNum_(0)
+        , rejectedNum_(0) {}
+
+    // a request that waited sojournUs, at nowUs. false: turn it down
+    bool admit(int64_t sojournUs, int64_t nowUs) {
+        if (sojournUs < (int64_t)targetUs_) {
+            intervalEndUs_ = 0;
+            isCongested_ = false;
+            return true;
+        }
+
+        if (!isCongested_) {
+            if (0 == intervalEndUs_) {
+                intervalEndUs_ = nowUs + intervalUs_;
+                return true;
+            }
+            if (nowUs < intervalEndUs_) {
+                return true;
+            }
+            isCongested_ = true;
+            congestedNum_++;
+        }
+        rejectedNum_++;
+        return false;
+    }
+
+    bool isCongested() const { return isCongested_; }
+    // times the worker got congested / requests turned down, since start
+    uint64_t getCongestedNum() const { return congestedNum_; }
+    uint64_t getRejectedNum() const { return rejectedNum_; }
+
+private:
+    uint32_t targetUs_;
+    uint32_t intervalUs_;
+    // sojourn is above target since intervalEndUs_ - intervalUs_, 0: below
+    int64_t intervalEndUs_;
+    bool isCongested_;
+    uint64_t congestedNum_;
+    uint64_t rejectedNum_;
+};
+
+} // namespace tinyrpc
+
+#endif // __CODEL_H__
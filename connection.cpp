@@ -6,15 +6,24 @@
 #include "log.h"
 #include <assert.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 
 using namespace tinyrpc;
 
 Connection::Connection(int fd, uint32_t bufSize) 
     : sockfd_(fd), 
+      id_(0),
       status_(CONN_STATUS_NONE),
       family_(AF_INET),
       rcvbuf_(new Buffer(bufSize)),
-      sndbuf_(new Buffer(bufSize)) {
+      sndbuf_(new Buffer(bufSize)),
+      lastActiveTime_(0),
+      lastUri_(0),
+      reqNum_(0),
+      inflight_(0),
+      ioCounters_(nullptr),
+      isRxTimestamp_(false),
+      rxUs_(0) {
     
 }
 
@@ -34,7 +43,41 @@ Connection::~Connection() {
     }
 }
 
-ssize_t Connection::myRecv(int fd, char *buf, size_t len, int &fdErr) {
+static int64_t toMicros(const struct timeval& tv) {
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// recv, and the SCM_TIMESTAMP of the data into rxUs if it is still 0
+static ssize_t recvStamped(int fd, char *buf, size_t len, int64_t* rxUs) {
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = len;
+    char control[CMSG_SPACE(sizeof(struct timeval))];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t rlen = ::recvmsg(fd, &msg, 0);
+    if (rlen <= 0) {
+        return rlen;
+    }
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (SOL_SOCKET == cmsg->cmsg_level &&
+            SCM_TIMESTAMP == cmsg->cmsg_type && 0 == *rxUs) {
+            struct timeval tv;
+            memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+            *rxUs = toMicros(tv);
+        }
+    }
+    return rlen;
+}
+
+ssize_t Connection::myRecv(int fd, char *buf, size_t len, int &fdErr,
+                           int64_t* rxUs) {
     ssize_t ret = 0;
     ssize_t rlen = 0;
     if (len <= 0) {
@@ -42,7 +85,8 @@ ssize_t Connection::myRecv(int fd, char *buf, size_t len, int &fdErr) {
     }
 
     while (true) {
-        rlen = ::recv(fd, buf + ret, len - ret, 0);
+        rlen = rxUs ? recvStamped(fd, buf + ret, len - ret, rxUs)
+            : ::recv(fd, buf + ret, len - ret, 0);
         if (rlen == 0) {
             LOG(Info,"rlen = 0, fd closed! fd:%d", fd);
             fdErr = FD_ERR_BROKEN;
@@ -112,7 +156,19 @@ bool Connection::tcpRecv()
     }
     
     int fdErr = FD_ERR_NONE;
-    ssize_t len = myRecv(sockfd_, start, free_size, fdErr);
+    int64_t rxUs = 0;
+    // bytes left from an earlier read(a partial frame) keep their stamp
+    bool isLeftover = rcvbuf_->size() > 0 && rxUs_ > 0;
+    ssize_t len = myRecv(sockfd_, start, free_size, fdErr,
+        isRxTimestamp_ && !isLeftover ? &rxUs : nullptr);
+    if (isRxTimestamp_ && !isLeftover && len > 0) {
+        if (0 == rxUs) {
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            rxUs = toMicros(now);
+        }
+        rxUs_ = rxUs;
+    }
     
     if (fdErr == FD_ERR_BROKEN || fdErr == FD_ERR_OTHER) {
         status_ = CONN_STATUS_BROKEN;
@@ -124,6 +180,9 @@ bool Connection::tcpRecv()
     }
     
     rcvbuf_->setWriteSize(len);    
+    if (ioCounters_) {
+        ioCounters_->bytesIn += len;
+    }
     return true;
 }
 
@@ -153,6 +212,9 @@ bool Connection::tcpSend()
     }
     
     sndbuf_->setReadSize(len);
+    if (ioCounters_) {
+        ioCounters_->bytesOut += len;
+    }
     return true;
 }
 
@@ -168,6 +230,19 @@ bool Connection::outRcvBuf(char* outbuff, uint32_t len)
     return rcvbuf_->out(outbuff, len);
 }
 
+bool Connection::enableRxTimestamp() {
+    int optval = 1;
+    if (::setsockopt(sockfd_, SOL_SOCKET, SO_TIMESTAMP, &optval,
+                     sizeof(optval)) < 0) {
+        LOG(Warn, "SO_TIMESTAMP failed, fd:%d, err:%s", sockfd_,
+            strerror(errno));
+        return false;
+    }
+    isRxTimestamp_ = true;
+    rxUs_ = 0;
+    return true;
+}
+
 void Connection::setReusePort(int sockfd)
 {
 #ifdef SO_REUSEPORT
@@ -25,6 +25,14 @@ enum ConnStatus {
     CONN_STATUS_BROKEN,
 };
 
+// bytes moved by the conns of one loop, see Connection::setIoCounters
+struct IoCounters {
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+
+    IoCounters() : bytesIn(0), bytesOut(0) {}
+};
+
 typedef struct AddrInfo {
     enum {
         IP_SIZE = 128,
@@ -42,6 +50,9 @@ public:
 
     void setFd(int fd) { sockfd_ = fd; }
     int getFd() const { return sockfd_; }
+    // unique per accepted conn, fd is reused after close
+    void setId(uint64_t id) { id_ = id; }
+    uint64_t getId() const { return id_; }
     void setStatus(ConnStatus status) { status_ = status; }
     int getStatus() const { return status_; }
     bool isOk() const { return status_ == CONN_STATUS_OK; }
@@ -50,8 +61,30 @@ public:
     int getFamily() const { return family_; }
     void updateLastActiveTime(time_t t) { lastActiveTime_ = t; }
     time_t getLastActiveTime() const { return lastActiveTime_; }
-
-    static ssize_t myRecv(int fd, char *buf, size_t len, int &fdErr);
+    // uri of the last request dispatched on this conn
+    void setLastUri(uint32_t uri) { lastUri_ = uri; }
+    uint32_t getLastUri() const { return lastUri_; }
+    // requests dispatched on this conn, since it was opened
+    void addReqNum() { reqNum_++; }
+    uint64_t getReqNum() const { return reqNum_; }
+    // deferred/pool/batch requests whose response is not sent or dropped
+    // yet, loop thread only
+    void addInflight() { inflight_++; }
+    void subInflight() { if (inflight_ > 0) inflight_--; }
+    uint32_t getInflight() const { return inflight_; }
+    // tcpRecv/tcpSend add to counters, nullptr: not counted
+    void setIoCounters(IoCounters* counters) { ioCounters_ = counters; }
+    // SO_TIMESTAMP: tcpRecv keeps the kernel receive time of the oldest
+    // data in rcvbuf(realtime us): the stamp of the first recvmsg of a read,
+    // kept while bytes of that read are left. the time it read it if the
+    // socket gives none. 0: nothing read since enabled
+    bool enableRxTimestamp();
+    int64_t getRxUs() const { return rxUs_; }
+
+    // rxUs: receive time of the first data read, set if it is 0 and the
+    // kernel gives one
+    static ssize_t myRecv(int fd, char *buf, size_t len, int &fdErr,
+                          int64_t* rxUs = nullptr);
     static ssize_t mySend(int fd, char *buf, size_t len, int &fdErr);
 
     bool tcpRecv();
@@ -70,14 +103,22 @@ public:
 
     void reset() {
         sockfd_ = -1;
+        id_ = 0;
         status_ = CONN_STATUS_NONE;
         rcvbuf_->reset();
         sndbuf_->reset();
         lastActiveTime_ = 0;
+        lastUri_ = 0;
+        reqNum_ = 0;
+        inflight_ = 0;
+        ioCounters_ = nullptr;
+        isRxTimestamp_ = false;
+        rxUs_ = 0;
     }
 
 private:
     int sockfd_;
+    uint64_t id_;
     ConnStatus status_;
     int family_;
 
@@ -88,6 +129,12 @@ private:
     AddrInfo localAddr_;
 
     time_t lastActiveTime_;
+    uint32_t lastUri_;
+    uint64_t reqNum_;
+    uint32_t inflight_;
+    IoCounters* ioCounters_;
+    bool isRxTimestamp_;
+    int64_t rxUs_;
 };
 
 } // namespace tinyrpc
@@ -0,0 +1,213 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __COROUTINE_H__
+#define __COROUTINE_H__
+
+/*
+ * Optional C++20 coroutine layer, the rest of tinyrpc stays C++14.
+ *
+ * Everything here runs on one Poller's loop thread: a coroutine suspends on
+ * co_await and is resumed by the loop (timer, response of a CoChannel call),
+ * so the loop never blocks and one worker can keep many calls in flight.
+ *
+ * server side, a coroutine handler is a deferred callback:
+ *
+ *   co::Task<void> onEchoReq(std::shared_ptr<EchoReq> req,
+ *                            std::shared_ptr<EchoRsp> rsp) {
+ *       auto bookRsp = co_await channel->call<BookReq, BookRsp>(bookReq);
+ *       co_await co::sleepFor(srv.getPoller(), 10);
+ *       rsp->set_info(...);
+ *   }
+ *   srv.pbRegisterDeferredCallback<EchoReq, EchoRsp>(
+ *       co::makeDeferred<EchoReq, EchoRsp>(onEchoReq));
+ *
+ * take handler parameters by value, they must live in the coroutine frame.
+ */
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include "poller.h"
+#include "responder.h"
+#include "log.h"
+#include <coroutine>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace tinyrpc {
+namespace co {
+
+template<typename T>
+class Task;
+
+namespace detail {
+
+// resume whoever co_awaited the task when it finishes
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template<typename PROMISE>
+    std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<PROMISE> h) noexcept {
+        std::coroutine_handle<> next = h.promise().continuation;
+        return next ? next : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept {
+        LOG(Error, "unhandled exception in coroutine");
+        std::abort();
+    }
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    T value;
+
+    Task<T> get_return_object() noexcept;
+    void return_value(T v) { value = std::move(v); }
+    T result() { return std::move(value); }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+    void result() {}
+};
+
+} // namespace detail
+
+// lazy coroutine, starts when co_awaited or spawn()ed
+template<typename T = void>
+class Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle h) : handle_(h) {}
+    Task(Task&& t) noexcept : handle_(std::exchange(t.handle_, nullptr)) {}
+    Task& operator = (Task&& t) noexcept {
+        if (this != &t) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(t.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator = (const Task&) = delete;
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) noexcept {
+        handle_.promise().continuation = h;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().result(); }
+
+private:
+    Handle handle_;
+};
+
+namespace detail {
+
+template<typename T>
+inline Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// eager coroutine that owns itself, the frame is freed when it ends
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+            LOG(Error, "unhandled exception in coroutine");
+            std::abort();
+        }
+    };
+};
+
+inline Detached runDetached(Task<void> task, std::function<void ()> onDone) {
+    co_await task;
+    if (onDone) {
+        onDone();
+    }
+}
+
+} // namespace detail
+
+// start task on the current thread, onDone is called when it finishes
+inline void spawn(Task<void> task, std::function<void ()> onDone = nullptr) {
+    detail::runDetached(std::move(task), std::move(onDone));
+}
+
+// co_await sleepFor(poller, ms): resumed by a timer of poller
+class SleepAwaiter {
+public:
+    SleepAwaiter(Poller* poller, int ms) : poller_(poller), ms_(ms) {}
+
+    bool await_ready() const noexcept { return ms_ <= 0; }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        poller_->addTimer(ms_, false, [h](int fd, int events, void* arg) {
+            h.resume();
+        }, nullptr);
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    Poller* poller_;
+    int ms_;
+};
+
+inline SleepAwaiter sleepFor(Poller* poller, int ms) {
+    return SleepAwaiter(poller, ms);
+}
+
+// adapt a coroutine handler to Server::xxRegisterDeferredCallback(),
+// the response is sent when the coroutine returns
+template<typename REQ, typename RSP>
+std::function<void (const std::shared_ptr<REQ>&, const std::shared_ptr<RSP>&,
+                    const ResponderPtr&)>
+makeDeferred(std::function<Task<void> (std::shared_ptr<REQ>,
+                                       std::shared_ptr<RSP>)> handler) {
+    return [handler](const std::shared_ptr<REQ>& req,
+                     const std::shared_ptr<RSP>& rsp,
+                     const ResponderPtr& responder) {
+        spawn(handler(req, rsp), [responder]() { responder->done(); });
+    };
+}
+
+} // namespace co
+} // namespace tinyrpc
+
+#endif // __cplusplus >= 202002L
+#endif // __COROUTINE_H__
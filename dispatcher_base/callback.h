@@ -10,6 +10,7 @@
 #include  "callback_base.h"
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace tinyrpc {
 namespace detail {
@@ -25,6 +26,13 @@ public:
     using ServerRequest = std::function<void (const std::shared_ptr<REQ>&,
         const std::shared_ptr<RSP>&)>;
 
+    using DeferredRequest = std::function<void (const std::shared_ptr<REQ>&,
+        const std::shared_ptr<RSP>&, const ResponderPtr&)>;
+
+    using BatchRequest = std::function<void (
+        const std::vector<std::shared_ptr<REQ>>&,
+        const std::vector<std::shared_ptr<RSP>>&)>;
+
     using AsyncCallback = std::function<void (const std::shared_ptr<RSP>&)>;
 
     explicit Callback() = default;
@@ -34,6 +42,16 @@ public:
         callback_ = cb;
     }
 
+    void setDeferredRequest(const DeferredRequest& cb) {
+        deferredCallback_ = cb;
+        mode_ = CALLBACK_MODE_DEFERRED;
+    }
+
+    void setBatchRequest(const BatchRequest& cb) {
+        batchCallback_ = cb;
+        mode_ = CALLBACK_MODE_BATCH;
+    }
+
     void setAsyncCallback(const std::function<void (
                                 const std::shared_ptr<RSP>&)>& cb) {
         asyncCallback_ = cb;
@@ -46,6 +64,28 @@ public:
         callback_(concreteReq, concreteRsp);
     }
 
+    void onServerRequest(const VoidPtr& req, const VoidPtr& rsp,
+                         const ResponderPtr& responder) const {
+        auto concreteReq = down_pointer_cast<REQ>(req);
+        auto concreteRsp = down_pointer_cast<RSP>(rsp);
+        assert(concreteReq && concreteRsp);
+        deferredCallback_(concreteReq, concreteRsp, responder);
+    }
+
+    void onServerBatch(const std::vector<VoidPtr>& reqs,
+                       const std::vector<VoidPtr>& rsps) const {
+        assert(reqs.size() == rsps.size());
+        std::vector<std::shared_ptr<REQ>> concreteReqs;
+        std::vector<std::shared_ptr<RSP>> concreteRsps;
+        concreteReqs.reserve(reqs.size());
+        concreteRsps.reserve(rsps.size());
+        for (size_t i = 0; i < reqs.size(); i++) {
+            concreteReqs.push_back(down_pointer_cast<REQ>(reqs[i]));
+            concreteRsps.push_back(down_pointer_cast<RSP>(rsps[i]));
+        }
+        batchCallback_(concreteReqs, concreteRsps);
+    }
+
     void onAsyncResponse(const VoidPtr& rsp) const {
         auto concreteRsp = down_pointer_cast<RSP>(rsp);
         assert(concreteRsp);
@@ -54,6 +94,8 @@ public:
 
 private:
     ServerRequest callback_;
+    DeferredRequest deferredCallback_;
+    BatchRequest batchCallback_;
     AsyncCallback asyncCallback_;
 };
 
@@ -9,9 +9,22 @@
 #include "protocol_traits.h"
 #include <functional>
 #include <memory>
+#include <vector>
 
 
 namespace tinyrpc {
+
+class Responder;
+using ResponderPtr = std::shared_ptr<Responder>;
+
+enum CallbackMode {
+    CALLBACK_MODE_INLINE = 0, // run on the I/O loop, respond on return
+    CALLBACK_MODE_POOL,       // run on the HandlerPool, respond on return
+    CALLBACK_MODE_DEFERRED,   // run on the I/O loop, respond by Responder::done()
+    CALLBACK_MODE_BATCH,      // run on the I/O loop once per loop iteration
+                              // with all requests of the uri, see BatchQueue
+};
+
 namespace detail {
 
 
@@ -35,12 +48,25 @@ inline std::shared_ptr<To> down_pointer_cast(const std::shared_ptr<From>& f) {
 
 class ICallback {
 public:
+    ICallback() : mode_(CALLBACK_MODE_INLINE) {}
     virtual ~ICallback() = default;
     // server-side request callback
     virtual void onServerRequest(const VoidPtr& req, 
                                  const VoidPtr& rsp) const = 0;
+    // server-side deferred request callback
+    virtual void onServerRequest(const VoidPtr& req, const VoidPtr& rsp,
+                                 const ResponderPtr& responder) const = 0;
+    // server-side batch callback, rsps[i] is the response of reqs[i]
+    virtual void onServerBatch(const std::vector<VoidPtr>& reqs,
+                               const std::vector<VoidPtr>& rsps) const = 0;
     // client-side async response callback
     virtual void onAsyncResponse(const VoidPtr& rsp) const = 0;
+
+    CallbackMode mode() const { return mode_; }
+    void setMode(CallbackMode mode) { mode_ = mode; }
+
+protected:
+    CallbackMode mode_;
 };
 
 } // namespace detail
@@ -9,45 +9,67 @@
 
 #include "protocol_traits.h"
 #include "callback.h"
+#include "route_table.h"
 #include "log.h"
-#include <unordered_map>
 #include <functional>
 #include <memory>
+#include <vector>
 
 
 namespace tinyrpc {
 namespace detail {
 
+// DISPATCHER(CRTP) provides getPrototype<T>() and newMessage(prototype)
 template<typename PROTOCOL, typename DISPATCHER>
 class GenericDispatcher {
 public:
     using Traits = detail::ProtocolTraits<PROTOCOL>;
     using MessageType = typename Traits::MessageType;
-    using DescriptorPtr = typename Traits::DescriptorPtr;
+    using PrototypePtr = typename Traits::PrototypePtr;
     using MessagePtr = std::shared_ptr<MessageType>;
     using CallbackPtr = std::shared_ptr<ICallback>;
 
-    using DescriptorMap = std::unordered_map<uint32_t, DescriptorPtr>;
-    using CallbackMap = std::unordered_map<uint32_t, CallbackPtr>;
-    using Req2RspMap = std::unordered_map<uint32_t, uint32_t>;
+    // everything dispatch needs for a uri, found by one probe
+    struct Route {
+        uint32_t uri;
+        uint32_t rspUri;            // 0: no callback, == uri: async response
+        PrototypePtr prototype;     // 基于 prototype 创建 MessagePtr
+        PrototypePtr rspPrototype;  // of rspUri, for a request
+        CallbackPtr callback;
+
+        Route() : uri(0), rspUri(0), prototype(), rspPrototype() {}
+    };
 
     virtual ~GenericDispatcher() = default;
 
-   template<typename REQ, typename RSP>
+    template<typename REQ, typename RSP>
     void registerCallback(std::function<void(const std::shared_ptr<REQ>&,
-                                const std::shared_ptr<RSP>&)> callback) {
+                                const std::shared_ptr<RSP>&)> callback,
+                          CallbackMode mode = CALLBACK_MODE_INLINE) {
         auto cb = std::make_shared<Callback<PROTOCOL, REQ, RSP>>();
         cb->setServerRequest(callback);
-        callback_[REQ::URI] = cb;
-        req2rsp_[REQ::URI] = RSP::URI;
-        descriptor_[REQ::URI] = static_cast<DISPATCHER*>(this)->template 
-            getDescriptor<REQ>();
-        descriptor_[RSP::URI] = static_cast<DISPATCHER*>(this)->template
-            getDescriptor<RSP>();
+        cb->setMode(mode);
+        addServerCallback<REQ, RSP>(cb);
+    }
 
-        assert(REQ::URI - RSP::URI != 0);
-        LOG(Info, "%s::registerCallback! req uri:0x%xu, rsp uri:0x%xu",
-            Traits::name(), REQ::URI, RSP::URI);
+    template<typename REQ, typename RSP>
+    void registerDeferredCallback(std::function<void(
+                                const std::shared_ptr<REQ>&,
+                                const std::shared_ptr<RSP>&,
+                                const ResponderPtr&)> callback) {
+        auto cb = std::make_shared<Callback<PROTOCOL, REQ, RSP>>();
+        cb->setDeferredRequest(callback);
+        addServerCallback<REQ, RSP>(cb);
+    }
+
+    template<typename REQ, typename RSP>
+    void registerBatchCallback(std::function<void(
+                                const std::vector<std::shared_ptr<REQ>>&,
+                                const std::vector<std::shared_ptr<RSP>>&)>
+                                callback) {
+        auto cb = std::make_shared<Callback<PROTOCOL, REQ, RSP>>();
+        cb->setBatchRequest(callback);
+        addServerCallback<REQ, RSP>(cb);
     }
 
     template<typename REQ, typename RSP>
@@ -55,10 +77,11 @@ public:
                                 const std::shared_ptr<RSP>&)> callback) {
         auto cb = std::make_shared<Callback<PROTOCOL, REQ, RSP>>();
         cb->setAsyncCallback(callback);
-        callback_[RSP::URI] = cb;
-        req2rsp_[RSP::URI] = RSP::URI;
-        descriptor_[RSP::URI] = static_cast<DISPATCHER*>(this)
-            ->template getDescriptor<RSP>();
+        Route& route = routes_.insert(RSP::URI);
+        route.rspUri = RSP::URI;
+        route.prototype = prototypeOf<RSP>();
+        route.rspPrototype = route.prototype;
+        route.callback = cb;
         LOG(Info, "%s::registerCallback! rsp uri:0x%xu", 
             Traits::name(), RSP::URI);
     }
@@ -67,26 +90,34 @@ public:
     void registerDescriptor()
     {
         if (!checkProtocolUri(T::URI)) {
-            descriptor_[T::URI] = static_cast<DISPATCHER*>(this)
-                ->template getDescriptor<T>();
+            routes_.insert(T::URI).prototype = prototypeOf<T>();
         }
     }
 
+    const Route* findRoute(uint32_t protocolUri) const {
+        return routes_.find(protocolUri);
+    }
+
     bool onServerRequest(uint32_t reqUri, const MessagePtr& req, 
                          const VoidPtr& rsp) {
-        auto it = callback_.find(reqUri);
-        if (it != callback_.end()) {
-            it->second->onServerRequest(req, rsp);
+        const Route* route = routes_.find(reqUri);
+        if (route && route->callback) {
+            route->callback->onServerRequest(req, rsp);
             return true;
         }
         LOG(Error, "no callback! reqUri:0x%xu", reqUri);
         return false;
     }
 
+    CallbackPtr getCallback(uint32_t protocolUri) const {
+        const Route* route = routes_.find(protocolUri);
+        return route ? route->callback : nullptr;
+    }
+
     bool onAsyncResponse(uint32_t rspUri, const MessagePtr& rsp) {
-        auto it = callback_.find(rspUri);
-        if (it != callback_.end()) {
-            it->second->onAsyncResponse(rsp);
+        const Route* route = routes_.find(rspUri);
+        if (route && route->callback) {
+            route->callback->onAsyncResponse(rsp);
             return true;
         }
         LOG(Error, "no callback! rspUri:0x%xu", rspUri);
@@ -94,25 +125,49 @@ public:
     }
 
     bool checkProtocolUri(uint32_t protocolUri) const {
-        return descriptor_.find(protocolUri) != descriptor_.end();
+        const Route* route = routes_.find(protocolUri);
+        return route && route->prototype;
     }
 
     uint32_t getRspUri(uint32_t reqUri) const {
-        auto it = req2rsp_.find(reqUri);
-        return it != req2rsp_.end() ? it->second : 0;
+        const Route* route = routes_.find(reqUri);
+        return route ? route->rspUri : 0;
     }
 
-    virtual MessagePtr createMessage(uint32_t protocolUri) = 0;
-
+    MessagePtr createMessage(uint32_t protocolUri) {
+        const Route* route = routes_.find(protocolUri);
+        if (!route || !route->prototype) {
+            LOG(Error, "no prototype! protocolUri:0x%xu", protocolUri);
+            return nullptr;
+        }
+        return static_cast<DISPATCHER*>(this)->newMessage(route->prototype);
+    }
 
+protected:
     template <typename T>
-    DescriptorPtr getDescriptor();
+    PrototypePtr prototypeOf() {
+        return static_cast<DISPATCHER*>(this)->template getPrototype<T>();
+    }
 
-protected:
+    template<typename REQ, typename RSP>
+    void addServerCallback(const CallbackPtr& cb) {
+        // the rsp is created by uri too, on the client side. insert may
+        // grow the table: the req route is taken after
+        PrototypePtr rspPrototype = prototypeOf<RSP>();
+        routes_.insert(RSP::URI).prototype = rspPrototype;
+
+        Route& route = routes_.insert(REQ::URI);
+        route.rspUri = RSP::URI;
+        route.prototype = prototypeOf<REQ>();
+        route.rspPrototype = rspPrototype;
+        route.callback = cb;
+
+        assert(REQ::URI - RSP::URI != 0);
+        LOG(Info, "%s::registerCallback! req uri:0x%xu, rsp uri:0x%xu, "
+            "mode:%d", Traits::name(), REQ::URI, RSP::URI, cb->mode());
+    }
 
-    CallbackMap callback_;
-    Req2RspMap req2rsp_;
-    DescriptorMap descriptor_; // 基于 Descriptor 创建 MessagePtr
+    RouteTable<Route> routes_; // uri -> Route, req and rsp uris alike
 };
 
 } // namespace detail
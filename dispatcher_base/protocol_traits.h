@@ -26,7 +26,7 @@ struct ProtocolTraits;
 template<>
 struct ProtocolTraits<PbProtocol> {
     using MessageType = google::protobuf::Message;
-    using DescriptorPtr = const google::protobuf::Descriptor*;
+    using PrototypePtr = const google::protobuf::Message*; // default_instance
     static const char* name() { return "pb"; }
 };
 
@@ -34,7 +34,7 @@ struct ProtocolTraits<PbProtocol> {
 template<>
 struct ProtocolTraits<CcProtocol> {
     using MessageType = cc::Serializable;
-    using DescriptorPtr = std::shared_ptr<cc::Serializable>;
+    using PrototypePtr = std::shared_ptr<cc::Serializable>;
     static const char* name() { return "cc"; }
 };
 
@@ -0,0 +1,99 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __ROUTE_TABLE_H__
+#define __ROUTE_TABLE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+#include <utility>
+#include <vector>
+
+namespace tinyrpc {
+namespace detail {
+
+/*
+ * Flat open-addressed table keyed by uri(!= 0), linear probing, at most
+ * half full. ENTRY has a `uint32_t uri` member, 0 marks an empty slot.
+ * Entries sit in one array: a lookup is a multiply, a shift and usually a
+ * single slot. Not thread safe, written while registering only.
+ */
+template<typename ENTRY>
+class RouteTable {
+public:
+    enum {
+        INIT_BITS = 4,
+    };
+
+    RouteTable() : bits_(INIT_BITS), size_(0) {
+        entries_.resize(1u << bits_);
+    }
+
+    const ENTRY* find(uint32_t uri) const {
+        const uint32_t mask = (uint32_t)entries_.size() - 1;
+        for (uint32_t i = slotOf(uri);; i = (i + 1) & mask) {
+            const ENTRY& entry = entries_[i];
+            if (entry.uri == uri) {
+                return uri ? &entry : nullptr;
+            }
+            if (0 == entry.uri) {
+                return nullptr;
+            }
+        }
+    }
+
+    // the entry of uri, a new one(default constructed) if absent
+    ENTRY& insert(uint32_t uri) {
+        assert(uri != 0);
+        if ((size_ + 1) * 2 > entries_.size()) {
+            grow();
+        }
+        ENTRY& entry = probe(uri);
+        if (0 == entry.uri) {
+            entry.uri = uri;
+            size_++;
+        }
+        return entry;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return entries_.size(); }
+
+private:
+    // fibonacci hashing: the high bits of the product mix all bits of uri
+    uint32_t slotOf(uint32_t uri) const {
+        return (uint32_t)(uri * 2654435769u) >> (32 - bits_);
+    }
+
+    // slot of uri, or the empty slot where it goes
+    ENTRY& probe(uint32_t uri) {
+        const uint32_t mask = (uint32_t)entries_.size() - 1;
+        uint32_t i = slotOf(uri);
+        while (entries_[i].uri != uri && entries_[i].uri != 0) {
+            i = (i + 1) & mask;
+        }
+        return entries_[i];
+    }
+
+    void grow() {
+        std::vector<ENTRY> old(1u << (bits_ + 1));
+        old.swap(entries_);
+        bits_++;
+        for (ENTRY& entry : old) {
+            if (entry.uri != 0) {
+                probe(entry.uri) = std::move(entry);
+            }
+        }
+    }
+
+    uint32_t bits_;
+    size_t size_;
+    std::vector<ENTRY> entries_;
+};
+
+} // namespace detail
+} // namespace tinyrpc
+
+#endif // __ROUTE_TABLE_H__
@@ -0,0 +1,315 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __SERVICE_H__
+#define __SERVICE_H__
+
+#include "codec.h"
+#include "log.h"
+#include <google/protobuf/message.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+/*
+ * Services declared as types: the (REQ, RSP, handler) triples are template
+ * arguments, the uri switch and the calls are generated at compile time.
+ *
+ *  class EchoImpl {
+ *  public:
+ *      void Echo(const EchoReq& req, EchoRsp& rsp);
+ *  };
+ *  using EchoDef = tinyrpc::ServiceDef<EchoImpl,
+ *      TINYRPC_METHOD(EchoImpl, EchoReq, EchoRsp, Echo)>;
+ *
+ *  EchoImpl impl;
+ *  srv.registerService<EchoDef>(&impl);
+ *
+ * The request is parsed into a REQ on the stack and the member function is
+ * called directly: no std::function, ICallback, shared_ptr<void> or cast on
+ * the way. Handlers run inline on the worker loop. protoc-gen-tinyrpc emits
+ * the ServiceDef of a proto `service` block.
+ *
+ * registerService<EchoDef, InterceptorChain<Auth, Metrics>>(&impl) puts
+ * compile-time interceptor stages around the methods, see interceptor.h.
+ */
+
+#define TINYRPC_METHOD(SERVICE, REQ, RSP, NAME) \
+    ::tinyrpc::Method<SERVICE, REQ, RSP, &SERVICE::NAME>
+
+namespace tinyrpc {
+namespace detail {
+
+// how a message is read from and written to a frame body, by its type
+template<typename MSG, bool IS_PB =
+    std::is_base_of<google::protobuf::Message, MSG>::value>
+struct WireFormat;
+
+template<typename MSG>
+struct WireFormat<MSG, true> {
+    enum : uint32_t { PROTOCOL_TYPE = PROTOCOL_TYPE_PB };
+
+    static bool parse(const char* data, uint32_t len, MSG& msg) {
+        return msg.ParseFromArray(data, len);
+    }
+
+    static bool serialize(const MSG& msg, std::string& out) {
+        return msg.SerializeToString(&out);
+    }
+};
+
+template<typename MSG>
+struct WireFormat<MSG, false> {
+    static_assert(std::is_base_of<cc::Serializable, MSG>::value,
+        "a message is a protobuf Message or a cc::Serializable");
+
+    enum : uint32_t { PROTOCOL_TYPE = PROTOCOL_TYPE_CC };
+
+    static bool parse(const char* data, uint32_t len, MSG& msg) {
+        cc::Payload payload(const_cast<char*>(data), len);
+        msg.unserialize(payload);
+        return true;
+    }
+
+    static bool serialize(const MSG& msg, std::string& out) {
+        cc::Payload payload;
+        msg.serialize(payload);
+        out = payload.getData();
+        return true;
+    }
+};
+
+constexpr bool isUriIn(uint32_t) { return false; }
+
+template<typename... REST>
+constexpr bool isUriIn(uint32_t uri, uint32_t first, REST... rest) {
+    return uri == first || isUriIn(uri, rest...);
+}
+
+constexpr bool isUriUnique() { return true; }
+
+template<typename... REST>
+constexpr bool isUriUnique(uint32_t first, REST... rest) {
+    return !isUriIn(first, rest...) && isUriUnique(rest...);
+}
+
+constexpr bool isAllEqual(uint32_t) { return true; }
+
+template<typename... REST>
+constexpr bool isAllEqual(uint32_t first, uint32_t second, REST... rest) {
+    return first == second && isAllEqual(second, rest...);
+}
+
+// a compare per method on constant uris, the compiler makes a switch of it.
+// false: the uri is not one of METHODS
+template<typename CHAIN, typename SERVICE, typename... METHODS>
+struct MethodChain;
+
+template<typename CHAIN, typename SERVICE>
+struct MethodChain<CHAIN, SERVICE> {
+    static bool dispatch(SERVICE*, uint32_t, const char*, uint32_t,
+                         const char*, Connection*, const InterceptorList*,
+                         InlineResponse*, bool&) {
+        return false;
+    }
+};
+
+template<typename CHAIN, typename SERVICE, typename METHOD, typename... REST>
+struct MethodChain<CHAIN, SERVICE, METHOD, REST...> {
+    static bool dispatch(SERVICE* service, uint32_t reqUri, const char* body,
+                         uint32_t len, const char* traceId, Connection* conn,
+                         const InterceptorList* interceptors,
+                         InlineResponse* kept, bool& isOk) {
+        if (reqUri == METHOD::REQ_URI) {
+            isOk = METHOD::template handle<CHAIN>(service, body, len, traceId,
+                conn, interceptors, kept);
+            return true;
+        }
+        return MethodChain<CHAIN, SERVICE, REST...>::dispatch(service, reqUri,
+            body, len, traceId, conn, interceptors, kept, isOk);
+    }
+};
+
+} // namespace detail
+
+// one rpc of a service: HANDLER is called with the parsed request and a
+// response to fill, the response is sent when it returns(and moved into
+// kept, nullptr: not kept). CHAIN and then the runtime interceptors
+// (nullptr: none) are around it
+template<typename SERVICE, typename REQ, typename RSP,
+         void (SERVICE::*HANDLER)(const REQ&, RSP&)>
+struct Method {
+    using Wire = detail::WireFormat<REQ>;
+
+    static constexpr uint32_t REQ_URI = REQ::URI;
+    static constexpr uint32_t RSP_URI = RSP::URI;
+    static constexpr uint32_t PROTOCOL_TYPE = Wire::PROTOCOL_TYPE;
+
+    static_assert(REQ_URI != RSP_URI, "req uri equals rsp uri");
+    static_assert((uint32_t)detail::WireFormat<RSP>::PROTOCOL_TYPE ==
+        PROTOCOL_TYPE, "req and rsp of different protocol types");
+
+    template<typename CHAIN>
+    static bool handle(SERVICE* service, const char* body, uint32_t len,
+                       const char* traceId, Connection* conn,
+                       const InterceptorList* interceptors,
+                       InlineResponse* kept) {
+        REQ req;
+        if (!Wire::parse(body, len, req)) {
+            LOG(Error, "parse failed! reqUri:0x%xu", REQ_URI);
+            return false;
+        }
+
+        RSP rsp;
+        CallContext ctx(PROTOCOL_TYPE, REQ_URI, RSP_URI, traceId, conn, &req,
+            &rsp);
+        if (!CHAIN::onRequest(ctx) ||
+            (interceptors && !interceptors->onRequest(ctx))) {
+            return true;
+        }
+
+        (service->*HANDLER)(req, rsp);
+
+        if (interceptors) {
+            interceptors->onResponse(ctx);
+        }
+        CHAIN::onResponse(ctx);
+
+        std::string data;
+        if (!detail::WireFormat<RSP>::serialize(rsp, data)) {
+            LOG(Error, "serialize failed! rspUri:0x%xu", RSP_URI);
+            return false;
+        }
+        if (!Codec::sendMessage(conn, PROTOCOL_TYPE, RSP_URI, data,
+                traceId)) {
+            return false;
+        }
+        if (kept) {
+            kept->rspUri = RSP_URI;
+            kept->data.swap(data);
+            kept->isSet = true;
+        }
+        return true;
+    }
+};
+
+// the methods of SERVICE, all of one protocol type
+template<typename SERVICE, typename... METHODS>
+struct ServiceDef {
+    using Service = SERVICE;
+
+    static_assert(sizeof...(METHODS) > 0, "a service without methods");
+    static_assert(detail::isUriUnique(METHODS::REQ_URI...),
+        "a req uri is used by two methods");
+    static_assert(detail::isAllEqual(METHODS::PROTOCOL_TYPE...),
+        "methods of different protocol types");
+
+    static constexpr uint32_t PROTOCOL_TYPE = std::tuple_element<0,
+        std::tuple<METHODS...>>::type::PROTOCOL_TYPE;
+
+    static constexpr bool hasMethod(uint32_t reqUri) {
+        return detail::isUriIn(reqUri, METHODS::REQ_URI...);
+    }
+
+    template<typename CHAIN>
+    static bool dispatch(SERVICE* service, uint32_t reqUri, const char* body,
+                         uint32_t len, const char* traceId, Connection* conn,
+                         const InterceptorList* interceptors,
+                         InlineResponse* kept, bool& isOk) {
+        return detail::MethodChain<CHAIN, SERVICE, METHODS...>::dispatch(
+            service, reqUri, body, len, traceId, conn, interceptors, kept,
+            isOk);
+    }
+};
+
+namespace detail {
+
+// in the Codec in place of the protocol of DEF's type: the uris of DEF are
+// handled here, the others go to next_(callbacks registered as before)
+template<typename DEF, typename CHAIN = InterceptorChain<>>
+class ServiceProtocol : public Protocol {
+public:
+    using Service = typename DEF::Service;
+
+    ServiceProtocol(Service* service, const std::shared_ptr<Protocol>& next)
+        : service_(service), next_(next) {}
+
+    void setHandlerContext(const HandlerContext& context) override {
+        Protocol::setHandlerContext(context);
+        if (next_) {
+            next_->setHandlerContext(context);
+        }
+    }
+
+    void setInterceptors(const InterceptorList* interceptors) override {
+        Protocol::setInterceptors(interceptors);
+        if (next_) {
+            next_->setInterceptors(interceptors);
+        }
+    }
+
+    bool parseToMessage(const char* package, uint32_t packageSize,
+                        uint32_t protocolUri, VoidPtr& message) override {
+        return next_ && next_->parseToMessage(package, packageSize,
+            protocolUri, message);
+    }
+
+    bool serializeToString(VoidPtr& message, std::string& data) override {
+        return next_ && next_->serializeToString(message, data);
+    }
+
+    bool dispatch(const char* package, uint32_t packageSize,
+                  uint32_t protocolUri, Connection* conn) override {
+        return dispatchInline(package, packageSize, protocolUri, conn,
+            nullptr);
+    }
+
+    bool dispatchInline(const char* package, uint32_t packageSize,
+                        uint32_t protocolUri, Connection* conn,
+                        InlineResponse* kept) override {
+        uint32_t headLen = ProtocolHead::getLen();
+        bool isOk = false;
+        if (DEF::template dispatch<CHAIN>(service_, protocolUri,
+                package + headLen, packageSize - headLen,
+                ProtocolHead::traceIdOf(package), conn,
+                hasInterceptors() ? interceptors_ : nullptr, kept, isOk)) {
+            return isOk;
+        }
+
+        if (!next_) {
+            LOG(Error, "no route! protocolUri:%d", protocolUri);
+            return false;
+        }
+        return next_->dispatchInline(package, packageSize, protocolUri, conn,
+            kept);
+    }
+
+    // service methods run inline
+    bool isInline(uint32_t reqUri) const override {
+        return DEF::hasMethod(reqUri) || (next_ && next_->isInline(reqUri));
+    }
+
+    // the methods of DEF: the runtime interceptors or a CHAIN of stages
+    bool isIntercepted(uint32_t reqUri) const override {
+        if (DEF::hasMethod(reqUri)) {
+            return hasInterceptors() ||
+                !std::is_same<CHAIN, InterceptorChain<>>::value;
+        }
+        return next_ && next_->isIntercepted(reqUri);
+    }
+
+    VoidPtr getDispatcher() override {
+        return next_ ? next_->getDispatcher() : nullptr;
+    }
+
+private:
+    Service* service_;
+    std::shared_ptr<Protocol> next_;
+};
+
+} // namespace detail
+} // namespace tinyrpc
+
+#endif // __SERVICE_H__
@@ -10,15 +10,7 @@ using namespace tinyrpc;
 using namespace cc;
 
 
-MessagePtr Dispatcher::createMessage(uint32_t protocolUri) {
-    // 基于 Descriptor 创建实例
-    auto it = descriptor_.find(protocolUri);
-    if (it != descriptor_.end()) {
-        // 拷贝构造新的对象：避免复用已有对象去反序列化，数据会堆积到已有对象
-        return it->second->clone();
-    } else {
-        LOG(Error, "no MessagePtr! protocolUri:%u", protocolUri);
-    }
-
-    return nullptr;
+MessagePtr Dispatcher::newMessage(const PrototypePtr& prototype) {
+    // 拷贝构造新的对象：避免复用已有对象去反序列化，数据会堆积到已有对象
+    return prototype->clone();
 }
\ No newline at end of file
@@ -18,10 +18,10 @@ using MessagePtr = std::shared_ptr<Serializable>;
 class Dispatcher : public detail::GenericDispatcher<detail::CcProtocol, Dispatcher> {
 public:
     
-    MessagePtr createMessage(uint32_t protocolUri) override;
+    MessagePtr newMessage(const PrototypePtr& prototype);
 
     template <typename T>
-    DescriptorPtr getDescriptor() {
+    PrototypePtr getPrototype() {
         return std::make_shared<T>();
     }
 };
@@ -19,14 +19,19 @@ bool CcProtocol::parseToMessage(const char* package, uint32_t packageSize,
         return false;
     }
 
+    parseBody(package, packageSize, mes);
+    message = mes;
+    
+    return true;
+}
+
+void CcProtocol::parseBody(const char* package, uint32_t packageSize,
+                           const MessagePtr& mes) {
     uint32_t headLen = ProtocolHead::getLen();
     const char *data = package + headLen;
     int len = packageSize - headLen;
     Payload payload(const_cast<char*>(data), len);
     mes->unserialize(payload);
-    message = mes;
-    
-    return true;
 }
 
 bool CcProtocol::serializeToString(VoidPtr& message, std::string& data) {
@@ -39,13 +44,23 @@ bool CcProtocol::serializeToString(VoidPtr& message, std::string& data) {
 
 bool CcProtocol::dispatch(const char* package, uint32_t packageSize, 
                           uint32_t protocolUri, Connection* conn) {
-    VoidPtr voidMessage;
-    if (!parseToMessage(package, packageSize, protocolUri, voidMessage)) {
+    return dispatchInline(package, packageSize, protocolUri, conn, nullptr);
+}
+
+bool CcProtocol::dispatchInline(const char* package, uint32_t packageSize,
+                                uint32_t protocolUri, Connection* conn,
+                                InlineResponse* kept) {
+    // prototypes, rsp uri and callback of the uri, one lookup
+    const Dispatcher::Route* route = dispatcher_->findRoute(protocolUri);
+    if (!route || !route->prototype) {
+        LOG(Error, "no route! protocolUri:%d", protocolUri);
         return false;
     }
-    MessagePtr mes = std::static_pointer_cast<Serializable>(voidMessage);
+
+    MessagePtr mes = dispatcher_->newMessage(route->prototype);
+    parseBody(package, packageSize, mes);
     
-    uint32_t rspUri = dispatcher_->getRspUri(protocolUri);
+    uint32_t rspUri = route->rspUri;
     if (0 == rspUri) {
         LOG(Error, "getRspUri ret 0! protocolUri:%d", protocolUri);
         return false;
@@ -54,36 +69,70 @@ bool CcProtocol::dispatch(const char* package, uint32_t packageSize,
     if (protocolUri != rspUri) {
         // server-side request callback
         // create rsp
-        MessagePtr rsp = dispatcher_->createMessage(rspUri);
+        MessagePtr rsp = dispatcher_->newMessage(route->rspPrototype);
         assert(rsp);
 
-        // handle request
-        if (!dispatcher_->onServerRequest(protocolUri, mes, rsp)) {
-            LOG(Error, "onServerRequest fail, protocolUri:%d,rspUri:%d", 
-                protocolUri, rspUri);
+        const auto& callback = route->callback;
+        if (!callback) {
+            LOG(Error, "no callback! protocolUri:%d", protocolUri);
             return false;
         }
 
+        // interceptors may turn the request down
+        CallContext ctx(PROTOCOL_TYPE_CC, protocolUri, rspUri,
+            ProtocolHead::traceIdOf(package), conn, mes.get(), rsp.get());
+        if (hasInterceptors() && !interceptors_->onRequest(ctx)) {
+            return true;
+        }
+
+        // response is sent later by Responder, or BatchQueue
+        if (callback->mode() != CALLBACK_MODE_INLINE) {
+            return dispatchDeferred(callback, PROTOCOL_TYPE_CC, protocolUri,
+                rspUri, mes, rsp, ProtocolHead::traceIdOf(package), conn);
+        }
+
+        // handle request
+        callback->onServerRequest(mes, rsp);
+        if (hasInterceptors()) {
+            interceptors_->onResponse(ctx);
+        }
+
         cc::Payload payload;
         rsp->serialize(payload);
+        std::string str = payload.getData();
 
-        if (!Codec::sendMessage(conn, PROTOCOL_TYPE_CC, rspUri, 
-                                payload.getData())) {
+        // echo traceId so the client can match the response
+        if (!Codec::sendMessage(conn, PROTOCOL_TYPE_CC, rspUri, str,
+                                ProtocolHead::traceIdOf(package))) {
             LOG(Error, "sendMessage fail, protocolUri:%d,rspUri:%d",
                 protocolUri, rspUri);
             return false;
         }
+        if (kept) {
+            kept->rspUri = rspUri;
+            kept->data.swap(str);
+            kept->isSet = true;
+        }
     } else {
         // client-side async response callback
-        if (!dispatcher_->onAsyncResponse(protocolUri, mes)) {
-            LOG(Error, "onAsyncResponse fail, protocolUri:%d", protocolUri);
-            return false;
+        if (hasInterceptors()) {
+            CallContext ctx(PROTOCOL_TYPE_CC, 0, protocolUri,
+                ProtocolHead::traceIdOf(package), conn, nullptr, mes.get());
+            interceptors_->onReply(ctx);
         }
+        route->callback->onAsyncResponse(mes);
     }
 
     return true;
 }
 
+bool CcProtocol::isInline(uint32_t reqUri) const {
+    const Dispatcher::Route* route = dispatcher_->findRoute(reqUri);
+    return route && route->callback && route->rspUri != 0 &&
+        route->rspUri != reqUri &&
+        route->callback->mode() == CALLBACK_MODE_INLINE;
+}
+
 VoidPtr CcProtocol::getDispatcher() {
     return dispatcher_;
 }
\ No newline at end of file
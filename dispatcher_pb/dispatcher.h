@@ -19,11 +19,11 @@ using MessagePtr = std::shared_ptr<google::protobuf::Message>;
 class Dispatcher : public detail::GenericDispatcher<detail::PbProtocol, Dispatcher> {
 public:
 
-    MessagePtr createMessage(uint32_t protocolUri) override;
+    MessagePtr newMessage(PrototypePtr prototype);
 
     template <typename T>
-    DescriptorPtr getDescriptor() {
-        return T::descriptor();
+    PrototypePtr getPrototype() {
+        return &T::default_instance();
     }
 };
 
@@ -15,23 +15,26 @@ PbProtocol::PbProtocol()
 bool PbProtocol::parseToMessage(const char* package, uint32_t packageSize, 
                                 uint32_t protocolUri, VoidPtr& message) {
     MessagePtr mes = dispatcher_->createMessage(protocolUri);
-    if (mes) {
-        uint32_t headLen = ProtocolHead::getLen();
-        const char *data = package + headLen;
-        int len = packageSize - headLen;
-        if (mes->ParseFromArray(data, len)) {
-            message = mes;
-            return true;
-        } else {
-            LOG(Error, "ParseFromArray failed! protocolUri:0x%xu", 
-                protocolUri);
-            return false;
-        }
+    if (mes && parseBody(package, packageSize, protocolUri, mes)) {
+        message = mes;
+        return true;
     }
     
     return false;
 }
 
+bool PbProtocol::parseBody(const char* package, uint32_t packageSize,
+                           uint32_t protocolUri, const MessagePtr& mes) {
+    uint32_t headLen = ProtocolHead::getLen();
+    const char *data = package + headLen;
+    int len = packageSize - headLen;
+    if (!mes->ParseFromArray(data, len)) {
+        LOG(Error, "ParseFromArray failed! protocolUri:0x%xu", protocolUri);
+        return false;
+    }
+    return true;
+}
+
 bool PbProtocol::serializeToString(VoidPtr& message, std::string& data) {
     MessagePtr mes = std::static_pointer_cast<google::protobuf::Message>(message);
 
@@ -44,15 +47,26 @@ bool PbProtocol::serializeToString(VoidPtr& message, std::string& data) {
 
 bool PbProtocol::dispatch(const char* package, uint32_t packageSize, 
                           uint32_t protocolUri, Connection* conn) {
-    VoidPtr voidMessage;
-    if (!parseToMessage(package, packageSize, protocolUri, voidMessage)) {
-        LOG(Error, "parseToMessage fail, protocolUri:%d", protocolUri);
+    return dispatchInline(package, packageSize, protocolUri, conn, nullptr);
+}
+
+bool PbProtocol::dispatchInline(const char* package, uint32_t packageSize,
+                                uint32_t protocolUri, Connection* conn,
+                                InlineResponse* kept) {
+    // prototypes, rsp uri and callback of the uri, one lookup
+    const Dispatcher::Route* route = dispatcher_->findRoute(protocolUri);
+    if (!route || !route->prototype) {
+        LOG(Error, "no route! protocolUri:%d", protocolUri);
+        return false;
+    }
+
+    MessagePtr mes = dispatcher_->newMessage(route->prototype);
+    if (!parseBody(package, packageSize, protocolUri, mes)) {
+        LOG(Error, "parseBody fail, protocolUri:%d", protocolUri);
         return false;
     }
-    MessagePtr mes = std::static_pointer_cast<google::protobuf::Message>(
-        voidMessage);
     
-    uint32_t rspUri = dispatcher_->getRspUri(protocolUri);
+    uint32_t rspUri = route->rspUri;
     if (0 == rspUri) {
         LOG(Error, "getRspUri ret 0! protocolUri:%d", protocolUri);
         return false;
@@ -61,15 +75,33 @@ bool PbProtocol::dispatch(const char* package, uint32_t packageSize,
     if (protocolUri != rspUri) {
         // server-side request callback
         // create rsp
-        MessagePtr rsp = dispatcher_->createMessage(rspUri);
+        MessagePtr rsp = dispatcher_->newMessage(route->rspPrototype);
 
-        // handle request
-        if (!dispatcher_->onServerRequest(protocolUri, mes, rsp)) {
-            LOG(Error, "onServerRequest fail, protocolUri:%d,rspUri:%d",
-                protocolUri, rspUri);
+        const auto& callback = route->callback;
+        if (!callback) {
+            LOG(Error, "no callback! protocolUri:%d", protocolUri);
             return false;
         }
 
+        // interceptors may turn the request down
+        CallContext ctx(PROTOCOL_TYPE_PB, protocolUri, rspUri,
+            ProtocolHead::traceIdOf(package), conn, mes.get(), rsp.get());
+        if (hasInterceptors() && !interceptors_->onRequest(ctx)) {
+            return true;
+        }
+
+        // response is sent later by Responder, or BatchQueue
+        if (callback->mode() != CALLBACK_MODE_INLINE) {
+            return dispatchDeferred(callback, PROTOCOL_TYPE_PB, protocolUri,
+                rspUri, mes, rsp, ProtocolHead::traceIdOf(package), conn);
+        }
+
+        // handle request
+        callback->onServerRequest(mes, rsp);
+        if (hasInterceptors()) {
+            interceptors_->onResponse(ctx);
+        }
+
         std::string str;
         if (!rsp->SerializeToString(&str)) {
             LOG(Error, "SerializeToString fail, protocolUri:%d,rspUri:%d",
@@ -77,22 +109,38 @@ bool PbProtocol::dispatch(const char* package, uint32_t packageSize,
             return false;
         }
 
-        if (!Codec::sendMessage(conn, PROTOCOL_TYPE_PB, rspUri, str)) {
+        // echo traceId so the client can match the response
+        if (!Codec::sendMessage(conn, PROTOCOL_TYPE_PB, rspUri, str,
+                                ProtocolHead::traceIdOf(package))) {
             LOG(Error, "sendMessage fail, protocolUri:%d,rspUri:%d",
                 protocolUri, rspUri);
             return false;
         }
+        if (kept) {
+            kept->rspUri = rspUri;
+            kept->data.swap(str);
+            kept->isSet = true;
+        }
     } else {
         // client-side async response callback
-        if (!dispatcher_->onAsyncResponse(protocolUri, mes)) {
-            LOG(Error, "onAsyncResponse fail, protocolUri:%d", protocolUri);
-            return false;
+        if (hasInterceptors()) {
+            CallContext ctx(PROTOCOL_TYPE_PB, 0, protocolUri,
+                ProtocolHead::traceIdOf(package), conn, nullptr, mes.get());
+            interceptors_->onReply(ctx);
         }
+        route->callback->onAsyncResponse(mes);
     }
 
     return true;
 }
 
+bool PbProtocol::isInline(uint32_t reqUri) const {
+    const Dispatcher::Route* route = dispatcher_->findRoute(reqUri);
+    return route && route->callback && route->rspUri != 0 &&
+        route->rspUri != reqUri &&
+        route->callback->mode() == CALLBACK_MODE_INLINE;
+}
+
 VoidPtr PbProtocol::getDispatcher() {
     return dispatcher_;
 }
\ No newline at end of file
@@ -30,10 +30,19 @@ public:
 
     virtual bool dispatch(const char* data, uint32_t len, 
                           uint32_t protocolUri, Connection* conn) override;
+
+    // kept: nullptr from dispatch
+    virtual bool dispatchInline(const char* data, uint32_t len,
+                                uint32_t protocolUri, Connection* conn,
+                                InlineResponse* kept) override;
+
+    virtual bool isInline(uint32_t reqUri) const override;
     
     virtual VoidPtr getDispatcher() override;
 
 private:
+    bool parseBody(const char* package, uint32_t packageSize,
+                   uint32_t protocolUri, const MessagePtr& mes);
 
     std::shared_ptr<Dispatcher> dispatcher_;
 };
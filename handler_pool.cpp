@@ -0,0 +1,194 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "handler_pool.h"
+#include "log.h"
+#include <chrono>
+#include <signal.h>
+#include <pthread.h>
+
+using namespace tinyrpc;
+
+HandlerPool::HandlerPool(uint32_t threadNum)
+    : threadNum_(threadNum > 0 ? threadNum : 1)
+    , isRunning_(false)
+    , nextQueue_(0)
+    , pendingNum_(0) {
+    for (uint32_t i = 0; i < threadNum_; ++i) {
+        queues_.emplace_back(new WorkQueue());
+    }
+}
+
+HandlerPool::~HandlerPool() {
+    stop();
+}
+
+void HandlerPool::addUri(uint32_t uri) {
+    if (isRunning_) {
+        LOG(Error, "addUri after start! uri:0x%xu", uri);
+        return;
+    }
+
+    if (uriStats_.find(uri) == uriStats_.end()) {
+        uriStats_[uri].reset(new UriStats());
+    }
+}
+
+bool HandlerPool::hasUri(uint32_t uri) const {
+    return uriStats_.find(uri) != uriStats_.end();
+}
+
+bool HandlerPool::start() {
+    if (isRunning_.exchange(true)) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < threadNum_; ++i) {
+        threads_.emplace_back(&HandlerPool::threadRun, this, i);
+    }
+    LOG(Info, "handler pool start, threadNum:%u, uriNum:%zu",
+        threadNum_, uriStats_.size());
+    return true;
+}
+
+void HandlerPool::stop() {
+    if (!isRunning_.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(idleMtx_);
+    }
+    idleCond_.notify_all();
+
+    for (auto& t : threads_) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    threads_.clear();
+}
+
+bool HandlerPool::submit(uint32_t uri, Task&& task) {
+    if (!isRunning_) {
+        LOG(Error, "handler pool is not running! uri:0x%xu", uri);
+        return false;
+    }
+
+    auto it = uriStats_.find(uri);
+    if (it == uriStats_.end()) {
+        LOG(Error, "uri is not routed to handler pool! uri:0x%xu", uri);
+        return false;
+    }
+
+    TaskItem item;
+    item.task = std::move(task);
+    item.stats = it->second.get();
+    item.stats->queueDepth.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t index = nextQueue_.fetch_add(1, std::memory_order_relaxed)
+        % threadNum_;
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mtx);
+        queues_[index]->tasks.push_back(std::move(item));
+    }
+    pendingNum_.fetch_add(1);
+
+    // take idleMtx_ so a thread between checking pendingNum_ and wait()
+    // can not miss the notify
+    {
+        std::lock_guard<std::mutex> lock(idleMtx_);
+    }
+    idleCond_.notify_one();
+
+    return true;
+}
+
+const HandlerPool::UriStats* HandlerPool::getUriStats(uint32_t uri) const {
+    auto it = uriStats_.find(uri);
+    return it != uriStats_.end() ? it->second.get() : nullptr;
+}
+
+void HandlerPool::dumpStats() const {
+    for (auto& it : uriStats_) {
+        const UriStats* s = it.second.get();
+        uint64_t count = s->runCount.load(std::memory_order_relaxed);
+        uint64_t total = s->runTimeUs.load(std::memory_order_relaxed);
+        LOG(Info, "handler pool uri:0x%xu,queueDepth:%u,running:%u,"
+            "runCount:%lu,avgRunUs:%lu,maxRunUs:%lu", it.first,
+            s->queueDepth.load(std::memory_order_relaxed),
+            s->running.load(std::memory_order_relaxed),
+            (unsigned long)count,
+            (unsigned long)(count > 0 ? total / count : 0),
+            (unsigned long)s->maxRunTimeUs.load(std::memory_order_relaxed));
+    }
+}
+
+void HandlerPool::threadRun(uint32_t index) {
+    // signals are handled by the I/O loop thread
+    sigset_t mask;
+    sigfillset(&mask);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+    while (true) {
+        TaskItem item;
+        if (popTask(index, item) || stealTask(index, item)) {
+            pendingNum_.fetch_sub(1);
+            runTask(item);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMtx_);
+        idleCond_.wait(lock, [this] {
+            return !isRunning_ || pendingNum_.load() > 0;
+        });
+        if (!isRunning_) {
+            break;
+        }
+    }
+}
+
+bool HandlerPool::popTask(uint32_t index, TaskItem& item) {
+    WorkQueue* q = queues_[index].get();
+    std::lock_guard<std::mutex> lock(q->mtx);
+    if (q->tasks.empty()) {
+        return false;
+    }
+    item = std::move(q->tasks.front());
+    q->tasks.pop_front();
+    return true;
+}
+
+bool HandlerPool::stealTask(uint32_t index, TaskItem& item) {
+    for (uint32_t n = 1; n < threadNum_; ++n) {
+        WorkQueue* q = queues_[(index + n) % threadNum_].get();
+        std::lock_guard<std::mutex> lock(q->mtx);
+        if (!q->tasks.empty()) {
+            item = std::move(q->tasks.back());
+            q->tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void HandlerPool::runTask(TaskItem& item) {
+    UriStats* s = item.stats;
+    s->queueDepth.fetch_sub(1, std::memory_order_relaxed);
+    s->running.fetch_add(1, std::memory_order_relaxed);
+
+    auto begin = std::chrono::steady_clock::now();
+    item.task();
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    s->running.fetch_sub(1, std::memory_order_relaxed);
+    s->runCount.fetch_add(1, std::memory_order_relaxed);
+    s->runTimeUs.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t maxUs = s->maxRunTimeUs.load(std::memory_order_relaxed);
+    while (us > maxUs && !s->maxRunTimeUs.compare_exchange_weak(maxUs, us,
+            std::memory_order_relaxed)) {
+    }
+}
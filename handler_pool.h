@@ -0,0 +1,102 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __HANDLER_POOL_H__
+#define __HANDLER_POOL_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tinyrpc {
+
+/*
+ * Work-stealing thread pool for slow handlers.
+ *
+ * Each thread owns a deque. submit() pushes to the deques round-robin, the
+ * owner pops from the front, an idle thread steals from the back of the
+ * others. Handlers routed here never block the worker's I/O loop; their
+ * responses go back to the loop through ResponseQueue.
+ */
+class HandlerPool {
+public:
+    using Task = std::function<void()>;
+
+    struct UriStats {
+        std::atomic<uint32_t> queueDepth;   // submitted but not started
+        std::atomic<uint32_t> running;
+        std::atomic<uint64_t> runCount;
+        std::atomic<uint64_t> runTimeUs;    // sum of run time
+        std::atomic<uint64_t> maxRunTimeUs;
+
+        UriStats()
+            : queueDepth(0)
+            , running(0)
+            , runCount(0)
+            , runTimeUs(0)
+            , maxRunTimeUs(0) {}
+    };
+
+    explicit HandlerPool(uint32_t threadNum);
+    HandlerPool(const HandlerPool&) = delete;
+    HandlerPool& operator = (const HandlerPool&) = delete;
+    ~HandlerPool();
+
+    // route uri to the pool, must be called before start()
+    void addUri(uint32_t uri);
+    bool hasUri(uint32_t uri) const;
+
+    bool start();
+    void stop();
+
+    bool submit(uint32_t uri, Task&& task);
+
+    // nullptr if uri is not routed to the pool
+    const UriStats* getUriStats(uint32_t uri) const;
+    void dumpStats() const;
+
+    uint32_t getThreadNum() const { return threadNum_; }
+
+private:
+    struct TaskItem {
+        Task task;
+        UriStats* stats;
+        TaskItem() : stats(nullptr) {}
+    };
+
+    struct WorkQueue {
+        std::mutex mtx;
+        std::deque<TaskItem> tasks;
+    };
+
+    void threadRun(uint32_t index);
+    bool popTask(uint32_t index, TaskItem& item);
+    bool stealTask(uint32_t index, TaskItem& item);
+    void runTask(TaskItem& item);
+
+    uint32_t threadNum_;
+    std::atomic<bool> isRunning_;
+    std::atomic<uint32_t> nextQueue_;
+    std::atomic<uint32_t> pendingNum_;
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex idleMtx_;
+    std::condition_variable idleCond_;
+
+    // read only after start()
+    std::unordered_map<uint32_t, std::unique_ptr<UriStats>> uriStats_;
+};
+
+} // namespace tinyrpc
+
+#endif // __HANDLER_POOL_H__
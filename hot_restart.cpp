@@ -0,0 +1,132 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "hot_restart.h"
+#include "pipe_msg.h"
+#include "log.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace tinyrpc;
+
+static bool makeAddr(const std::string& path, struct sockaddr_un& addr) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        LOG(Error, "bad hot restart path:%s", path.c_str());
+        return false;
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+bool HotRestart::connect(const std::string& path, int timeoutMs) {
+    struct sockaddr_un addr;
+    if (!makeAddr(path, addr)) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG(Error, "socket failed, err:%s", strerror(errno));
+        return false;
+    }
+    // a stale path(ECONNREFUSED/ENOENT) means nobody to take over from
+    if (::connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        LOG(Info, "no server to take over at %s, err:%s", path.c_str(),
+            strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    // blocking, but never wait for a stuck old server forever
+    struct timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    close();
+    fd_ = fd;
+    return true;
+}
+
+bool HotRestart::takeListenFd(int& listenfd) {
+    listenfd = -1;
+
+    PipeMsg req;
+    req.type = PIPE_MSG_TAKEOVER_REQ;
+    if (!PipeChannel::send(fd_, req)) {
+        return false;
+    }
+
+    PipeMsg rsp;
+    int passFd = -1;
+    if (PipeChannel::recv(fd_, rsp, passFd) <= 0 ||
+            PIPE_MSG_LISTEN_FD != rsp.type) {
+        LOG(Error, "take over failed, no listenfd reply, type:%u", rsp.type);
+        if (passFd >= 0) {
+            ::close(passFd);
+        }
+        return false;
+    }
+    listenfd = passFd;
+    return true;
+}
+
+bool HotRestart::sendDone() {
+    PipeMsg msg;
+    msg.type = PIPE_MSG_TAKEOVER_DONE;
+    return PipeChannel::send(fd_, msg);
+}
+
+bool HotRestart::listen(const std::string& path) {
+    struct sockaddr_un addr;
+    if (!makeAddr(path, addr)) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    0);
+    if (fd < 0) {
+        LOG(Error, "socket failed, err:%s", strerror(errno));
+        return false;
+    }
+
+    // the path of the old server(or a stale one) is taken over
+    unlink(path.c_str());
+    if (::bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+            ::listen(fd, 4) < 0) {
+        LOG(Error, "hot restart listen on %s failed, err:%s", path.c_str(),
+            strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    close();
+    fd_ = fd;
+    return true;
+}
+
+void HotRestart::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool HotRestart::replyListenFd(int connfd, int listenfd) {
+    PipeMsg msg;
+    msg.type = PIPE_MSG_LISTEN_FD;
+    if (listenfd >= 0) {
+        socklen_t len = sizeof(msg.addr);
+        if (0 == getsockname(listenfd, (struct sockaddr*)&msg.addr, &len)) {
+            msg.addrLen = len;
+        }
+    }
+    return PipeChannel::send(connfd, msg, listenfd);
+}
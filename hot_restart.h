@@ -0,0 +1,50 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __HOT_RESTART_H__
+#define __HOT_RESTART_H__
+
+#include <string>
+
+namespace tinyrpc {
+
+/*
+ * Unix socket(SOCK_SEQPACKET) between the watcher of a running server(old)
+ * and the watcher of its replacement(new), messages are PipeMsg:
+ *   new -> old: PIPE_MSG_TAKEOVER_REQ
+ *   old -> new: PIPE_MSG_LISTEN_FD, with the shared listenfd if old has one
+ *   new -> old: PIPE_MSG_TAKEOVER_DONE, all new workers are accepting,
+ *               old stops accepting, drains its conns and exits
+ * The new watcher listens on the path after DONE, for the next restart.
+ */
+class HotRestart {
+public:
+    HotRestart() : fd_(-1) {}
+    HotRestart(const HotRestart&) = delete;
+    HotRestart& operator = (const HotRestart&) = delete;
+    ~HotRestart() { close(); }
+
+    // new side, blocking. false: no server running at path
+    bool connect(const std::string& path, int timeoutMs);
+    // new side, listenfd is -1 if old has none(ACCEPT_STRATEGY_REUSEPORT)
+    bool takeListenFd(int& listenfd);
+    bool sendDone();
+
+    // old side(and new side after DONE), listening fd
+    bool listen(const std::string& path);
+
+    // the connection(new side) or the listening fd(old side)
+    int getFd() const { return fd_; }
+    void close();
+
+    // PIPE_MSG_TAKEOVER_REQ on connfd: reply with listenfd(-1: none)
+    static bool replyListenFd(int connfd, int listenfd);
+
+private:
+    int fd_;
+};
+
+} // namespace tinyrpc
+
+#endif // __HOT_RESTART_H__
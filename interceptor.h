@@ -0,0 +1,136 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __INTERCEPTOR_H__
+#define __INTERCEPTOR_H__
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+namespace tinyrpc {
+
+class Connection;
+
+// what an interceptor sees of a call. req/rsp point to the messages(the
+// REQ/RSP of the uris: a protobuf Message or a cc::Serializable), nullptr
+// where there is none yet
+struct CallContext {
+    uint32_t protocolType;
+    uint32_t reqUri;
+    uint32_t rspUri;        // 0 for an asynCall, the rsp is not known yet
+    const char* traceId;    // PROTOCOL_TRACEID_SIZE bytes, or nullptr
+    Connection* conn;       // nullptr off the conn's loop(Responder::done)
+    const void* req;
+    const void* rsp;
+
+    CallContext(uint32_t type, uint32_t reqUri_, uint32_t rspUri_,
+                const char* traceId_, Connection* conn_, const void* req_,
+                const void* rsp_)
+        : protocolType(type), reqUri(reqUri_), rspUri(rspUri_),
+          traceId(traceId_), conn(conn_), req(req_), rsp(rsp_) {}
+};
+
+/*
+ * Hooks around dispatch, configured at runtime: Server::addInterceptor,
+ * RpcClient::addInterceptor. Requests go through the interceptors in the
+ * order added, responses in the reverse order. Override what you need.
+ */
+class Interceptor {
+public:
+    virtual ~Interceptor() = default;
+
+    // server: a request before its handler. false: the handler is skipped
+    // and nothing is sent, the interceptor may answer on ctx.conn itself
+    virtual bool onRequest(CallContext& ctx) { return true; }
+    // server: the response after the handler, before it is serialized and
+    // sent. for pool/deferred handlers it runs where done() is called
+    virtual void onResponse(CallContext& ctx) {}
+
+    // client: a request before it is sent. false: the call fails
+    virtual bool onCall(CallContext& ctx) { return true; }
+    // client: a response before it is handed to the caller
+    virtual void onReply(CallContext& ctx) {}
+};
+
+// the runtime chain, filled before the loop runs and read-only after
+class InterceptorList {
+public:
+    void add(const std::shared_ptr<Interceptor>& interceptor) {
+        list_.push_back(interceptor);
+    }
+
+    bool empty() const { return list_.empty(); }
+
+    bool onRequest(CallContext& ctx) const {
+        for (const auto& interceptor : list_) {
+            if (!interceptor->onRequest(ctx)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void onResponse(CallContext& ctx) const {
+        for (auto it = list_.rbegin(); it != list_.rend(); ++it) {
+            (*it)->onResponse(ctx);
+        }
+    }
+
+    bool onCall(CallContext& ctx) const {
+        for (const auto& interceptor : list_) {
+            if (!interceptor->onCall(ctx)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void onReply(CallContext& ctx) const {
+        for (auto it = list_.rbegin(); it != list_.rend(); ++it) {
+            (*it)->onReply(ctx);
+        }
+    }
+
+private:
+    std::vector<std::shared_ptr<Interceptor>> list_;
+};
+
+// a stage of InterceptorChain: static hooks, derive and hide the ones you
+// need. state lives in static members
+struct InterceptorStage {
+    static bool onRequest(CallContext& ctx) { return true; }
+    static void onResponse(CallContext& ctx) {}
+};
+
+/*
+ * Compile-time chain of stages for Server::registerService<DEF, CHAIN>:
+ * the calls are direct and inlinable, InterceptorChain<> is nothing at all.
+ * Same order as InterceptorList, the runtime list runs after the chain.
+ */
+template<typename... STAGES>
+struct InterceptorChain;
+
+template<>
+struct InterceptorChain<> {
+    static bool onRequest(CallContext&) { return true; }
+    static void onResponse(CallContext&) {}
+};
+
+template<typename STAGE, typename... REST>
+struct InterceptorChain<STAGE, REST...> {
+    static bool onRequest(CallContext& ctx) {
+        return STAGE::onRequest(ctx) &&
+            InterceptorChain<REST...>::onRequest(ctx);
+    }
+
+    static void onResponse(CallContext& ctx) {
+        InterceptorChain<REST...>::onResponse(ctx);
+        STAGE::onResponse(ctx);
+    }
+};
+
+} // namespace tinyrpc
+
+#endif // __INTERCEPTOR_H__
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "loop_stats.h"
+#include <stdio.h>
+#include <string.h>
+
+using namespace tinyrpc;
+
+void Log2Histogram::reset() {
+    memset(buckets, 0, sizeof(buckets));
+    count = 0;
+    sum = 0;
+    max = 0;
+}
+
+uint64_t Log2Histogram::percentile(double p) const {
+    if (0 == count) {
+        return 0;
+    }
+
+    uint64_t target = (uint64_t)(count * p);
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < BUCKET_NUM; i++) {
+        acc += buckets[i];
+        if (acc > target) {
+            uint64_t upper = i ? (1ULL << i) - 1 : 0;
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+void Log2Histogram::dump(std::string& out, const char* name,
+                         const char* unit) const {
+    char line[512];
+    int len = snprintf(line, sizeof(line),
+        "%s count:%lu avg:%lu%s p50:%lu p99:%lu p999:%lu max:%lu |",
+        name, (unsigned long)count,
+        (unsigned long)(count ? sum / count : 0), unit,
+        (unsigned long)percentile(0.5), (unsigned long)percentile(0.99),
+        (unsigned long)percentile(0.999), (unsigned long)max);
+
+    // non-empty buckets as "<upper>:<count>"
+    for (uint32_t i = 0; i < BUCKET_NUM && len < (int)sizeof(line); i++) {
+        if (buckets[i] > 0) {
+            len += snprintf(line + len, sizeof(line) - len, " %lu:%lu",
+                (unsigned long)(i ? (1ULL << i) - 1 : 0),
+                (unsigned long)buckets[i]);
+        }
+    }
+    out.append(line);
+    out.append("\n");
+}
+
+void LoopStats::reset(int64_t nowUs) {
+    startUs = nowUs;
+    loops = 0;
+    sleepUs = 0;
+    busyUs = 0;
+    emptyPolls = 0;
+    slowCallbacks = 0;
+
+    eventsPerWakeup.reset();
+    readCallbackUs.reset();
+    writeCallbackUs.reset();
+    timerCallbackUs.reset();
+    timerLateMs.reset();
+}
+
+void LoopStats::dump(std::string& out, int64_t nowUs) const {
+    uint64_t total = sleepUs + busyUs;
+    char line[256];
+    snprintf(line, sizeof(line),
+        "elapsed_us %ld\nloops %lu\nsleep_us %lu\nbusy_us %lu\n"
+        "busy_percent %.1f\nempty_polls %lu\nslow_callbacks %lu\n",
+        (long)(nowUs - startUs), (unsigned long)loops,
+        (unsigned long)sleepUs, (unsigned long)busyUs,
+        total ? busyUs * 100.0 / total : 0.0,
+        (unsigned long)emptyPolls, (unsigned long)slowCallbacks);
+    out.append(line);
+
+    eventsPerWakeup.dump(out, "events_per_wakeup", "");
+    readCallbackUs.dump(out, "read_callback_us", "us");
+    writeCallbackUs.dump(out, "write_callback_us", "us");
+    timerCallbackUs.dump(out, "timer_callback_us", "us");
+    timerLateMs.dump(out, "timer_late_ms", "ms");
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __LOOP_STATS_H__
+#define __LOOP_STATS_H__
+
+#include <stdint.h>
+#include <string>
+
+namespace tinyrpc {
+
+// log2 histogram, bucket i counts values in [2^(i-1), 2^i), bucket 0 is 0
+struct Log2Histogram {
+    enum {
+        BUCKET_NUM = 32,
+    };
+
+    uint64_t buckets[BUCKET_NUM];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+
+    Log2Histogram() { reset(); }
+
+    void reset();
+
+    void add(uint64_t v) {
+        uint32_t i = v ? 64 - __builtin_clzll(v) : 0;
+        buckets[i < BUCKET_NUM ? i : BUCKET_NUM - 1]++;
+        count++;
+        sum += v;
+        max = v > max ? v : max;
+    }
+
+    // upper bound of the bucket holding percentile p(0~1)
+    uint64_t percentile(double p) const;
+
+    void dump(std::string& out, const char* name, const char* unit) const;
+};
+
+/*
+ * Counters of one Poller's loop, only touched by the loop thread.
+ * sleep: time in epoll_wait; busy: the rest of the loop (callbacks, timers).
+ */
+struct LoopStats {
+    int64_t startUs;            // monotonic, since enable/reset
+    uint64_t loops;
+    uint64_t sleepUs;
+    uint64_t busyUs;
+    uint64_t emptyPolls;        // woken up without event(timeout, busy poll)
+    uint64_t slowCallbacks;
+
+    Log2Histogram eventsPerWakeup;
+    Log2Histogram readCallbackUs;
+    Log2Histogram writeCallbackUs;
+    Log2Histogram timerCallbackUs;
+    Log2Histogram timerLateMs;  // fired - expiration
+
+    LoopStats() { reset(0); }
+
+    void reset(int64_t nowUs);
+
+    // text report, one "key value" or histogram per line
+    void dump(std::string& out, int64_t nowUs) const;
+};
+
+} // namespace tinyrpc
+
+#endif // __LOOP_STATS_H__
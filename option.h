@@ -6,7 +6,10 @@
 #define __OPTION_H__
 
 #include <stdint.h>
+#include <time.h>
 #include <functional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -18,12 +21,249 @@ struct ServiceAddrOption {
     bool isIPv6_;
 };
     
+// where workers run, see CommonOption
+enum CpuAffinity {
+    CPU_AFFINITY_NONE = 0,  // float, left to the scheduler
+    CPU_AFFINITY_AUTO,      // worker N on the N-th allowed cpu
+    CPU_AFFINITY_LIST,      // worker N on cpuList_[N % size]
+};
+
+// an aggregate: CommonOption{workerNum, idleTimeout, maxConnNum} still works
 struct CommonOption {
-    uint32_t workerNum_;
-    time_t idleTimeout_; // seconds
-    uint32_t maxConnNum_;
+    uint32_t workerNum_ = 1;
+    time_t idleTimeout_ = 60; // seconds
+    uint32_t maxConnNum_ = 1024;
+    // AcceptOption::cpuSteering_ pins worker N on cpu N whatever it is
+    CpuAffinity cpuAffinity_ = CPU_AFFINITY_NONE;
+    std::vector<int> cpuList_;
+    // memory of a pinned worker comes from the numa node of its cpu only,
+    // conns and buffers are allocated after fork so they are node local
+    bool numaBind_ = false;
 };
     
+// thread pool for callbacks registered with CALLBACK_MODE_POOL,
+// started only if there is such a callback
+struct HandlerPoolOption {
+    uint32_t threadNum_;
+    uint32_t statsIntervalMs_; // log per-uri pool stats, 0: off
+
+    HandlerPoolOption()
+        : threadNum_(4)
+        , statsIntervalMs_(60000) {}
+};
+
+// low latency: the worker loop spins on epoll_wait(0) instead of sleeping,
+// burns a core per worker while there is traffic
+struct BusyPollOption {
+    bool enable_;
+    uint32_t spinIdleUs_;     // back off to blocking wait after idle so long
+    int sockBusyPollUs_;      // SO_BUSY_POLL on accepted sockets, 0: off
+    bool preferBusyPoll_;     // SO_PREFER_BUSY_POLL, with sockBusyPollUs_
+
+    BusyPollOption()
+        : enable_(false)
+        , spinIdleUs_(200000)
+        , sockBusyPollUs_(0)
+        , preferBusyPoll_(false) {}
+};
+
+// worker loop instrumentation, see LoopStats
+struct LoopStatsOption {
+    bool enable_;
+    uint32_t slowCallbackUs_;   // log callbacks slower than it, 0: off
+    uint32_t dumpIntervalMs_;   // write stats to file, 0: off
+    std::string dumpPath_;      // file is <dumpPath_>.<workerIndex>
+
+    LoopStatsOption()
+        : enable_(false)
+        , slowCallbackUs_(10000)
+        , dumpIntervalMs_(10000)
+        , dumpPath_("/tmp/tinyrpc_loop_stats") {}
+};
+
+// per worker conns, qps, bytes/s, inflight and loop busy percent, read by
+// the watcher from WorkerLoadTable(shared memory) and written to dumpPath_
+// every dumpIntervalMs_. workers turn on the loop clock, see
+// Poller::enableClock
+struct WorkerStatsOption {
+    bool enable_;
+    uint32_t dumpIntervalMs_;
+    std::string dumpPath_;
+
+    WorkerStatsOption()
+        : enable_(false)
+        , dumpIntervalMs_(10000)
+        , dumpPath_("/tmp/tinyrpc_worker_stats") {}
+};
+
+// how workers share the listening address
+enum AcceptStrategy {
+    // listenfd per worker with SO_REUSEPORT, the kernel picks the worker
+    ACCEPT_STRATEGY_REUSEPORT = 0,
+    // one listenfd created before fork, EPOLLEXCLUSIVE wakes up one worker
+    ACCEPT_STRATEGY_EXCLUSIVE,
+    // one listenfd created before fork, only the holder of a SysV semaphore
+    // accept lock(SEM_UNDO) watches it
+    ACCEPT_STRATEGY_SEMLOCK,
+    // the watcher accepts and passes the fd(SCM_RIGHTS) to the worker with
+    // least conns(then least inflight requests), see WorkerLoadTable
+    ACCEPT_STRATEGY_WATCHER,
+};
+
+struct AcceptOption {
+    AcceptStrategy strategy_;
+    uint32_t lockRetryMs_;  // SEMLOCK: poll timeout while not holding lock
+    // REUSEPORT: worker N is pinned to cpu N, a CBPF program picks the
+    // listenfd of the worker on the cpu that received the SYN, see
+    // Socket::attachReuseportCpuBpf
+    bool cpuSteering_;
+    uint32_t steeringStatsMs_;  // log rx cpu != worker cpu conns, 0: off
+    // throttle: a worker stops accepting when its conns reach pausePct_ of
+    // maxConnNum_ and resumes below resumePct_, new conns wait in the
+    // backlog or go to other workers instead of being accepted and closed
+    uint32_t pausePct_;
+    uint32_t resumePct_;
+    int backlog_;           // listen(), capped by net.core.somaxconn
+    uint32_t acceptBatch_;  // max accepts per readiness event
+    int deferAcceptSec_;    // TCP_DEFER_ACCEPT, 0: off
+
+    AcceptOption()
+        : strategy_(ACCEPT_STRATEGY_REUSEPORT)
+        , lockRetryMs_(5)
+        , cpuSteering_(false)
+        , steeringStatsMs_(60000)
+        , pausePct_(90)
+        , resumePct_(80)
+        , backlog_(511)
+        , acceptBatch_(64)
+        , deferAcceptSec_(0) {}
+};
+
+// zero-downtime restart: a new server process takes over the listenfd of
+// the running one(same path), which then drains and exits, see HotRestart.
+// both must use the same AcceptStrategy; with REUSEPORT no fd is passed,
+// the new listenfds join the reuseport group
+struct HotRestartOption {
+    bool enable_;
+    std::string path_;          // unix socket, "": /tmp/tinyrpc_hot_restart.<port>
+    time_t drainIdleSec_;       // a draining worker closes conns idle so long
+    time_t drainTimeoutSec_;    // then closes the rest and exits
+
+    HotRestartOption()
+        : enable_(false)
+        , drainIdleSec_(1)
+        , drainTimeoutSec_(30) {}
+};
+
+// rebalance long-lived conns: every intervalMs_ the watcher compares the
+// request rate of the workers, when the busiest is ahead of the idlest by
+// more than imbalancePct_ of the average(and minReqNum_) it moves conns
+// that are idle at the moment(no buffered data, nothing inflight) carrying
+// up to half of the gap, fd over the pipes with SCM_RIGHTS
+struct MigrateOption {
+    bool enable_;
+    uint32_t intervalMs_;
+    uint32_t imbalancePct_;
+    uint32_t minReqNum_;        // gap per interval below which nothing moves
+    uint32_t maxConnNum_;       // conns moved per interval at most
+
+    MigrateOption()
+        : enable_(false)
+        , intervalMs_(1000)
+        , imbalancePct_(50)
+        , minReqNum_(100)
+        , maxConnNum_(8) {}
+};
+
+// worker count follows the load: every intervalMs_ the watcher averages
+// the loop busy percent of the workers(Poller::enableClock). a worker is
+// forked after upRounds_ rounds in a row >= upBusyPct_, the last one is
+// retired after downRounds_ rounds <= downBusyPct_ if the rest would stay
+// below upBusyPct_. a retired worker stops accepting and drains like on
+// hot restart(HotRestartOption::drainIdleSec_, drainTimeoutSec_).
+// CommonOption::workerNum_ is the initial count. not with cpuSteering_
+struct ScaleOption {
+    bool enable_;
+    uint32_t minWorkerNum_;
+    uint32_t maxWorkerNum_;     // <= Server::PROCESS_MAXNUM
+    uint32_t intervalMs_;
+    uint32_t upBusyPct_;
+    uint32_t downBusyPct_;
+    uint32_t upRounds_;
+    uint32_t downRounds_;
+
+    ScaleOption()
+        : enable_(false)
+        , minWorkerNum_(1)
+        , maxWorkerNum_(8)
+        , intervalMs_(1000)
+        , upBusyPct_(75)
+        , downBusyPct_(25)
+        , upRounds_(3)
+        , downRounds_(30) {}
+};
+
+// CoDel admission(see codel.h): once every request read in intervalMs_
+// waited more than targetUs_ since it arrived on the socket, the worker
+// answers new ones with PROTOCOL_URI_CONGESTED until one waits less.
+// arrival is the kernel receive time(SO_TIMESTAMP, tcp since Linux 4.13),
+// on unix sockets the time tcpRecv read it
+struct AdmissionOption {
+    bool enable_;
+    uint32_t targetUs_;
+    uint32_t intervalMs_;
+
+    AdmissionOption()
+        : enable_(false)
+        , targetUs_(5000)
+        , intervalMs_(100) {}
+};
+
+// token bucket: rate_ requests per second, up to burst_ at once
+struct RateLimit {
+    uint32_t rate_;     // 0: not limited
+    uint32_t burst_;
+
+    RateLimit(uint32_t rate = 0, uint32_t burst = 1)
+        : rate_(rate)
+        , burst_(burst) {}
+};
+
+// token buckets shared by all workers(see rate_limit.h), checked before a
+// request is parsed: one per remote ip, one per uri of uris_. a request
+// over either is answered with PROTOCOL_URI_RATE_LIMITED. up to maxIpNum_
+// ips are tracked at once, more are not limited until one goes idle
+struct RateLimitOption {
+    bool enable_;
+    RateLimit ip_;
+    uint32_t maxIpNum_;
+    std::unordered_map<uint32_t, RateLimit> uris_;
+
+    RateLimitOption()
+        : enable_(false)
+        , maxIpNum_(16384) {}
+};
+
+// key/value cache in shared memory for all workers(see shm_cache.h), for
+// handlers(Server::getShmCache) and UriCache::isShared_. memBytes_ is
+// split into shardNum_ shards of a lock each, a shard into slabBytes_
+// pages that are handed to the size classes of items as they need them.
+// a shard takes its table and at least one page
+struct ShmCacheOption {
+    bool enable_;
+    uint64_t memBytes_;
+    uint32_t shardNum_;
+    uint32_t slabBytes_;
+    uint32_t maxItemBytes_;     // key + value + 56, <= slabBytes_
+
+    ShmCacheOption()
+        : enable_(false)
+        , memBytes_(64 << 20)
+        , shardNum_(16)
+        , slabBytes_(1 << 20)
+        , maxItemBytes_(256 << 10) {}
+};
+
 class Server;
 class ServerOptions;
 typedef std::function<bool (ServerOptions*)> option;
@@ -46,6 +286,60 @@ public:
         commonOption_ = opt;
         return true;
     }
+    bool setHandlerPoolOption(const HandlerPoolOption& opt) {
+        handlerPoolOption_ = opt;
+        return true;
+    }
+
+    bool setBusyPollOption(const BusyPollOption& opt) {
+        busyPollOption_ = opt;
+        return true;
+    }
+
+    bool setLoopStatsOption(const LoopStatsOption& opt) {
+        loopStatsOption_ = opt;
+        return true;
+    }
+
+    bool setWorkerStatsOption(const WorkerStatsOption& opt) {
+        workerStatsOption_ = opt;
+        return true;
+    }
+
+    bool setAcceptOption(const AcceptOption& opt) {
+        acceptOption_ = opt;
+        return true;
+    }
+
+    bool setHotRestartOption(const HotRestartOption& opt) {
+        hotRestartOption_ = opt;
+        return true;
+    }
+
+    bool setMigrateOption(const MigrateOption& opt) {
+        migrateOption_ = opt;
+        return true;
+    }
+
+    bool setScaleOption(const ScaleOption& opt) {
+        scaleOption_ = opt;
+        return true;
+    }
+
+    bool setAdmissionOption(const AdmissionOption& opt) {
+        admissionOption_ = opt;
+        return true;
+    }
+
+    bool setRateLimitOption(const RateLimitOption& opt) {
+        rateLimitOption_ = opt;
+        return true;
+    }
+
+    bool setShmCacheOption(const ShmCacheOption& opt) {
+        shmCacheOption_ = opt;
+        return true;
+    }
 
     static option createServiceAddrOption(const ServiceAddrOption& a) {
         option opt = [a] (ServerOptions* opts) -> bool {
@@ -61,11 +355,99 @@ public:
         return opt;
     }
 
+    static option createHandlerPoolOption(const HandlerPoolOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setHandlerPoolOption(a);
+        };
+        return opt;
+    }
+
+    static option createBusyPollOption(const BusyPollOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setBusyPollOption(a);
+        };
+        return opt;
+    }
+
+    static option createLoopStatsOption(const LoopStatsOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setLoopStatsOption(a);
+        };
+        return opt;
+    }
+
+    static option createWorkerStatsOption(const WorkerStatsOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setWorkerStatsOption(a);
+        };
+        return opt;
+    }
+
+    static option createAcceptOption(const AcceptOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setAcceptOption(a);
+        };
+        return opt;
+    }
+
+    static option createHotRestartOption(const HotRestartOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setHotRestartOption(a);
+        };
+        return opt;
+    }
+
+    static option createMigrateOption(const MigrateOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setMigrateOption(a);
+        };
+        return opt;
+    }
+
+    static option createScaleOption(const ScaleOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setScaleOption(a);
+        };
+        return opt;
+    }
+
+    static option createAdmissionOption(const AdmissionOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setAdmissionOption(a);
+        };
+        return opt;
+    }
+
+    static option createRateLimitOption(const RateLimitOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setRateLimitOption(a);
+        };
+        return opt;
+    }
+
+    static option createShmCacheOption(const ShmCacheOption& a) {
+        option opt = [a] (ServerOptions* opts) -> bool {
+            return opts->setShmCacheOption(a);
+        };
+        return opt;
+    }
+
     friend class Server;
 
 private:
     ServiceAddrOption serviceAddrOption_;
     CommonOption commonOption_;
+    HandlerPoolOption handlerPoolOption_;
+    BusyPollOption busyPollOption_;
+    LoopStatsOption loopStatsOption_;
+    WorkerStatsOption workerStatsOption_;
+    AcceptOption acceptOption_;
+    HotRestartOption hotRestartOption_;
+    MigrateOption migrateOption_;
+    ScaleOption scaleOption_;
+    AdmissionOption admissionOption_;
+    RateLimitOption rateLimitOption_;
+    ShmCacheOption shmCacheOption_;
 };
     
 struct ClientOptions {
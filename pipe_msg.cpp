@@ -0,0 +1,97 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "pipe_msg.h"
+#include "log.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace tinyrpc;
+
+bool PipeChannel::send(int sockfd, const PipeMsg& msg, int passFd) {
+    struct iovec iov;
+    iov.iov_base = const_cast<PipeMsg*>(&msg);
+    iov.iov_len = sizeof(msg);
+
+    struct msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+
+    char control[CMSG_SPACE(sizeof(int))];
+    if (passFd >= 0) {
+        memset(control, 0, sizeof(control));
+        mh.msg_control = control;
+        mh.msg_controllen = sizeof(control);
+
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&mh);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &passFd, sizeof(int));
+    }
+
+    while (sendmsg(sockfd, &mh, MSG_NOSIGNAL) < 0) {
+        if (EINTR == errno) {
+            continue;
+        }
+        if (EAGAIN != errno) {
+            LOG(Error, "sendmsg failed, fd:%d,type:%u,err:%s", sockfd,
+                msg.type, strerror(errno));
+        }
+        return false;
+    }
+    return true;
+}
+
+int PipeChannel::recv(int sockfd, PipeMsg& msg, int& passFd) {
+    passFd = -1;
+
+    struct iovec iov;
+    iov.iov_base = &msg;
+    iov.iov_len = sizeof(msg);
+
+    char control[CMSG_SPACE(sizeof(int))];
+    struct msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = control;
+    mh.msg_controllen = sizeof(control);
+
+    ssize_t n = 0;
+    while ((n = recvmsg(sockfd, &mh, MSG_CMSG_CLOEXEC)) < 0) {
+        if (EINTR == errno) {
+            continue;
+        }
+        if (EAGAIN == errno) {
+            return 0;
+        }
+        LOG(Error, "recvmsg failed, fd:%d,err:%s", sockfd, strerror(errno));
+        return -1;
+    }
+    if (0 == n) {
+        return -1;
+    }
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&mh); cmsg;
+         cmsg = CMSG_NXTHDR(&mh, cmsg)) {
+        if (SOL_SOCKET == cmsg->cmsg_level && SCM_RIGHTS == cmsg->cmsg_type) {
+            memcpy(&passFd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+
+    if ((size_t)n != sizeof(msg) || (mh.msg_flags & MSG_CTRUNC)) {
+        LOG(Error, "bad pipe msg, fd:%d,len:%zd,flags:0x%x", sockfd, n,
+            mh.msg_flags);
+        if (passFd >= 0) {
+            close(passFd);
+            passFd = -1;
+        }
+        // dropped, the channel is still usable
+        msg.type = PIPE_MSG_NONE;
+    }
+    return 1;
+}
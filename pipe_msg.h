@@ -0,0 +1,56 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __PIPE_MSG_H__
+#define __PIPE_MSG_H__
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+namespace tinyrpc {
+
+enum PipeMsgType {
+    PIPE_MSG_NONE = 0,
+    PIPE_MSG_NEW_CONN,      // watcher -> worker, with the accepted fd
+    PIPE_MSG_DRAIN,         // watcher -> worker, stop accepting and exit
+                            // once the conns are closed, see HotRestart
+    PIPE_MSG_TAKEOVER_REQ,  // hot restart, see HotRestart
+    PIPE_MSG_LISTEN_FD,
+    PIPE_MSG_TAKEOVER_DONE,
+    PIPE_MSG_MIGRATE_REQ,   // watcher -> hot worker, move idle conns
+    PIPE_MSG_MIGRATE_CONN,  // worker -> watcher, with the conn's fd, then
+                            // watcher -> target as PIPE_MSG_NEW_CONN
+};
+
+// message between watcher and worker over Process::pipefd(SOCK_SEQPACKET),
+// one message per send, an fd may ride along(SCM_RIGHTS)
+struct PipeMsg {
+    uint32_t type;
+    uint32_t addrLen;
+    // PIPE_MSG_MIGRATE_*: target worker index
+    int32_t worker;
+    // PIPE_MSG_MIGRATE_REQ: requests per MigrateOption::intervalMs_ to move
+    // at most, PIPE_MSG_MIGRATE_CONN: those of the conn
+    uint32_t reqNum;
+    // PIPE_MSG_NEW_CONN, PIPE_MSG_MIGRATE_CONN: peer address,
+    // PIPE_MSG_LISTEN_FD: local address
+    struct sockaddr_storage addr;
+
+    PipeMsg()
+        : type(PIPE_MSG_NONE), addrLen(0), worker(-1), reqNum(0), addr() {}
+};
+
+class PipeChannel {
+public:
+    // passFd < 0: no fd. never raises SIGPIPE
+    static bool send(int sockfd, const PipeMsg& msg, int passFd = -1);
+
+    // >0: got msg, passFd is -1 or the received fd(O_CLOEXEC)
+    // 0: nothing to read(EAGAIN), <0: peer closed or error
+    static int recv(int sockfd, PipeMsg& msg, int& passFd);
+};
+
+} // namespace tinyrpc
+
+#endif // __PIPE_MSG_H__
@@ -0,0 +1,232 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// protoc-gen-tinyrpc: emits <name>.tinyrpc.h with a tinyrpc::ServiceDef per
+// `service` block of <name>.proto, see dispatcher_base/service.h.
+//
+//   protoc --plugin=protoc-gen-tinyrpc=./protoc-gen-tinyrpc
+//          --tinyrpc_out=./proto_pb echo.proto
+//
+//   service EchoService { rpc Echo(EchoReq) returns (EchoRsp); }
+// gives
+//   template<typename IMPL>
+//   using EchoServiceDef = ::tinyrpc::ServiceDef<IMPL,
+//       ::tinyrpc::Method<IMPL, ::echo_proto::EchoReq,
+//           ::echo_proto::EchoRsp, &IMPL::Echo>>;
+//
+// only libprotobuf is needed: the CodeGeneratorRequest/Response envelopes
+// (google/protobuf/compiler/plugin.proto) are read and written by hand, the
+// files they carry are FileDescriptorProto.
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <ctype.h>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace google::protobuf;
+using google::protobuf::internal::WireFormatLite;
+
+// field numbers of plugin.proto
+enum {
+    REQ_FILE_TO_GENERATE = 1,
+    REQ_PROTO_FILE = 15,
+    RSP_ERROR = 1,
+    RSP_SUPPORTED_FEATURES = 2,
+    RSP_FILE = 15,
+    RSP_FILE_NAME = 1,
+    RSP_FILE_CONTENT = 15,
+    FEATURE_PROTO3_OPTIONAL = 1,
+};
+
+struct Request {
+    std::vector<std::string> fileToGenerate;
+    std::vector<FileDescriptorProto> protoFiles;
+};
+
+struct OutFile {
+    std::string name;
+    std::string content;
+};
+
+static bool parseRequest(const std::string& data, Request& req) {
+    io::CodedInputStream input((const uint8_t*)data.data(), data.size());
+    input.SetTotalBytesLimit(INT32_MAX);
+    while (uint32_t tag = input.ReadTag()) {
+        int field = WireFormatLite::GetTagFieldNumber(tag);
+        if (field == REQ_FILE_TO_GENERATE) {
+            std::string name;
+            if (!WireFormatLite::ReadString(&input, &name)) {
+                return false;
+            }
+            req.fileToGenerate.push_back(name);
+        } else if (field == REQ_PROTO_FILE) {
+            std::string bytes;
+            req.protoFiles.emplace_back();
+            if (!WireFormatLite::ReadBytes(&input, &bytes) ||
+                !req.protoFiles.back().ParseFromString(bytes)) {
+                return false;
+            }
+        } else if (!WireFormatLite::SkipField(&input, tag)) {
+            return false;
+        }
+    }
+    return input.ConsumedEntireMessage();
+}
+
+static std::string serializeResponse(const std::string& error,
+                                     const std::vector<OutFile>& files) {
+    std::string out;
+    {
+        io::StringOutputStream stream(&out);
+        io::CodedOutputStream output(&stream);
+        if (!error.empty()) {
+            WireFormatLite::WriteString(RSP_ERROR, error, &output);
+        }
+        WireFormatLite::WriteUInt64(RSP_SUPPORTED_FEATURES,
+            FEATURE_PROTO3_OPTIONAL, &output);
+        for (const OutFile& file : files) {
+            std::string bytes;
+            {
+                io::StringOutputStream fileStream(&bytes);
+                io::CodedOutputStream fileOutput(&fileStream);
+                WireFormatLite::WriteString(RSP_FILE_NAME, file.name,
+                    &fileOutput);
+                WireFormatLite::WriteString(RSP_FILE_CONTENT, file.content,
+                    &fileOutput);
+            }
+            WireFormatLite::WriteBytes(RSP_FILE, bytes, &output);
+        }
+    }
+    return out;
+}
+
+// "a.b.Msg" -> "::a::b::Msg"
+static std::string cppName(const std::string& fullName) {
+    std::string name = "::";
+    for (char c : fullName) {
+        if (c == '.') {
+            name += "::";
+        } else {
+            name += c;
+        }
+    }
+    return name;
+}
+
+static std::string stripProto(const std::string& fileName) {
+    size_t pos = fileName.rfind(".proto");
+    return pos == std::string::npos ? fileName : fileName.substr(0, pos);
+}
+
+static std::string headerGuard(const std::string& fileName) {
+    std::string guard = "__";
+    for (char c : stripProto(fileName) + "_tinyrpc_h") {
+        guard += isalnum((unsigned char)c) ? (char)toupper(c) : '_';
+    }
+    return guard + "__";
+}
+
+static std::string generate(const FileDescriptor* file) {
+    std::string base = stripProto(file->name());
+    size_t slash = base.rfind('/');
+    std::string pbHeader = (slash == std::string::npos ? base
+        : base.substr(slash + 1)) + ".pb.h";
+    std::string guard = headerGuard(file->name());
+
+    std::string out;
+    out += "// Generated by protoc-gen-tinyrpc from " + file->name() +
+        ". DO NOT EDIT!\n\n";
+    out += "#ifndef " + guard + "\n#define " + guard + "\n\n";
+    out += "#include \"dispatcher_base/service.h\"\n";
+    out += "#include \"" + pbHeader + "\"\n\n";
+
+    std::vector<std::string> namespaces;
+    std::string package = file->package();
+    size_t begin = 0;
+    while (!package.empty() && begin <= package.size()) {
+        size_t end = package.find('.', begin);
+        if (end == std::string::npos) {
+            end = package.size();
+        }
+        namespaces.push_back(package.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    for (const std::string& ns : namespaces) {
+        out += "namespace " + ns + " {\n";
+    }
+    if (!namespaces.empty()) {
+        out += "\n";
+    }
+
+    for (int i = 0; i < file->service_count(); i++) {
+        const ServiceDescriptor* service = file->service(i);
+        out += "// IMPL implements, called inline on the worker loop:\n";
+        for (int j = 0; j < service->method_count(); j++) {
+            const MethodDescriptor* method = service->method(j);
+            out += "//   void " + method->name() + "(const " +
+                cppName(method->input_type()->full_name()) + "& req, " +
+                cppName(method->output_type()->full_name()) +
+                "& rsp);\n";
+        }
+        out += "// srv.registerService<" + service->name() +
+            "Def<IMPL>>(&impl);\n";
+        out += "template<typename IMPL>\n";
+        out += "using " + service->name() + "Def = ::tinyrpc::ServiceDef<IMPL";
+        for (int j = 0; j < service->method_count(); j++) {
+            const MethodDescriptor* method = service->method(j);
+            out += ",\n    ::tinyrpc::Method<IMPL, " +
+                cppName(method->input_type()->full_name()) + ",\n        " +
+                cppName(method->output_type()->full_name()) + ", &IMPL::" +
+                method->name() + ">";
+        }
+        out += ">;\n\n";
+    }
+
+    for (auto it = namespaces.rbegin(); it != namespaces.rend(); ++it) {
+        out += "} // namespace " + *it + "\n";
+    }
+    out += "\n#endif // " + guard + "\n";
+    return out;
+}
+
+int main(int argc, char *argv[]) {
+    std::cin >> std::noskipws;
+    std::string data((std::istreambuf_iterator<char>(std::cin)),
+                     std::istreambuf_iterator<char>());
+
+    Request req;
+    std::string error;
+    std::vector<OutFile> files;
+    DescriptorPool pool;
+    if (!parseRequest(data, req)) {
+        error = "protoc-gen-tinyrpc: bad CodeGeneratorRequest";
+    }
+
+    // dependencies come first in proto_file
+    for (size_t i = 0; error.empty() && i < req.protoFiles.size(); i++) {
+        if (!pool.BuildFile(req.protoFiles[i])) {
+            error = "protoc-gen-tinyrpc: can not build " +
+                req.protoFiles[i].name();
+        }
+    }
+
+    for (size_t i = 0; error.empty() && i < req.fileToGenerate.size(); i++) {
+        const FileDescriptor* file = pool.FindFileByName(req.fileToGenerate[i]);
+        if (!file) {
+            error = "protoc-gen-tinyrpc: no " + req.fileToGenerate[i];
+        } else if (file->service_count() > 0) {
+            files.push_back({stripProto(file->name()) + ".tinyrpc.h",
+                generate(file)});
+        }
+    }
+
+    std::cout << serializeResponse(error, files);
+    return 0;
+}
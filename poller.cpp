@@ -11,6 +11,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include "poller.h"
 #include "log.h"
@@ -19,12 +20,26 @@
 
 using namespace tinyrpc;
 
+// epoll_event.data of a registration
+static inline uint64_t makeEventData(int fd, uint32_t gen) {
+    return (uint64_t)gen << 32 | (uint32_t)fd;
+}
+
 Poller::Poller(uint32_t eventDataListSize) 
     : epollfd_(-1)
     , timeout_(10)
     , isRunning_(false)
     , activeEventNum_(0)
-    , eventDataListSize_(eventDataListSize) {
+    , spinIdleUs_(0)
+    , lastActiveUs_(0)
+    , isSpinning_(false)
+    , clockBeginUs_(0)
+    , wakeUs_(0)
+    , sleepUs_(0)
+    , stats_(nullptr)
+    , slowCallbackUs_(0)
+    , eventDataListSize_(eventDataListSize)
+    , timerSeq_(0) {
     eventDataList_.resize(eventDataListSize_);
     epollResultList_.resize(eventDataListSize_);
 
@@ -38,6 +53,31 @@ Poller::Poller(uint32_t eventDataListSize)
 Poller::~Poller() {
     close(epollfd_);
     epollfd_ = -1; 
+
+    delete stats_;
+    stats_ = nullptr;
+}
+
+void Poller::enableStats(uint32_t slowCallbackUs,
+                         const SlowCallbackReporter& reporter) {
+    if (!stats_) {
+        stats_ = new LoopStats();
+    }
+    stats_->reset(getMonotonicMicros());
+    slowCallbackUs_ = slowCallbackUs;
+    slowCallbackReporter_ = reporter;
+}
+
+void Poller::enableClock() {
+    clockBeginUs_ = getMonotonicMicros();
+    wakeUs_ = clockBeginUs_;
+    sleepUs_ = 0;
+}
+
+void Poller::resetStats() {
+    if (stats_) {
+        stats_->reset(getMonotonicMicros());
+    }
 }
 
 void Poller::setFdReadCallback(int fd, const EventCallback& cb, void* arg) {
@@ -54,10 +94,20 @@ void Poller::setFdWriteCallback(int fd, const EventCallback& cb, void* arg) {
 
 bool Poller::addFd(int fd, int events) {
     assert(fd <= (int)eventDataListSize_);
+    // fd registered with callbacks is handled by its EventItem
+    return addHandler(fd, &eventDataList_[fd], events);
+}
+
+bool Poller::addHandler(int fd, EventHandler* handler, int events) {
+    assert(fd <= (int)eventDataListSize_);
+    assert(handler);
+
+    EventItem& item = eventDataList_[fd];
+    const uint32_t gen = item.gen + 1;
 
     struct epoll_event ee;
     memset(&ee, 0, sizeof(ee));
-    ee.data.ptr = &(eventDataList_[fd]);
+    ee.data.u64 = makeEventData(fd, gen);
 
     if (events & EV_READ)
         ee.events |= EPOLLIN;
@@ -72,8 +122,10 @@ bool Poller::addFd(int fd, int events) {
         return false;
     }
 
-    eventDataList_[fd].fd = fd;
-    eventDataList_[fd].events |= events;
+    item.gen = gen;
+    item.handler = handler;
+    item.fd = fd;
+    item.events |= events;
     ++activeEventNum_;
 
     return true;
@@ -83,8 +135,7 @@ bool Poller::delFd(int fd) {
     assert(fd <= (int)eventDataListSize_);
 
     struct epoll_event ee;
-    ee.events = 0;
-    ee.data.ptr = &(eventDataList_[fd]);
+    memset(&ee, 0, sizeof(ee));
 
     int ret = epoll_ctl(epollfd_, EPOLL_CTL_DEL, fd, &ee);
     if (ret < 0) {
@@ -93,40 +144,21 @@ bool Poller::delFd(int fd) {
     }
 
     eventDataList_[fd].events = 0;
+    // events of fd already fired in this loop are skipped
+    eventDataList_[fd].handler = nullptr;
+    eventDataList_[fd].gen++;
     --activeEventNum_;
 
     return true;
 }
 
-bool Poller::alterEvent(int fd, int events) {
-    assert(fd <= (int)eventDataListSize_);
-
-    int newEvent = 0;
-    if (events & EV_READ)
-        newEvent |= EPOLLIN;
-    if (events & EV_WRITE)
-        newEvent |= EPOLLOUT;
+// EPOLL_CTL_MOD replaces the whole mask
+bool Poller::updateEvents(int fd, int events, const char* op) {
+    EventItem& item = eventDataList_[fd];
 
     struct epoll_event ee;
-    ee.data.ptr = &(eventDataList_[fd]);
-    ee.events = newEvent;
-
-    int ret = epoll_ctl(epollfd_, EPOLL_CTL_MOD, fd, &ee);
-    if (ret < 0) {
-        LOG(Error, "alterEvent failed, err:%s", strerror(errno));
-        return false;
-    }
-
-    eventDataList_[fd].events = newEvent;
-
-    return true;
-}
-
-bool Poller::addEvent(int fd, int events) {
-    assert(fd <= (int)eventDataListSize_);
-
-    struct epoll_event ee;
-    ee.data.ptr = &(eventDataList_[fd]);
+    memset(&ee, 0, sizeof(ee));
+    ee.data.u64 = makeEventData(fd, item.gen);
     
     if (events & EV_READ)
         ee.events |= EPOLLIN;
@@ -135,44 +167,39 @@ bool Poller::addEvent(int fd, int events) {
 
     int ret = epoll_ctl(epollfd_, EPOLL_CTL_MOD, fd, &ee);
     if (ret < 0) {
-        LOG(Error, "alterEvent failed, err:%s", strerror(errno));
+        LOG(Error, "%s failed, err:%s", op, strerror(errno));
         return false;
     }
 
-    eventDataList_[fd].events |= events;
+    item.events = events;
 
     return true;
 }
 
-bool Poller::delEvent(int fd, int events) {
+bool Poller::alterEvent(int fd, int events) {
     assert(fd <= (int)eventDataListSize_);
+    return updateEvents(fd, events & (EV_READ | EV_WRITE), "alterEvent");
+}
 
-    struct epoll_event ee;
-    ee.data.ptr = &(eventDataList_[fd]);
-    
-    if (events & EV_READ)
-        ee.events &= ~EPOLLIN;
-    if (events & EV_WRITE)
-        ee.events &= ~EPOLLOUT;
-
-    int ret = epoll_ctl(epollfd_, EPOLL_CTL_MOD, fd, &ee);
-    if (ret < 0) {
-        LOG(Error, "alterEvent failed, err:%s", strerror(errno));
-        return false;
-    }
-
-    eventDataList_[fd].events &= ~events;
+bool Poller::addEvent(int fd, int events) {
+    assert(fd <= (int)eventDataListSize_);
+    // keep the registered events
+    return updateEvents(fd, eventDataList_[fd].events | events, "addEvent");
+}
 
-    return true;
+bool Poller::delEvent(int fd, int events) {
+    assert(fd <= (int)eventDataListSize_);
+    return updateEvents(fd, eventDataList_[fd].events & ~events, "delEvent");
 }
 
 bool Poller::addTimer(int intervalMs, bool repeat,
-                      const EventCallback& cb, void* arg)
+                      const EventCallback& cb, void* arg, uint64_t* timerId)
 {
     std::lock_guard<std::mutex> lock(timerMutex_);
 
     int64_t now = getCurrentTimeMillis();
     TimerEventItem item;
+    item.id = ++timerSeq_;
     item.expiration = now + intervalMs;
     item.interval = intervalMs;
     item.repeat = repeat;
@@ -180,10 +207,46 @@ bool Poller::addTimer(int intervalMs, bool repeat,
     item.arg = arg;
 
     timerQueue_.push(item);
+    if (timerId) {
+        *timerId = item.id;
+    }
 
     return true;
 }
 
+void Poller::cancelTimer(uint64_t timerId)
+{
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    cancelledTimers_.insert(timerId);
+}
+
+bool Poller::takeCancelled(uint64_t timerId)
+{
+    return !cancelledTimers_.empty() && cancelledTimers_.erase(timerId) > 0;
+}
+
+void Poller::purgeCancelled()
+{
+    // ids of fired timers are forgotten here too
+    std::vector<TimerEventItem> items;
+    items.reserve(timerQueue_.size());
+    while (!timerQueue_.empty()) {
+        if (0 == cancelledTimers_.count(timerQueue_.top().id)) {
+            items.push_back(timerQueue_.top());
+        }
+        timerQueue_.pop();
+    }
+    timerQueue_ = std::priority_queue<TimerEventItem>(
+        std::less<TimerEventItem>(), std::move(items));
+    cancelledTimers_.clear();
+}
+
+void Poller::addLoopHook(LoopHookPoint point, const LoopHook& hook)
+{
+    assert(point < LOOP_HOOK_NUM);
+    loopHooks_[point].push_back(hook);
+}
+
 int64_t Poller::getCurrentTimeMillis() const 
 {
     struct timeval tv;
@@ -191,13 +254,26 @@ int64_t Poller::getCurrentTimeMillis() const
     return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
 }
 
+int64_t Poller::getMonotonicMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 void Poller::runLoop()
 {
     int waitTime = 0;
+    int64_t pollBeginUs = 0;
+    int64_t pollEndUs = 0;
     isRunning_ = true;
     while (isRunning_) {
         fireEventList_.clear();
 
+        for (auto& hook : loopHooks_[LOOP_HOOK_BEFORE_POLL]) {
+            hook();
+        }
+
         // default timeout
         waitTime = timeout_;
         // get the waitTime of the latest timer
@@ -213,11 +289,51 @@ void Poller::runLoop()
             }
         }
 
+        // busy poll: don't sleep while recently active, a blocking
+        // epoll_wait costs a wakeup(schedule + irq) per request
+        if (spinIdleUs_ > 0) {
+            isSpinning_ = getMonotonicMicros() - lastActiveUs_ < spinIdleUs_;
+            if (isSpinning_) {
+                waitTime = 0;
+            }
+        }
+
+        const bool isClockOn = unlikely(stats_) || clockBeginUs_ > 0;
+        if (isClockOn) {
+            pollBeginUs = getMonotonicMicros();
+        }
+
         poll(waitTime, fireEventList_);
 
+        if (spinIdleUs_ > 0 || isClockOn) {
+            pollEndUs = getMonotonicMicros();
+            if (!fireEventList_.empty()) {
+                lastActiveUs_ = pollEndUs;
+            }
+        }
+        if (clockBeginUs_ > 0) {
+            wakeUs_ = pollEndUs;
+            sleepUs_ += pollEndUs - pollBeginUs;
+        }
+
         handleFireEvent(fireEventList_);
 
+        for (auto& hook : loopHooks_[LOOP_HOOK_AFTER_EVENTS]) {
+            hook();
+        }
+
         checkTimers();
+
+        if (unlikely(stats_)) {
+            stats_->loops++;
+            stats_->sleepUs += pollEndUs - pollBeginUs;
+            stats_->busyUs += getMonotonicMicros() - pollEndUs;
+            if (fireEventList_.empty()) {
+                stats_->emptyPolls++;
+            } else {
+                stats_->eventsPerWakeup.add(fireEventList_.size());
+            }
+        }
     }
 }
 
@@ -234,19 +350,22 @@ bool Poller::poll(int timeout, FireEventList& fireEventList)
     }
 
     for (int i = 0; i < retNum; ++i) {
-        EventItem *fireEvent = static_cast<EventItem*>(epollResultList_[i].data.ptr);
+        FiredEvent fired;
+        fired.fd = (int)(epollResultList_[i].data.u64 & 0xffffffff);
+        fired.gen = (uint32_t)(epollResultList_[i].data.u64 >> 32);
+        fired.events = 0;
 
         if (epollResultList_[i].events & (EPOLLIN)) {
-            fireEvent->events |= EV_READ;
+            fired.events |= EV_READ;
         }
         if (epollResultList_[i].events & EPOLLOUT) {
-            fireEvent->events |= EV_WRITE;
+            fired.events |= EV_WRITE;
         }
         if (epollResultList_[i].events & (EPOLLERR | EPOLLHUP)) {
-            fireEvent->events |= EV_READ | EV_WRITE;
+            fired.events |= EV_READ | EV_WRITE;
         }
 
-        fireEventList.push_back(fireEvent);
+        fireEventList.push_back(fired);
     }
 
     return true;
@@ -254,43 +373,118 @@ bool Poller::poll(int timeout, FireEventList& fireEventList)
 
 void Poller::handleFireEvent(const FireEventList& fireEventList)
 {
-    EventItem* ev = nullptr;
     for (size_t i = 0; i < fireEventList.size(); ++i) {
-        ev = fireEventList[i];
+        const int fd = fireEventList[i].fd;
+        const uint32_t gen = fireEventList[i].gen;
+        const int events = fireEventList[i].events;
+        const EventItem& item = eventDataList_[fd];
+
+        // closed(and maybe reused) by a previous callback of this loop
+        if (unlikely(item.gen != gen || !item.handler)) {
+            continue;
+        }
+        EventHandler* handler = item.handler;
+
+        if (events & EV_READ) {
+            if (unlikely(stats_)) {
+                int64_t begin = getMonotonicMicros();
+                handler->handleRead(fd, events);
+                recordCallback(fd, EV_READ, begin, stats_->readCallbackUs);
+            } else {
+                handler->handleRead(fd, events);
+            }
 
-        if (ev->events & EV_READ) {
-            if (ev->readCallback) {
-                ev->readCallback(ev->fd, ev->events, ev->readArg);
+            if (item.gen != gen || !item.handler) {
+                continue;
             }
         }
 
-        if (ev->events & EV_WRITE) {
-            if (ev->writeCallback) {
-                ev->writeCallback(ev->fd, ev->events, ev->writeArg);
+        if (events & EV_WRITE) {
+            if (unlikely(stats_)) {
+                int64_t begin = getMonotonicMicros();
+                handler->handleWrite(fd, events);
+                recordCallback(fd, EV_WRITE, begin, stats_->writeCallbackUs);
+            } else {
+                handler->handleWrite(fd, events);
             }
         }
     }
 }
 
+void Poller::recordCallback(int fd, int events, int64_t beginUs,
+                            Log2Histogram& hist)
+{
+    int64_t cost = getMonotonicMicros() - beginUs;
+
+    hist.add(cost);
+    if (slowCallbackUs_ > 0 && cost >= slowCallbackUs_) {
+        stats_->slowCallbacks++;
+        if (slowCallbackReporter_) {
+            slowCallbackReporter_(fd, events, cost);
+        } else {
+            LOG(Warn, "slow callback, fd:%d,events:%d,costUs:%ld", fd,
+                events, (long)cost);
+        }
+    }
+}
+
 void Poller::checkTimers()
 {
-    std::lock_guard<std::mutex> lock(timerMutex_);
     int64_t now = getCurrentTimeMillis();
 
-    while (!timerQueue_.empty() && timerQueue_.top().expiration <= now) {
-        TimerEventItem item = timerQueue_.top();
-        timerQueue_.pop();
+    // pop expired timers first and run them without timerMutex_ held,
+    // a callback may call addTimer()
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        while (!timerQueue_.empty() && timerQueue_.top().expiration <= now) {
+            if (!takeCancelled(timerQueue_.top().id)) {
+                expiredTimers_.push_back(timerQueue_.top());
+            }
+            timerQueue_.pop();
+        }
+        // timeouts cancelled on reply would stay queued until they expire
+        if (cancelledTimers_.size() > 64 &&
+            cancelledTimers_.size() * 2 > timerQueue_.size()) {
+            purgeCancelled();
+        }
+    }
+
+    if (expiredTimers_.empty()) {
+        return;
+    }
 
+    for (auto& item : expiredTimers_) {
+        // cancelled by a callback before it
+        {
+            std::lock_guard<std::mutex> lock(timerMutex_);
+            if (takeCancelled(item.id)) {
+                item.repeat = false;
+                continue;
+            }
+        }
         if (item.callback) {
             // fd=-1 表示是 timer 事件
-            item.callback(-1, EV_TIMER, item.arg);
+            if (unlikely(stats_)) {
+                stats_->timerLateMs.add(now - item.expiration);
+                int64_t begin = getMonotonicMicros();
+                item.callback(-1, EV_TIMER, item.arg);
+                recordCallback(-1, EV_TIMER, begin, stats_->timerCallbackUs);
+            } else {
+                item.callback(-1, EV_TIMER, item.arg);
+            }
         }
+    }
 
-        if (item.repeat) {
-            item.expiration = now + item.interval;
-            timerQueue_.push(item);
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        for (auto& item : expiredTimers_) {
+            if (item.repeat && !takeCancelled(item.id)) {
+                item.expiration = now + item.interval;
+                timerQueue_.push(item);
+            }
         }
     }
+    expiredTimers_.clear();
 }
 
     /*
@@ -5,11 +5,13 @@
 #ifndef __POLLER_H__
 #define __POLLER_H__
 
+#include "loop_stats.h"
 #include <stdint.h>
 #include <functional>
 #include <vector>
 #include <mutex>
 #include <queue>
+#include <unordered_set>
 
 namespace tinyrpc {
 
@@ -21,19 +23,61 @@ enum EPOLL_EVENT {
 };
 
 using EventCallback = std::function<void (int, int, void*)>;
+// fd, events(EV_READ/EV_WRITE/EV_TIMER), cost of the callback
+using SlowCallbackReporter = std::function<void (int, int, int64_t)>;
+
+/*
+ * Intrusive event handler: an event is dispatched with one virtual call, no
+ * std::function. Register with Poller::addHandler(), delFd() before the
+ * handler is freed. epoll_event.data carries the fd and the generation of
+ * its registration, so an event fired for a registration that was deleted
+ * in the same loop iteration is dropped, even if the fd number(or the
+ * handler's address) is reused by then.
+ */
+class EventHandler {
+public:
+    virtual ~EventHandler() = default;
+
+    // events: fired events of this wakeup, EV_READ | EV_WRITE
+    virtual void handleRead(int fd, int events) = 0;
+    virtual void handleWrite(int fd, int events) = 0;
+};
 
-typedef struct EventItem {
+// per fd slot, also the handler of fds registered with std::function
+// callbacks(setFdReadCallback/setFdWriteCallback + addFd)
+struct EventItem : public EventHandler {
     int fd;
-    int events;
+    int events;                 // registered events
+    EventHandler* handler;      // registered handler, nullptr if not added
+    uint32_t gen;               // bumped on every addHandler and delFd
     EventCallback readCallback;
     EventCallback writeCallback;
     void* readArg;
     void* writeArg;
 
-    EventItem() : fd(-1), events(0), readArg(nullptr), writeArg(nullptr) {}
-} EventItem;
+    EventItem()
+        : fd(-1)
+        , events(0)
+        , handler(nullptr)
+        , gen(0)
+        , readArg(nullptr)
+        , writeArg(nullptr) {}
+
+    void handleRead(int fd, int events) override {
+        if (readCallback) {
+            readCallback(fd, events, readArg);
+        }
+    }
+
+    void handleWrite(int fd, int events) override {
+        if (writeCallback) {
+            writeCallback(fd, events, writeArg);
+        }
+    }
+};
 
 struct TimerEventItem {
+    uint64_t id;        // for cancelTimer
     int64_t expiration; // ms
     int interval;       // ms
     bool repeat;
@@ -46,6 +90,14 @@ struct TimerEventItem {
     }
 };
 
+enum LoopHookPoint {
+    LOOP_HOOK_BEFORE_POLL = 0,  // before epoll_wait
+    LOOP_HOOK_AFTER_EVENTS,     // after fired events, before timers
+    LOOP_HOOK_NUM,
+};
+
+using LoopHook = std::function<void ()>;
+
 class Poller {
 public:
     enum {
@@ -53,7 +105,12 @@ public:
     };
 
     using EventItemList = std::vector<EventItem>;
-    using FireEventList = std::vector<EventItem*>;
+    struct FiredEvent {
+        int fd;
+        uint32_t gen;       // of the registration the event fired for
+        int events;         // fired events
+    };
+    using FireEventList = std::vector<FiredEvent>;
     using EpollResultList = std::vector<struct epoll_event>;
 
     Poller(uint32_t eventDataListSize);
@@ -64,27 +121,80 @@ public:
     void setFdReadCallback(int fd, const EventCallback& cb, void* arg);
     void setFdWriteCallback(int fd, const EventCallback& cb, void* arg);
     bool addFd(int fd, int events);
+    // register fd with an intrusive handler instead of callbacks
+    bool addHandler(int fd, EventHandler* handler, int events);
     bool delFd(int fd);
     bool alterEvent(int fd, int events);
     bool addEvent(int fd, int events);
     bool delEvent(int fd, int events);
-    bool addTimer(int intervalMs, bool repeat, const EventCallback& cb, void* arg);
+    bool hasEvent(int fd, int events) const {
+        return (eventDataList_[fd].events & events) == events;
+    }
+    bool addTimer(int intervalMs, bool repeat, const EventCallback& cb, void* arg,
+                  uint64_t* timerId = nullptr);
+    // the timer is dropped, a no-op if it has fired(and does not repeat)
+    void cancelTimer(uint64_t timerId);
+    // called on every loop iteration, keep it cheap
+    void addLoopHook(LoopHookPoint point, const LoopHook& hook);
     void runLoop();
 
     void stop() { isRunning_ = false; }
     void setTimeout(int timeout) { timeout_ = timeout; }
+
+    // busy poll: keep calling epoll_wait with timeout 0 while events come in,
+    // back off to the blocking wait after idle spinIdleUs. 0: off(default)
+    void setBusyPoll(uint32_t spinIdleUs) { spinIdleUs_ = spinIdleUs; }
+    bool isSpinning() const { return isSpinning_; }
+
+    // loop instrumentation, off by default: then it costs one branch per
+    // callback. callbacks running >= slowCallbackUs go to reporter(or log)
+    void enableStats(uint32_t slowCallbackUs,
+                     const SlowCallbackReporter& reporter = nullptr);
+    // nullptr if not enabled
+    const LoopStats* getStats() const { return stats_; }
+    void resetStats();
+    static int64_t getMonotonicMicros();
+
+    // loop clock, off by default: two clock reads per loop iteration.
+    // wake: monotonic us when the last epoll_wait returned
+    void enableClock();
+    bool isClockOn() const { return clockBeginUs_ > 0; }
+    int64_t getWakeUs() const { return wakeUs_; }
+    // time out of epoll_wait since enableClock(), up to the last wakeup
+    uint64_t getBusyUs() const {
+        return wakeUs_ - clockBeginUs_ - sleepUs_;
+    }
     
 private:
     bool poll(int timeout, FireEventList& fireEventList);
     void handleFireEvent(const FireEventList& fireEventList);
     void checkTimers();
+    // timerMutex_ held: true if timerId was cancelled, and forget it
+    bool takeCancelled(uint64_t timerId);
+    // timerMutex_ held: drop the cancelled timers still queued
+    void purgeCancelled();
     int64_t getCurrentTimeMillis() const;
+    bool updateEvents(int fd, int events, const char* op);
+    void recordCallback(int fd, int events, int64_t beginUs,
+                        Log2Histogram& hist);
 
     int epollfd_;
     int timeout_;
     bool isRunning_;
     uint32_t activeEventNum_;
 
+    uint32_t spinIdleUs_;
+    int64_t lastActiveUs_;  // monotonic, last poll with events
+    bool isSpinning_;
+
+    int64_t clockBeginUs_;  // 0: clock off
+    int64_t wakeUs_;
+    uint64_t sleepUs_;
+
+    LoopStats* stats_;
+    uint32_t slowCallbackUs_;
+    SlowCallbackReporter slowCallbackReporter_;
+
     uint32_t eventDataListSize_;
     EventItemList eventDataList_;
     
@@ -92,9 +202,15 @@ private:
 
     FireEventList fireEventList_;
 
+    std::vector<LoopHook> loopHooks_[LOOP_HOOK_NUM];
+
     // timer: min-heap
     std::mutex timerMutex_;
     std::priority_queue<TimerEventItem> timerQueue_;
+    std::vector<TimerEventItem> expiredTimers_;
+    uint64_t timerSeq_;
+    // ids of cancelled timers, dropped when they come to expire
+    std::unordered_set<uint64_t> cancelledTimers_;
 };
 
 
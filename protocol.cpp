@@ -0,0 +1,76 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "protocol.h"
+#include "responder.h"
+#include "handler_pool.h"
+#include "uri_limit.h"
+#include "codec.h"
+#include "dispatcher_base/callback_base.h"
+
+using namespace tinyrpc;
+
+bool Protocol::dispatchDeferred(
+        const std::shared_ptr<detail::ICallback>& callback,
+        uint32_t protocolType, uint32_t reqUri, uint32_t rspUri,
+        const VoidPtr& req, const VoidPtr& rsp, const char* traceId,
+        Connection* conn) {
+    if (!rspQueue_) {
+        LOG(Error, "no response queue! reqUri:0x%xu", reqUri);
+        return false;
+    }
+
+    if (callback->mode() == CALLBACK_MODE_BATCH) {
+        if (!batchQueue_) {
+            LOG(Error, "no batch queue! reqUri:0x%xu", reqUri);
+            return false;
+        }
+        return batchQueue_->add(this, callback, protocolType, reqUri, rspUri,
+            req, rsp, traceId, conn);
+    }
+
+    UriBulkhead* bulkhead = uriLimiter_ ? uriLimiter_->find(reqUri) : nullptr;
+    if (bulkhead && !uriLimiter_->tryAcquire(bulkhead)) {
+        // no free slot: wait for one, or overloaded
+        std::string trace(traceId, PROTOCOL_TRACEID_SIZE);
+        if (uriLimiter_->wait(bulkhead, conn, [this, callback, protocolType,
+                reqUri, rspUri, req, rsp, trace, bulkhead](Connection* c) {
+                startDeferred(callback, protocolType, reqUri, rspUri, req,
+                    rsp, trace.data(), c, bulkhead);
+            })) {
+            return true;
+        }
+        LOG(Warn, "overloaded! reqUri:0x%xu,fd:%d", reqUri, conn->getFd());
+        return Codec::sendMessage(conn, protocolType, PROTOCOL_URI_OVERLOADED,
+            std::string(), traceId);
+    }
+
+    return startDeferred(callback, protocolType, reqUri, rspUri, req, rsp,
+        traceId, conn, bulkhead);
+}
+
+bool Protocol::startDeferred(
+        const std::shared_ptr<detail::ICallback>& callback,
+        uint32_t protocolType, uint32_t reqUri, uint32_t rspUri,
+        const VoidPtr& req, const VoidPtr& rsp, const char* traceId,
+        Connection* conn, UriBulkhead* bulkhead) {
+    // gives the slot back when done, or dropped on a failure below
+    auto responder = std::make_shared<Responder>(rspQueue_, this,
+        protocolType, reqUri, rspUri, traceId, conn, rsp, bulkhead);
+
+    if (callback->mode() == CALLBACK_MODE_DEFERRED) {
+        callback->onServerRequest(req, rsp, responder);
+        return true;
+    }
+
+    if (!handlerPool_) {
+        LOG(Error, "no handler pool! reqUri:0x%xu", reqUri);
+        return false;
+    }
+
+    return handlerPool_->submit(reqUri, [callback, req, rsp, responder]() {
+        callback->onServerRequest(req, rsp);
+        responder->done();
+    });
+}
@@ -7,9 +7,11 @@
 
 #include "log.h"
 #include "connection.h"
+#include "interceptor.h"
 #include <stdint.h>
 #include <arpa/inet.h>
 #include <memory>
+#include <string>
 
 /*
 #define OFFSETOF(type, member) \
@@ -27,6 +29,8 @@ namespace tinyrpc {
 enum ProtocolType {
     PROTOCOL_TYPE_PB = 0, // google protobuf
     PROTOCOL_TYPE_CC,     // normal binary serialize/unserialize
+    PROTOCOL_TYPE_USER = 16, // first type for Codec::registerProtocol
+    PROTOCOL_TYPE_MAX = 256, // protocolType is one byte in the head
 };
 
 enum MsgLengthStatus {
@@ -39,6 +43,20 @@ enum {
     PROTOCOL_TRACEID_SIZE = 32
 };
 
+// uris of frames the framework answers with itself, the traceId of the
+// request is echoed
+enum : uint32_t {
+    PROTOCOL_URI_OVERLOADED = 0xffffff01, // no slot for it(UriLimit), no body
+    PROTOCOL_URI_CONGESTED = 0xffffff02,  // worker queue delay(CoDel), no body
+    PROTOCOL_URI_RATE_LIMITED = 0xffffff03, // over the ip/uri RateLimit, no body
+};
+
+// the request was turned down without being handled, it can be retried
+inline bool isRejectedUri(uint32_t uri) {
+    return PROTOCOL_URI_OVERLOADED == uri || PROTOCOL_URI_CONGESTED == uri ||
+        PROTOCOL_URI_RATE_LIMITED == uri;
+}
+
 struct ProtocolHead {
     uint32_t length;
     uint8_t protocolType;
@@ -56,6 +74,12 @@ struct ProtocolHead {
 
     inline static uint32_t getLen() { return sizeof(ProtocolHead); }
 
+    // traceId of a head packed by pack()
+    inline static const char* traceIdOf(const char* buff) {
+        return buff + sizeof(uint32_t) + sizeof(uint8_t) 
+            + 2 * sizeof(uint32_t);
+    }
+
     inline bool unpack(const char* buff, uint32_t len) {
         if(nullptr == buff || len < getLen()) {
             return false;
@@ -110,7 +134,8 @@ struct ProtocolHead {
 
     static MsgLengthStatus getPackageSize(char* buff, uint32_t len, 
                                           uint32_t& packageSize) {
-        if (len <= sizeof(ProtocolHead)) {
+        // a frame may be a head only: an empty message, or an overloaded
+        if (len < sizeof(ProtocolHead)) {
             return MSG_LEN_STATUS_NOT_COMPLETE;
         }
  
@@ -131,9 +156,66 @@ struct ProtocolHead {
 
 using VoidPtr = std::shared_ptr<void>;
 
+class ResponseQueue;
+class HandlerPool;
+class BatchQueue;
+class UriLimiter;
+class UriBulkhead;
+
+// server side: where deferred responses go back, where CALLBACK_MODE_POOL
+// handlers run, CALLBACK_MODE_BATCH requests wait and the bulkheads of the
+// uris are. nullptr: not used
+struct HandlerContext {
+    ResponseQueue* rspQueue;
+    HandlerPool* handlerPool;
+    BatchQueue* batchQueue;
+    UriLimiter* uriLimiter;
+
+    HandlerContext()
+        : rspQueue(nullptr)
+        , handlerPool(nullptr)
+        , batchQueue(nullptr)
+        , uriLimiter(nullptr) {}
+};
+
+// the response an inline handler sent, handed to Codec for ResponseCache
+struct InlineResponse {
+    uint32_t rspUri;
+    std::string data;       // serialized body
+    bool isSet;             // false: nothing sent, nothing to keep
+
+    InlineResponse() : rspUri(0), isSet(false) {}
+};
+
+namespace detail {
+class ICallback;
+}
+
 class Protocol {
 public:
+    Protocol()
+        : rspQueue_(nullptr), handlerPool_(nullptr), batchQueue_(nullptr),
+          uriLimiter_(nullptr), interceptors_(nullptr) {}
     virtual ~Protocol() = default;
+
+    // server side, see HandlerContext
+    virtual void setHandlerContext(const HandlerContext& context) {
+        rspQueue_ = context.rspQueue;
+        handlerPool_ = context.handlerPool;
+        batchQueue_ = context.batchQueue;
+        uriLimiter_ = context.uriLimiter;
+    }
+
+    // the runtime interceptors of the Codec, nullptr: none
+    virtual void setInterceptors(const InterceptorList* interceptors) {
+        interceptors_ = interceptors;
+    }
+
+    const InterceptorList* getInterceptors() const { return interceptors_; }
+
+    bool hasInterceptors() const {
+        return interceptors_ && !interceptors_->empty();
+    }
     
     virtual bool parseToMessage(const char* package, uint32_t packageSize, 
                                 uint32_t protocolUri, VoidPtr& message) = 0;
@@ -142,8 +224,54 @@ public:
 
     virtual bool dispatch(const char* package, uint32_t packageSize, 
                           uint32_t protocolUri, Connection* conn) = 0;
+
+    // a request of a cached uri: dispatched as by dispatch, the response of
+    // its inline handler also into kept. a protocol that does not say so
+    // keeps nothing and its responses are never cached
+    virtual bool dispatchInline(const char* package, uint32_t packageSize,
+                                uint32_t protocolUri, Connection* conn,
+                                InlineResponse* kept) {
+        return dispatch(package, packageSize, protocolUri, conn);
+    }
+
+    // true: the handler of reqUri runs inline and responds on return, see
+    // Server::setUriCache
+    virtual bool isInline(uint32_t reqUri) const { return false; }
+
+    // true: interceptors run around the handler of reqUri, a response from
+    // cache would skip them
+    virtual bool isIntercepted(uint32_t reqUri) const {
+        return hasInterceptors();
+    }
     
     virtual VoidPtr getDispatcher() = 0;
+
+protected:
+    // run a CALLBACK_MODE_DEFERRED/CALLBACK_MODE_POOL callback, or queue the
+    // request of a CALLBACK_MODE_BATCH one. the response is sent later
+    // through rspQueue_. over the UriLimit of reqUri it waits for a slot or
+    // is answered with PROTOCOL_URI_OVERLOADED
+    bool dispatchDeferred(const std::shared_ptr<detail::ICallback>& callback,
+                          uint32_t protocolType, uint32_t reqUri,
+                          uint32_t rspUri, const VoidPtr& req,
+                          const VoidPtr& rsp, const char* traceId,
+                          Connection* conn);
+
+private:
+    // the slot of bulkhead(nullptr: no limit) is taken, Responder gives it
+    // back
+    bool startDeferred(const std::shared_ptr<detail::ICallback>& callback,
+                       uint32_t protocolType, uint32_t reqUri,
+                       uint32_t rspUri, const VoidPtr& req,
+                       const VoidPtr& rsp, const char* traceId,
+                       Connection* conn, UriBulkhead* bulkhead);
+
+protected:
+    ResponseQueue* rspQueue_;
+    HandlerPool* handlerPool_;
+    BatchQueue* batchQueue_;
+    UriLimiter* uriLimiter_;
+    const InterceptorList* interceptors_;
 };
 
 } // namespace tinyrpc
@@ -0,0 +1,311 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "rate_limit.h"
+#include "log.h"
+#include <sys/mman.h>
+#include <algorithm>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <new>
+#include <vector>
+
+using namespace tinyrpc;
+
+// slots probed for an ip
+static const uint32_t IP_PROBE_NUM = 8;
+// reads of a slot being written before it is taken as busy
+static const int SLOT_READ_TRIES = 64;
+
+enum SlotState {
+    SLOT_BUSY = 0,  // a process writes it
+    SLOT_FREE,
+    SLOT_MINE,      // holds the ip looked for
+    SLOT_OTHER,
+};
+
+static int64_t getMonotonicNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// FNV-1a, never 0(a free slot)
+static uint64_t hashIp(const char* ip) {
+    uint64_t h = 14695981039346656037ULL;
+    for (; *ip; ip++) {
+        h = (h ^ (uint8_t)*ip) * 1099511628211ULL;
+    }
+    return h | 1;
+}
+
+// ip text as RateBucket::ip, cut to 47 bytes
+static void toIpWords(const char* ip, uint64_t* words) {
+    char text[RateBucket::IP_WORDS * sizeof(uint64_t)] = {0};
+    memcpy(text, ip, strnlen(ip, sizeof(text) - 1));
+    memcpy(words, text, sizeof(text));
+}
+
+// the key and ip of an ip slot, read as a seqlock. seq: the even seq they
+// were read at, for writeSlot
+static SlotState readSlot(const RateBucket* bucket, uint64_t key,
+                          const uint64_t* words, uint32_t& seq) {
+    for (int i = 0; i < SLOT_READ_TRIES; i++) {
+        seq = bucket->seq.load(std::memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        uint64_t k = bucket->key.load(std::memory_order_relaxed);
+        bool isMine = k == key;
+        for (int w = 0; isMine && w < RateBucket::IP_WORDS; w++) {
+            isMine = bucket->ip[w].load(std::memory_order_relaxed) == words[w];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (bucket->seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+        return 0 == k ? SLOT_FREE : (isMine ? SLOT_MINE : SLOT_OTHER);
+    }
+    return SLOT_BUSY;
+}
+
+// the slot becomes ip's unless another process wrote it since seq
+static bool writeSlot(RateBucket* bucket, uint32_t seq, uint64_t key,
+                      const uint64_t* words) {
+    if (!bucket->seq.compare_exchange_strong(seq, seq + 1,
+            std::memory_order_acquire)) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    bucket->key.store(key, std::memory_order_relaxed);
+    for (int w = 0; w < RateBucket::IP_WORDS; w++) {
+        bucket->ip[w].store(words[w], std::memory_order_relaxed);
+    }
+    bucket->passed.store(0, std::memory_order_relaxed);
+    bucket->rejected.store(0, std::memory_order_relaxed);
+    bucket->seq.store(seq + 2, std::memory_order_release);
+    return true;
+}
+
+// the ip text of a slot for the report, "-" while a process writes it
+static void readIpText(const RateBucket* bucket, char* text, size_t size) {
+    uint64_t words[RateBucket::IP_WORDS];
+    for (int i = 0; i < SLOT_READ_TRIES; i++) {
+        uint32_t seq = bucket->seq.load(std::memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        for (int w = 0; w < RateBucket::IP_WORDS; w++) {
+            words[w] = bucket->ip[w].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (bucket->seq.load(std::memory_order_relaxed) == seq) {
+            snprintf(text, size, "%.*s", (int)sizeof(words),
+                reinterpret_cast<const char*>(words));
+            return;
+        }
+    }
+    snprintf(text, size, "-");
+}
+
+static size_t getMapSize(size_t bucketNum) {
+    // the untracked counter after the buckets
+    return sizeof(RateBucket) * bucketNum + 64;
+}
+
+RateLimiter::RateLimiter()
+    : buckets_(nullptr)
+    , bucketNum_(0)
+    , ipBuckets_(nullptr)
+    , ipMask_(0)
+    , ipRule_()
+    , untrackedNum_(nullptr) {
+}
+
+RateLimiter::Rule RateLimiter::makeRule(const RateLimit& limit,
+                                        RateBucket* bucket) {
+    Rule rule = {bucket, 0, 0};
+    if (limit.rate_ > 0) {
+        rule.intervalNs = std::max<int64_t>(1, 1000000000LL / limit.rate_);
+        rule.burstNs = rule.intervalNs * std::max<uint32_t>(1, limit.burst_);
+    }
+    return rule;
+}
+
+bool RateLimiter::create(const RateLimitOption& opt) {
+    uint32_t ipSlotNum = 0;
+    if (opt.ip_.rate_ > 0) {
+        ipSlotNum = 1;
+        while (ipSlotNum < std::max<uint32_t>(opt.maxIpNum_, IP_PROBE_NUM)) {
+            ipSlotNum <<= 1;
+        }
+    }
+
+    size_t uriNum = 0;
+    for (auto& it : opt.uris_) {
+        if (it.second.rate_ > 0) {
+            uriNum++;
+        }
+    }
+    bucketNum_ = uriNum + ipSlotNum;
+    if (0 == bucketNum_) {
+        LOG(Warn, "rate limit has no rate set");
+        return false;
+    }
+
+    void* addr = mmap(nullptr, getMapSize(bucketNum_), PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == addr) {
+        LOG(Error, "mmap failed, err:%s", strerror(errno));
+        bucketNum_ = 0;
+        return false;
+    }
+
+    buckets_ = static_cast<RateBucket*>(addr);
+    for (size_t i = 0; i < bucketNum_; i++) {
+        new (&buckets_[i]) RateBucket();
+        buckets_[i].reset(0);
+    }
+    untrackedNum_ = new (&buckets_[bucketNum_]) std::atomic<uint64_t>(0);
+
+    size_t n = 0;
+    for (auto& it : opt.uris_) {
+        if (it.second.rate_ > 0) {
+            RateBucket* bucket = &buckets_[n++];
+            bucket->reset(it.first);
+            uriRules_[it.first] = makeRule(it.second, bucket);
+        }
+    }
+    if (ipSlotNum > 0) {
+        ipBuckets_ = &buckets_[uriNum];
+        ipMask_ = ipSlotNum - 1;
+        ipRule_ = makeRule(opt.ip_, nullptr);
+    }
+    return true;
+}
+
+void RateLimiter::destroy() {
+    if (buckets_) {
+        munmap(buckets_, getMapSize(bucketNum_));
+        buckets_ = nullptr;
+        bucketNum_ = 0;
+        ipBuckets_ = nullptr;
+        untrackedNum_ = nullptr;
+        uriRules_.clear();
+    }
+}
+
+bool RateLimiter::take(const Rule& rule, RateBucket* bucket, int64_t nowNs) {
+    int64_t tat = bucket->tatNs.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t newTat = std::max(tat, nowNs) + rule.intervalNs;
+        if (newTat - nowNs > rule.burstNs) {
+            bucket->rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (bucket->tatNs.compare_exchange_weak(tat, newTat,
+                std::memory_order_relaxed)) {
+            bucket->passed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+RateBucket* RateLimiter::findIp(const char* ip, int64_t nowNs) {
+    const uint64_t key = hashIp(ip);
+    uint64_t words[RateBucket::IP_WORDS];
+    toIpWords(ip, words);
+    RateBucket* idle = nullptr;
+    uint32_t idleSeq = 0;
+    for (uint32_t i = 0; i < IP_PROBE_NUM; i++) {
+        RateBucket* bucket = &ipBuckets_[(key + i) & ipMask_];
+        uint32_t seq = 0;
+        SlotState state = readSlot(bucket, key, words, seq);
+        if (SLOT_FREE == state) {
+            // slots are never freed, so the ip is in none of the next ones.
+            // claim it, or another process did first, maybe for this ip
+            if (writeSlot(bucket, seq, key, words) ||
+                SLOT_MINE == readSlot(bucket, key, words, seq)) {
+                return bucket;
+            }
+        } else if (SLOT_MINE == state) {
+            return bucket;
+        } else if (SLOT_OTHER == state && !idle &&
+                   bucket->tatNs.load(std::memory_order_relaxed) <= nowNs) {
+            idle = bucket;
+            idleSeq = seq;
+        }
+    }
+
+    // take over the slot of an idle ip, unless another process did
+    if (idle && writeSlot(idle, idleSeq, key, words)) {
+        return idle;
+    }
+    return nullptr;
+}
+
+bool RateLimiter::admit(const char* ip, uint32_t uri) {
+    int64_t nowNs = getMonotonicNanos();
+    if (ipBuckets_) {
+        RateBucket* bucket = findIp(ip, nowNs);
+        if (!bucket) {
+            untrackedNum_->fetch_add(1, std::memory_order_relaxed);
+        } else if (!take(ipRule_, bucket, nowNs)) {
+            return false;
+        }
+    }
+
+    auto it = uriRules_.find(uri);
+    return it == uriRules_.end() || take(it->second, it->second.bucket, nowNs);
+}
+
+void RateLimiter::report(std::string& out, size_t maxIpNum) const {
+    if (!buckets_) {
+        return;
+    }
+
+    char line[128];
+    for (auto& it : uriRules_) {
+        const RateBucket* bucket = it.second.bucket;
+        snprintf(line, sizeof(line), "rate_limit uri 0x%x passed %lu "
+            "rejected %lu\n", it.first,
+            (unsigned long)bucket->passed.load(std::memory_order_relaxed),
+            (unsigned long)bucket->rejected.load(std::memory_order_relaxed));
+        out += line;
+    }
+    if (!ipBuckets_) {
+        return;
+    }
+
+    // rejected counts are taken once, the workers keep adding to them
+    std::vector<std::pair<uint64_t, const RateBucket*>> rejected;
+    for (uint32_t i = 0; i <= ipMask_; i++) {
+        uint64_t n = ipBuckets_[i].rejected.load(std::memory_order_relaxed);
+        if (n > 0) {
+            rejected.emplace_back(n, &ipBuckets_[i]);
+        }
+    }
+    size_t num = std::min(maxIpNum, rejected.size());
+    std::partial_sort(rejected.begin(), rejected.begin() + num, rejected.end(),
+        [](const std::pair<uint64_t, const RateBucket*>& a,
+           const std::pair<uint64_t, const RateBucket*>& b) {
+            return a.first > b.first;
+        });
+    snprintf(line, sizeof(line), "rate_limit ips_rejected %zu untracked %lu\n",
+        rejected.size(),
+        (unsigned long)untrackedNum_->load(std::memory_order_relaxed));
+    out += line;
+    for (size_t i = 0; i < num; i++) {
+        const RateBucket* bucket = rejected[i].second;
+        char ip[sizeof(bucket->ip)];
+        readIpText(bucket, ip, sizeof(ip));
+        snprintf(line, sizeof(line), "rate_limit ip %s passed %lu "
+            "rejected %lu\n", ip,
+            (unsigned long)bucket->passed.load(std::memory_order_relaxed),
+            (unsigned long)rejected[i].first);
+        out += line;
+    }
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __RATE_LIMIT_H__
+#define __RATE_LIMIT_H__
+
+#include "option.h"
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+namespace tinyrpc {
+
+// a token bucket in shared memory, as GCRA: tatNs is when the bucket is
+// full again, a request moves it one interval later unless that is more
+// than burst intervals ahead of now. one CAS, no lock across processes
+struct alignas(64) RateBucket {
+    enum {
+        IP_WORDS = 6,               // 47 bytes of ip text and a '\0'
+    };
+
+    std::atomic<uint64_t> key;      // ip hash or uri, 0: free slot
+    std::atomic<int64_t> tatNs;     // monotonic
+    std::atomic<uint64_t> passed;
+    std::atomic<uint64_t> rejected;
+    // ip slots: a seqlock over key and ip, odd while a process writes them
+    std::atomic<uint32_t> seq;
+    // ip text, '\0' padded: an ip slot is its key and these bytes, two ips
+    // of one hash get two slots
+    std::atomic<uint64_t> ip[IP_WORDS];
+
+    void reset(uint64_t k) {
+        key.store(k, std::memory_order_relaxed);
+        tatNs.store(0, std::memory_order_relaxed);
+        passed.store(0, std::memory_order_relaxed);
+        rejected.store(0, std::memory_order_relaxed);
+        seq.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < IP_WORDS; i++) {
+            ip[i].store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+static_assert(sizeof(RateBucket) == 128, "RateBucket is two cache lines");
+
+/*
+ * RateLimitOption of all workers: the buckets live in shared memory
+ * (MAP_SHARED | MAP_ANONYMOUS) created by the watcher before fork, so a
+ * client gets the same rate whichever worker its conns land on.
+ *
+ * Ip buckets are an open addressed table keyed by the hash of the ip text.
+ * A slot whose bucket is full again(idle ip) is taken over by a new ip,
+ * that loses nothing: a full bucket is a new one. If all probed slots are
+ * busy the ip is not limited(untracked in the report).
+ *
+ * A process claims or takes over a slot by moving its seq to odd, writes
+ * the key, the ip and zeroed counters, then moves seq to even again; the
+ * others read key and ip only between two equal even seqs. A request of
+ * the old ip that found the slot just before a takeover may still land its
+ * token and count on the new ip: one token of a full bucket. A process that
+ * dies while it writes leaves the slot odd, it is skipped from then on.
+ */
+class RateLimiter {
+public:
+    RateLimiter();
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator = (const RateLimiter&) = delete;
+    ~RateLimiter() { destroy(); }
+
+    bool create(const RateLimitOption& opt);
+    void destroy();
+    bool isCreated() const { return nullptr != buckets_; }
+
+    // a request of uri from ip, any process. false: over the bucket of the
+    // ip or of the uri(the ip's token is spent already then)
+    bool admit(const char* ip, uint32_t uri);
+
+    // text report: a line per uri, and the ips that had requests rejected,
+    // most rejected first
+    void report(std::string& out, size_t maxIpNum = 16) const;
+
+private:
+    struct Rule {
+        RateBucket* bucket;
+        int64_t intervalNs;
+        int64_t burstNs;
+    };
+
+    static Rule makeRule(const RateLimit& limit, RateBucket* bucket);
+    static bool take(const Rule& rule, RateBucket* bucket, int64_t nowNs);
+    // the bucket of ip, taken if new. nullptr: no slot for it
+    RateBucket* findIp(const char* ip, int64_t nowNs);
+
+    RateBucket* buckets_;   // uri buckets, then ip slots
+    size_t bucketNum_;
+    RateBucket* ipBuckets_;
+    uint32_t ipMask_;       // ip slots - 1, a power of 2
+    Rule ipRule_;           // intervalNs 0: no ip limit
+    std::atomic<uint64_t>* untrackedNum_;   // in shared memory too
+    // read only after create()
+    std::unordered_map<uint32_t, Rule> uriRules_;
+};
+
+} // namespace tinyrpc
+
+#endif // __RATE_LIMIT_H__
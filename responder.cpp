@@ -0,0 +1,240 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "responder.h"
+#include "connection.h"
+#include "log.h"
+#include "uri_limit.h"
+#include "dispatcher_base/callback_base.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace tinyrpc;
+
+ResponseQueue::ResponseQueue()
+    : eventfd_(-1)
+    , poller_(nullptr)
+    , inflight_(0) {
+}
+
+ResponseQueue::~ResponseQueue() {
+    if (eventfd_ >= 0) {
+        if (poller_) {
+            poller_->delFd(eventfd_);
+        }
+        close(eventfd_);
+        eventfd_ = -1;
+    }
+}
+
+bool ResponseQueue::init(Poller* poller, const DrainCallback& cb) {
+    eventfd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventfd_ < 0) {
+        LOG(Error, "eventfd failed, err:%s", strerror(errno));
+        return false;
+    }
+
+    poller_ = poller;
+    drainCallback_ = cb;
+
+    poller_->setFdReadCallback(eventfd_,
+        std::bind(&ResponseQueue::onEventFd, this, std::placeholders::_1,
+            std::placeholders::_2, std::placeholders::_3), this);
+    return poller_->addFd(eventfd_, EV_READ);
+}
+
+bool ResponseQueue::push(PendingResponse&& rsp) {
+    bool isEmpty = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        isEmpty = queue_.empty();
+        queue_.push_back(std::move(rsp));
+    }
+
+    // only the first push wakes up the loop, the rest ride along
+    if (isEmpty) {
+        uint64_t one = 1;
+        if (::write(eventfd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            LOG(Error, "write eventfd failed, err:%s", strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+void ResponseQueue::onEventFd(int fd, int events, void* arg) {
+    uint64_t cnt = 0;
+    if (::read(fd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN) {
+        LOG(Error, "read eventfd failed, err:%s", strerror(errno));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        draining_.swap(queue_);
+    }
+
+    for (auto& rsp : draining_) {
+        subInflight();
+        drainCallback_(rsp);
+    }
+    draining_.clear();
+}
+
+Responder::Responder(ResponseQueue* queue, Protocol* protocol,
+                     uint32_t protocolType, uint32_t reqUri,
+                     uint32_t rspUri, const char* traceId, Connection* conn,
+                     const VoidPtr& rsp, UriBulkhead* bulkhead)
+    : queue_(queue)
+    , protocol_(protocol)
+    , protocolType_(protocolType)
+    , reqUri_(reqUri)
+    , rspUri_(rspUri)
+    , fd_(conn->getFd())
+    , connId_(conn->getId())
+    , rsp_(rsp)
+    , bulkhead_(bulkhead)
+    , isDone_(false) {
+    memcpy(traceId_, traceId, PROTOCOL_TRACEID_SIZE);
+    queue_->addInflight();
+    // on the conn's loop, counted down by the drain of queue_
+    conn->addInflight();
+}
+
+Responder::~Responder() {
+    if (!isDone_) {
+        if (bulkhead_) {
+            bulkhead_->release();
+        }
+        LOG(Warn, "responder destroyed without done()! fd:%d,rspUri:0x%xu",
+            fd_, rspUri_);
+        pushDropped();
+    }
+}
+
+bool Responder::pushDropped() {
+    PendingResponse pending;
+    pending.fd = fd_;
+    pending.connId = connId_;
+    pending.rspUri = rspUri_;
+    pending.isDropped = true;
+    return queue_->push(std::move(pending));
+}
+
+bool Responder::done() {
+    if (isDone_.exchange(true)) {
+        LOG(Error, "responder done twice! fd:%d,rspUri:0x%xu", fd_, rspUri_);
+        return false;
+    }
+
+    // the next waiting request of the uri starts on the loop, woken up by
+    // the response
+    if (bulkhead_) {
+        bulkhead_->release();
+    }
+
+    // off the conn's loop maybe: no conn for the interceptors
+    if (protocol_->hasInterceptors()) {
+        CallContext ctx(protocolType_, reqUri_, rspUri_, traceId_, nullptr,
+            nullptr, rsp_.get());
+        protocol_->getInterceptors()->onResponse(ctx);
+    }
+
+    PendingResponse pending;
+    pending.fd = fd_;
+    pending.connId = connId_;
+    pending.protocolType = protocolType_;
+    pending.rspUri = rspUri_;
+    memcpy(pending.traceId, traceId_, PROTOCOL_TRACEID_SIZE);
+
+    if (!protocol_->serializeToString(rsp_, pending.data)) {
+        LOG(Error, "serializeToString fail, rspUri:0x%xu", rspUri_);
+        pushDropped();
+        return false;
+    }
+    rsp_.reset();
+
+    // queued even if the wakeup fails, counted down when drained
+    return queue_->push(std::move(pending));
+}
+
+BatchQueue::BatchQueue(ResponseQueue* rspQueue)
+    : rspQueue_(rspQueue)
+    , pendingNum_(0) {
+}
+
+bool BatchQueue::add(Protocol* protocol,
+                     const std::shared_ptr<detail::ICallback>& callback,
+                     uint32_t protocolType, uint32_t reqUri, uint32_t rspUri,
+                     const VoidPtr& req, const VoidPtr& rsp,
+                     const char* traceId, Connection* conn) {
+    // a handful of batch uris at most
+    Batch* batch = nullptr;
+    for (auto& it : batches_) {
+        if (it.protocol == protocol && it.reqUri == reqUri) {
+            batch = &it;
+            break;
+        }
+    }
+    if (!batch) {
+        batches_.emplace_back();
+        batch = &batches_.back();
+        batch->protocol = protocol;
+        batch->callback = callback;
+        batch->reqUri = reqUri;
+        batch->rspUri = rspUri;
+    }
+
+    batch->reqs.push_back(req);
+    batch->rsps.push_back(rsp);
+    batch->replies.emplace_back();
+    PendingResponse& pending = batch->replies.back();
+    pending.fd = conn->getFd();
+    pending.connId = conn->getId();
+    pending.protocolType = protocolType;
+    pending.rspUri = rspUri;
+    memcpy(pending.traceId, traceId, PROTOCOL_TRACEID_SIZE);
+
+    // counted down by ResponseQueue::deliver() and the conn's drain
+    rspQueue_->addInflight();
+    conn->addInflight();
+    pendingNum_++;
+    return true;
+}
+
+void BatchQueue::flush() {
+    for (auto& batch : batches_) {
+        if (!batch.reqs.empty()) {
+            flush(batch);
+        }
+    }
+    pendingNum_ = 0;
+}
+
+void BatchQueue::flush(Batch& batch) {
+    batch.callback->onServerBatch(batch.reqs, batch.rsps);
+
+    Protocol* protocol = batch.protocol;
+    for (size_t i = 0; i < batch.replies.size(); i++) {
+        PendingResponse& pending = batch.replies[i];
+        if (protocol->hasInterceptors()) {
+            CallContext ctx(pending.protocolType, batch.reqUri, batch.rspUri,
+                pending.traceId, nullptr, batch.reqs[i].get(),
+                batch.rsps[i].get());
+            protocol->getInterceptors()->onResponse(ctx);
+        }
+
+        if (!protocol->serializeToString(batch.rsps[i], pending.data)) {
+            LOG(Error, "serializeToString fail, rspUri:0x%xu", batch.rspUri);
+            pending.data.clear();
+            pending.isDropped = true;
+        }
+        rspQueue_->deliver(pending);
+    }
+
+    batch.reqs.clear();
+    batch.rsps.clear();
+    batch.replies.clear();
+}
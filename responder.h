@@ -0,0 +1,175 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __RESPONDER_H__
+#define __RESPONDER_H__
+
+#include "protocol.h"
+#include "poller.h"
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tinyrpc {
+
+class Connection;
+class UriBulkhead;
+
+// serialized response waiting to be sent by the loop owning the connection
+struct PendingResponse {
+    int fd;
+    uint64_t connId;    // Connection::getId(), detects a reused fd
+    uint32_t protocolType;
+    uint32_t rspUri;
+    char traceId[PROTOCOL_TRACEID_SIZE]; // echo of the request's traceId
+    std::string data;
+    // nothing to send(dropped without done(), or not serialized): only the
+    // inflight counts are brought down
+    bool isDropped;
+
+    PendingResponse()
+        : fd(-1), connId(0), protocolType(0), rspUri(0),
+          isDropped(false) {
+        memset(traceId, 0, PROTOCOL_TRACEID_SIZE);
+    }
+};
+
+/*
+ * MPSC queue of finished responses. push() may be called from any thread,
+ * the queue is drained on the owning Poller's loop, woken up by an eventfd.
+ */
+class ResponseQueue {
+public:
+    using DrainCallback = std::function<void (PendingResponse&)>;
+
+    ResponseQueue();
+    ResponseQueue(const ResponseQueue&) = delete;
+    ResponseQueue& operator = (const ResponseQueue&) = delete;
+    ~ResponseQueue();
+
+    bool init(Poller* poller, const DrainCallback& cb);
+
+    bool push(PendingResponse&& rsp);
+
+    // on the loop: rsp to the drain callback now, no eventfd round. counts
+    // down an addInflight() like a drained one
+    void deliver(PendingResponse& rsp) {
+        subInflight();
+        drainCallback_(rsp);
+    }
+
+    // Responders created but not drained yet
+    void addInflight() { inflight_.fetch_add(1, std::memory_order_relaxed); }
+    void subInflight() { inflight_.fetch_sub(1, std::memory_order_relaxed); }
+    uint32_t getInflight() const {
+        return inflight_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void onEventFd(int fd, int events, void* arg);
+
+    int eventfd_;
+    Poller* poller_;
+    DrainCallback drainCallback_;
+
+    std::mutex mtx_;
+    std::vector<PendingResponse> queue_;
+    std::vector<PendingResponse> draining_;
+    std::atomic<uint32_t> inflight_;
+};
+
+/*
+ * Handle of a request whose response is sent later. The handler fills rsp
+ * and calls done() from any thread; the response is serialized there and
+ * handed back to the connection's loop. If the connection is closed in the
+ * meantime the response is dropped. The slot of bulkhead(nullptr: none) is
+ * given back on done(), or when dropped without it.
+ */
+class Responder {
+public:
+    Responder(ResponseQueue* queue, Protocol* protocol, uint32_t protocolType,
+              uint32_t reqUri, uint32_t rspUri, const char* traceId,
+              Connection* conn, const VoidPtr& rsp,
+              UriBulkhead* bulkhead = nullptr);
+    Responder(const Responder&) = delete;
+    Responder& operator = (const Responder&) = delete;
+    ~Responder();
+
+    // send the response, only the first call takes effect
+    bool done();
+    bool isDone() const { return isDone_.load(); }
+
+    uint32_t getRspUri() const { return rspUri_; }
+
+private:
+    // a response with nothing to send, for the counts of the conn's loop
+    bool pushDropped();
+
+    ResponseQueue* queue_;
+    Protocol* protocol_;
+    uint32_t protocolType_;
+    uint32_t reqUri_;
+    uint32_t rspUri_;
+    int fd_;
+    uint64_t connId_;
+    char traceId_[PROTOCOL_TRACEID_SIZE];
+    VoidPtr rsp_;
+    UriBulkhead* bulkhead_;
+    std::atomic<bool> isDone_;
+};
+
+using ResponderPtr = std::shared_ptr<Responder>;
+
+namespace detail {
+class ICallback;
+}
+
+/*
+ * CALLBACK_MODE_BATCH requests of one loop iteration, from all conns,
+ * grouped by uri. flush() runs after the fired events: each callback is
+ * called once with the requests of its uri, the responses are sent right
+ * away through the ResponseQueue's drain callback. Loop thread only.
+ */
+class BatchQueue {
+public:
+    explicit BatchQueue(ResponseQueue* rspQueue);
+    BatchQueue(const BatchQueue&) = delete;
+    BatchQueue& operator = (const BatchQueue&) = delete;
+
+    bool add(Protocol* protocol,
+             const std::shared_ptr<detail::ICallback>& callback,
+             uint32_t protocolType, uint32_t reqUri, uint32_t rspUri,
+             const VoidPtr& req, const VoidPtr& rsp, const char* traceId,
+             Connection* conn);
+
+    void flush();
+    bool empty() const { return 0 == pendingNum_; }
+
+private:
+    struct Batch {
+        Protocol* protocol;
+        std::shared_ptr<detail::ICallback> callback;
+        uint32_t reqUri;
+        uint32_t rspUri;
+        std::vector<VoidPtr> reqs;
+        std::vector<VoidPtr> rsps;
+        // everything but data, filled by add()
+        std::vector<PendingResponse> replies;
+    };
+
+    void flush(Batch& batch);
+
+    ResponseQueue* rspQueue_;
+    // one per uri seen, kept with their capacity
+    std::vector<Batch> batches_;
+    uint32_t pendingNum_;
+};
+
+} // namespace tinyrpc
+
+#endif // __RESPONDER_H__
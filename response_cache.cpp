@@ -0,0 +1,141 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "response_cache.h"
+#include "log.h"
+#include "shm_cache.h"
+#include "util.h"
+#include <string.h>
+#include <iterator>
+
+using namespace tinyrpc;
+
+// an entry costs its bytes and about this much besides
+static const uint32_t ENTRY_OVERHEAD = 128;
+
+bool ResponseCache::setUri(uint32_t uri, const UriCache& cache) {
+    if (0 == cache.ttlMs_ || 0 == cache.maxBytes_) {
+        LOG(Error, "setUri failed, ttlMs or maxBytes is 0! uri:0x%xu", uri);
+        return false;
+    }
+    if (!isCacheable_ || !isCacheable_(uri)) {
+        LOG(Error, "setUri failed, not inline or intercepted, uri:0x%x", uri);
+        return false;
+    }
+    if (cache.isShared_ && !shared_) {
+        LOG(Error, "setUri failed, no shared cache for uri:0x%x", uri);
+        return false;
+    }
+    tables_[uri].reset(new UriCacheTable(uri, cache));
+    return true;
+}
+
+uint64_t ResponseCache::hash(uint32_t protocolType, const char* body,
+                             uint32_t len) {
+    return Util::hashBytes(body, len, protocolType);
+}
+
+const std::string* ResponseCache::get(UriCacheTable* table, uint64_t hash,
+                                      uint32_t protocolType, const char* body,
+                                      uint32_t len, int64_t nowMs,
+                                      uint32_t& rspUri) {
+    UriCacheStats& stats = table->stats_;
+    if (table->cache_.isShared_) {
+        makeSharedKey(table, protocolType, body, len);
+        if (!shared_->get(key_, value_, &rspUri)) {
+            stats.misses++;
+            return nullptr;
+        }
+        stats.hits++;
+        return &value_;
+    }
+
+    auto found = table->index_.find(hash);
+    if (found == table->index_.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    auto it = found->second;
+    if (it->expireMs <= nowMs) {
+        erase(table, it);
+        stats.expirations++;
+        stats.misses++;
+        return nullptr;
+    }
+    // a collision of the hash is a miss, put() replaces the entry
+    if (it->protocolType != protocolType || it->req.size() != len ||
+        0 != memcmp(it->req.data(), body, len)) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    table->lru_.splice(table->lru_.begin(), table->lru_, it);
+    stats.hits++;
+    rspUri = it->rspUri;
+    return &it->rsp;
+}
+
+void ResponseCache::put(UriCacheTable* table, uint64_t hash,
+                        uint32_t protocolType, const char* body, uint32_t len,
+                        uint32_t rspUri, const std::string& rsp,
+                        int64_t nowMs) {
+    if (table->cache_.isShared_) {
+        makeSharedKey(table, protocolType, body, len);
+        shared_->set(key_, rsp, table->cache_.ttlMs_, rspUri);
+        return;
+    }
+
+    UriCacheStats& stats = table->stats_;
+    const uint64_t maxBytes = table->cache_.maxBytes_;
+    if (len + rsp.size() + ENTRY_OVERHEAD > maxBytes) {
+        return;
+    }
+
+    auto found = table->index_.find(hash);
+    if (found != table->index_.end()) {
+        erase(table, found->second);
+    }
+
+    table->lru_.push_front({hash, protocolType, std::string(body, len), rspUri,
+        rsp, nowMs + table->cache_.ttlMs_});
+    table->index_[hash] = table->lru_.begin();
+    stats.bytes += getEntryBytes(table->lru_.front());
+    stats.entries++;
+
+    while (stats.bytes > maxBytes) {
+        erase(table, std::prev(table->lru_.end()));
+        stats.evictions++;
+    }
+}
+
+void ResponseCache::erase(UriCacheTable* table,
+                          std::list<UriCacheTable::Entry>::iterator it) {
+    UriCacheStats& stats = table->stats_;
+    stats.bytes -= getEntryBytes(*it);
+    stats.entries--;
+    table->index_.erase(it->hash);
+    table->lru_.erase(it);
+}
+
+void ResponseCache::forEach(const std::function<void (uint32_t,
+                            const UriCacheStats&)>& visit) const {
+    for (auto& it : tables_) {
+        visit(it.first, it.second->stats_);
+    }
+}
+
+uint64_t ResponseCache::getEntryBytes(const UriCacheTable::Entry& entry) {
+    return entry.req.size() + entry.rsp.size() + ENTRY_OVERHEAD;
+}
+
+void ResponseCache::makeSharedKey(const UriCacheTable* table,
+                                  uint32_t protocolType, const char* body,
+                                  uint32_t len) {
+    key_.assign(reinterpret_cast<const char*>(&table->uri_),
+        sizeof(table->uri_));
+    key_.append(reinterpret_cast<const char*>(&protocolType),
+        sizeof(protocolType));
+    key_.append(body, len);
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __RESPONSE_CACHE_H__
+#define __RESPONSE_CACHE_H__
+
+#include <stdint.h>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace tinyrpc {
+
+class ShmCache;
+
+// response cache of one uri, see Server::setUriCache
+struct UriCache {
+    uint32_t ttlMs_;
+    uint32_t maxBytes_;     // requests + responses kept, LRU beyond
+    // in the ShmCache of all workers(ShmCacheOption) instead, maxBytes_ is
+    // not used: memory and eviction are the shm cache's
+    bool isShared_;
+
+    UriCache()
+        : ttlMs_(1000)
+        , maxBytes_(4 << 20)
+        , isShared_(false) {}
+};
+
+struct UriCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;     // LRU, over maxBytes_. 0 if shared
+    uint64_t expirations;   // hit after ttlMs_
+    uint64_t bytes;         // 0 if shared, see ShmCacheStats
+    uint32_t entries;
+
+    UriCacheStats()
+        : hits(0)
+        , misses(0)
+        , evictions(0)
+        , expirations(0)
+        , bytes(0)
+        , entries(0) {}
+};
+
+// the entries of one uri, owned by ResponseCache
+class UriCacheTable {
+public:
+    UriCacheTable(uint32_t uri, const UriCache& cache)
+        : uri_(uri), cache_(cache) {}
+    UriCacheTable(const UriCacheTable&) = delete;
+    UriCacheTable& operator = (const UriCacheTable&) = delete;
+
+    const UriCacheStats& getStats() const { return stats_; }
+
+private:
+    friend class ResponseCache;
+
+    struct Entry {
+        uint64_t hash;
+        uint32_t protocolType;
+        std::string req;    // body, compared on a hit
+        uint32_t rspUri;
+        std::string rsp;    // serialized body
+        int64_t expireMs;
+    };
+
+    uint32_t uri_;
+    UriCache cache_;
+    UriCacheStats stats_;
+    std::list<Entry> lru_;  // most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+};
+
+/*
+ * Responses of idempotent uris of a worker, keyed by the request body
+ * bytes. A hit is sent from here with the traceId of the request: no
+ * parse, handler, serialize. Only uris of inline handlers without
+ * interceptors are cached, setUri refuses the others: a deferred/pool/batch
+ * response comes after dispatch returns, and a hit would pass by the
+ * interceptors that turn a caller down. On a miss the protocol hands the
+ * response of the handler back(Protocol::dispatchInline).
+ * A shared uri keeps its responses in the ShmCache instead, keyed by uri,
+ * protocol type and body: a response put by one worker is a hit on all.
+ * Loop thread only.
+ */
+class ResponseCache {
+public:
+    ResponseCache() : shared_(nullptr) {}
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator = (const ResponseCache&) = delete;
+
+    // for UriCache::isShared_, before setUri
+    void setSharedCache(ShmCache* shared) { shared_ = shared; }
+    // true if uri can be cached(Codec::isCacheableUri), before setUri
+    void setCacheableCheck(const std::function<bool (uint32_t)>& isCacheable) {
+        isCacheable_ = isCacheable;
+    }
+
+    // before the loop runs, after the handler of uri is registered. false
+    // if ttlMs_ or maxBytes_ is 0, the handler of uri is not inline or is
+    // intercepted(or there is no cacheable check), or the uri is shared
+    // and there is no shared cache
+    bool setUri(uint32_t uri, const UriCache& cache);
+    bool empty() const { return tables_.empty(); }
+
+    // nullptr: uri is not cached
+    UriCacheTable* find(uint32_t uri) const {
+        auto it = tables_.find(uri);
+        return it != tables_.end() ? it->second.get() : nullptr;
+    }
+
+    static uint64_t hash(uint32_t protocolType, const char* body,
+                         uint32_t len);
+
+    // the response to body, nullptr on a miss. expired entries are dropped
+    const std::string* get(UriCacheTable* table, uint64_t hash,
+                           uint32_t protocolType, const char* body,
+                           uint32_t len, int64_t nowMs, uint32_t& rspUri);
+    void put(UriCacheTable* table, uint64_t hash, uint32_t protocolType,
+             const char* body, uint32_t len, uint32_t rspUri,
+             const std::string& rsp, int64_t nowMs);
+
+    // visit every cached uri, for stats
+    void forEach(const std::function<void (uint32_t, const UriCacheStats&)>&
+                 visit) const;
+
+private:
+    static uint64_t getEntryBytes(const UriCacheTable::Entry& entry);
+    void erase(UriCacheTable* table,
+               std::list<UriCacheTable::Entry>::iterator it);
+
+    // the key of body in shared_, into key_
+    void makeSharedKey(const UriCacheTable* table, uint32_t protocolType,
+                       const char* body, uint32_t len);
+
+    // read only after the loop runs
+    std::unordered_map<uint32_t, std::unique_ptr<UriCacheTable>> tables_;
+    ShmCache* shared_;
+    std::function<bool (uint32_t)> isCacheable_;
+    std::string key_;       // reused for shared uris
+    std::string value_;     // the last shared hit
+};
+
+} // namespace tinyrpc
+
+#endif // __RESPONSE_CACHE_H__
@@ -7,7 +7,11 @@
 #include "compiler.h"
 #include "server.h"
 #include "util.h"
+#include "socket.h"
+#include "pipe_msg.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <sys/epoll.h>
 #include <arpa/inet.h>
 #include <sys/wait.h>
@@ -27,39 +31,204 @@ Server::Server(const std::vector<option>& vecOpt)
     , workerList_(NULL)
     , workerIndex_(-1)
     , listenfd_(-1)
+    , isListening_(false)
+    , cpu_(-1)
+    , pauseConnNum_(0)
+    , resumeConnNum_(0)
+    , isAcceptPaused_(false)
+    , pauseBeginUs_(0)
+    , acceptPausedUs_(0)
+    , steeredConnNum_(0)
+    , rxCpuMismatchNum_(0)
+    , acceptDroppedNum_(0)
+    , isTakingOver_(false)
+    , isDraining_(false)
+    , drainBeginTime_(0)
+    , load_(NULL)
+    , reqNum_(0)
+    , migratedConnNum_(0)
+    , skipNextRebalance_(false)
+    , scaleUpRounds_(0)
+    , scaleDownRounds_(0)
+    , isSpawnPending_(false)
     , maxfd_(opt_.commonOption_.maxConnNum_)
     , poller_(NULL)
     , codec_(new Codec())
-    , connPool_(opt_.commonOption_.maxConnNum_) {
-    workerNum_ = opt_.commonOption_.workerNum_;
-    assert(workerNum_ > 0 && workerNum_ <= PROCESS_MAXNUM);
+    , rspQueue_(NULL)
+    , handlerPool_(NULL)
+    , batchQueue_(NULL)
+    , uriLimiter_(new UriLimiter())
+    , codel_(NULL)
+    , responseCache_(new ResponseCache())
+    , connIdSeq_(0)
+    , connPool_(NULL) {
+    const int initWorkerNum = opt_.commonOption_.workerNum_;
+    ScaleOption& scale = opt_.scaleOption_;
+    if (scale.enable_ && opt_.acceptOption_.cpuSteering_) {
+        // the reuseport group is sized for the initial workers
+        LOG(Warn, "worker scaling is off with cpu steering");
+        scale.enable_ = false;
+    }
+    workerNum_ = initWorkerNum;
+    if (scale.enable_) {
+        scale.maxWorkerNum_ = std::min<uint32_t>(
+            std::max<uint32_t>(scale.maxWorkerNum_, initWorkerNum),
+            PROCESS_MAXNUM);
+        scale.minWorkerNum_ = std::max<uint32_t>(1,
+            std::min(scale.minWorkerNum_, scale.maxWorkerNum_));
+        workerNum_ = scale.maxWorkerNum_;
+    }
+    assert(initWorkerNum > 0 && workerNum_ <= PROCESS_MAXNUM);
     workerList_ = new Process[workerNum_];
     assert(workerList_);
 
-    for (int i = 0; i < workerNum_; i++) {
-        socketpair(AF_LOCAL, SOCK_STREAM, 0, workerList_[i].pipefd);
-        
-        workerList_[i].pid= fork();
-        if (workerList_[i].pid < 0) {
-            LOG(Error, "fork failed!");
-        } else if (workerList_[i].pid > 0) { // parent
-            // write/read sv[1] to IPC with child
-            close(workerList_[i].pipefd[0]);
-            continue;                           
-        } else { // child
-            workerIndex_ = i;
-            // write/read sv[0] to IPC with parent
-            close(workerList_[i].pipefd[1]); 
+    const uint32_t maxConn = opt_.commonOption_.maxConnNum_;
+    pauseConnNum_ = (uint64_t)maxConn * opt_.acceptOption_.pausePct_ / 100;
+    resumeConnNum_ = (uint64_t)maxConn * opt_.acceptOption_.resumePct_ / 100;
+    if (resumeConnNum_ >= pauseConnNum_) {
+        resumeConnNum_ = pauseConnNum_ > 0 ? pauseConnNum_ - 1 : 0;
+    }
+
+    // hot restart: reuse the listenfd of the running server, if any
+    if (opt_.hotRestartOption_.enable_) {
+        isTakingOver_ = takeOver();
+    }
+
+    // shared listenfd, inherited by all workers
+    const AcceptStrategy strategy = opt_.acceptOption_.strategy_;
+    if (ACCEPT_STRATEGY_REUSEPORT != strategy) {
+        if (listenfd_ < 0 && !listen()) {
+            LOG(Error, "listen failed, accept strategy:%d", strategy);
+        }
+        if (ACCEPT_STRATEGY_SEMLOCK == strategy && !acceptLock_.create()) {
+            LOG(Error, "create accept lock failed");
+        }
+    } else if (opt_.acceptOption_.cpuSteering_ && !listenPerCpu()) {
+        // workers listen on their own, the kernel hashes
+        LOG(Error, "listen per cpu failed, cpu steering off");
+    }
+
+    if (!loadTable_.create(workerNum_)) {
+        LOG(Error, "create worker load table failed");
+    }
+
+    if (opt_.rateLimitOption_.enable_ &&
+        !rateLimiter_.create(opt_.rateLimitOption_)) {
+        LOG(Error, "create rate limiter failed");
+    }
+
+    // setUriCache: only responses of inline handlers without interceptors
+    // can be kept
+    responseCache_->setCacheableCheck([this](uint32_t uri) {
+        return codec_->isCacheableUri(uri);
+    });
+
+    if (opt_.shmCacheOption_.enable_) {
+        if (shmCache_.create(opt_.shmCacheOption_)) {
+            responseCache_->setSharedCache(&shmCache_);
+        } else {
+            LOG(Error, "create shm cache failed");
+        }
+    }
+
+    for (int i = 0; i < initWorkerNum; i++) {
+        if (0 == forkWorker(i)) {
             break;
         }
     }
+
+    // a worker keeps its own listenfd, the watcher none.
+    // NOTE: once a worker exits the group is reordered, conns are still
+    // accepted but land off-cpu, rxCpuMismatchNum_ shows it
+    for (int fd : cpuListenFds_) {
+        if (fd != listenfd_) {
+            close(fd);
+        }
+    }
+    cpuListenFds_.clear();
+}
+
+// parent: pid of the worker(-1 if failed), child: 0 with the worker's state
+pid_t Server::forkWorker(int index) {
+    Process& proc = workerList_[index];
+    proc.isRetiring = false;
+    // message oriented, see PipeMsg
+    if (socketpair(AF_LOCAL, SOCK_SEQPACKET, 0, proc.pipefd) < 0) {
+        LOG(Error, "socketpair err:%s", strerror(errno));
+        proc.pid = -1;
+        return -1;
+    }
+
+    proc.pid = fork();
+    if (proc.pid < 0) {
+        LOG(Error, "fork failed!");
+        close(proc.pipefd[0]);
+        close(proc.pipefd[1]);
+        proc.pipefd[0] = proc.pipefd[1] = -1;
+    } else if (proc.pid > 0) { // parent
+        // write/read sv[1] to IPC with child
+        close(proc.pipefd[0]);
+        proc.pipefd[0] = -1;
+    } else { // child
+        workerIndex_ = index;
+        load_ = loadTable_.at(index);
+        // the take over is done by the watcher
+        hotRestart_.close();
+        if (!cpuListenFds_.empty()) {
+            listenfd_ = cpuListenFds_[index];
+            cpu_ = index % Util::getCpuNum();
+        }
+        // write/read sv[0] to IPC with parent, the watcher's ends of the
+        // other workers are not ours
+        for (int n = 0; n < workerNum_; n++) {
+            if (workerList_[n].pipefd[1] >= 0) {
+                close(workerList_[n].pipefd[1]);
+                workerList_[n].pipefd[1] = -1;
+            }
+        }
+    }
+    return proc.pid;
 }
 
 Server::~Server() {
+    if (!isWorker()) {
+        acceptLock_.destroy();
+    }
+
     if (workerList_) {
         delete [] workerList_;
     }
 
+    if (handlerPool_) {
+        delete handlerPool_;
+        handlerPool_ = nullptr;
+    }
+
+    if (batchQueue_) {
+        delete batchQueue_;
+        batchQueue_ = nullptr;
+    }
+
+    if (uriLimiter_) {
+        delete uriLimiter_;
+        uriLimiter_ = nullptr;
+    }
+
+    if (codel_) {
+        delete codel_;
+        codel_ = nullptr;
+    }
+
+    if (responseCache_) {
+        delete responseCache_;
+        responseCache_ = nullptr;
+    }
+
+    if (rspQueue_) {
+        delete rspQueue_;
+        rspQueue_ = nullptr;
+    }
+
     if (poller_) {
         delete poller_;
         poller_ = nullptr;
@@ -69,9 +238,16 @@ Server::~Server() {
         delete codec_;
         codec_ = nullptr;
     }
+
+    // conns go back to the pool when released
+    connMap_.clear();
+    if (connPool_) {
+        delete connPool_;
+        connPool_ = nullptr;
+    }
 }
 
-auto Server::clearConnAndEraseFromConnMap(const std::shared_ptr<Connection>& conn) {
+auto Server::clearConnAndEraseFromConnMap(Connection* conn) {
     if (!conn) {
         return connMap_.end();
     }
@@ -82,21 +258,78 @@ auto Server::clearConnAndEraseFromConnMap(const std::shared_ptr<Connection>& con
     close(fd);
     conn->reset();
 
+    if (load_) {
+        load_->connNum.fetch_sub(1, std::memory_order_relaxed);
+    }
+
     auto it = connMap_.find(fd);
     if (it != connMap_.end()) {
         // refcount of shared_ptr will -1 after erase()
-        return connMap_.erase(it);
+        it = connMap_.erase(it);
+        updateAcceptThrottle();
+        return it;
     }
     return connMap_.end();
 }
 
+bool Server::listen() {
+    const char *ip = opt_.serviceAddrOption_.ip_.c_str();
+    uint16_t port = opt_.serviceAddrOption_.port_;
+    int family = opt_.serviceAddrOption_.isIPv6_ ? AF_INET6 : AF_INET;
+    bool reusePort = ACCEPT_STRATEGY_REUSEPORT == opt_.acceptOption_.strategy_;
+    if (!listenOnAddress(family, ip, port, reusePort, listenfd_)) {
+        LOG(Error, "listenOnAddress failed, ip:%s, port:%d", ip, port);
+        return false;
+    }
+    LOG(Info, "listenfd:%d", listenfd_);
+    return true;
+}
+
+bool Server::listenPerCpu() {
+    const char *ip = opt_.serviceAddrOption_.ip_.c_str();
+    uint16_t port = opt_.serviceAddrOption_.port_;
+    int family = opt_.serviceAddrOption_.isIPv6_ ? AF_INET6 : AF_INET;
+    int cpuNum = Util::getCpuNum();
+    if (workerNum_ > cpuNum) {
+        LOG(Warn, "workers:%d > cpus:%d, workers beyond cpus get no conns",
+            workerNum_, cpuNum);
+    }
+
+    for (int i = 0; i < workerNum_; i++) {
+        int fd = -1;
+        if (!listenOnAddress(family, ip, port, true, fd)) {
+            for (int n : cpuListenFds_) {
+                close(n);
+            }
+            cpuListenFds_.clear();
+            return false;
+        }
+        // hint for the listener lookup, the CBPF decides if attached
+        Socket::setIncomingCpu(fd, i % cpuNum);
+        cpuListenFds_.push_back(fd);
+    }
+
+    // without it the group still works, by hash
+    if (!Socket::attachReuseportCpuBpf(cpuListenFds_[0], workerNum_)) {
+        LOG(Warn, "attach reuseport cpu bpf failed, fallback to hash");
+    }
+    LOG(Info, "cpu steering on, listenfds:%d", workerNum_);
+    return true;
+}
+
 bool Server::listenOnAddress(int family, const char* ip, uint16_t port, 
-                             int& listenfd) {
+                             bool reusePort, int& listenfd) {
     int fd = socket(family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOG(Error, "socket failed, err:%s", strerror(errno));
+        return false;
+    }
 
     int optval = 1;
     setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
-    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval));
+    if (reusePort) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval));
+    }
 
     if (AF_INET == family) {
         struct sockaddr_in sa = {};
@@ -106,6 +339,7 @@ bool Server::listenOnAddress(int family, const char* ip, uint16_t port,
 
         if (::bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0) {
             LOG(Error, "IPv4 bind failed. fd:%d,err:%s", fd, strerror(errno));
+            close(fd);
             return false;
         }
     } else if (family == AF_INET6) {
@@ -116,15 +350,24 @@ bool Server::listenOnAddress(int family, const char* ip, uint16_t port,
 
         if (::bind(fd, (struct sockaddr*)&sa6, sizeof(sa6)) < 0) {
             LOG(Error, "IPv6 bind failed. fd:%d,err:%s", fd, strerror(errno));
+            close(fd);
             return false;
         }
     } else {
         LOG(Error, "unknown family:%d", family);
+        close(fd);
         return false;
     }
 
-    if (::listen(fd, 5) < 0) {
+    const AcceptOption& accept = opt_.acceptOption_;
+    if (accept.deferAcceptSec_ > 0) {
+        // workers wake up for conns with a request to read only
+        Socket::setDeferAccept(fd, accept.deferAcceptSec_);
+    }
+
+    if (::listen(fd, accept.backlog_) < 0) {
         LOG(Error, "listen failed. fd:%d,err:%s", fd, strerror(errno));
+        close(fd);
         return false;
     }
 
@@ -134,11 +377,18 @@ bool Server::listenOnAddress(int family, const char* ip, uint16_t port,
 }
 
 void Server::run() {
-    if (isWorker()) {
-        workerRun();
-    } else {
+    if (!isWorker()) {
         watcherRun();
+        if (!isWorker()) {
+            return;
+        }
+        // forked by spawnWorker() after the watcher's loop, drop its poller
+        delete poller_;
+        poller_ = NULL;
+        close(sig_pipefd[0]);
+        close(sig_pipefd[1]);
     }
+    workerRun();
 }
 
 static void sigHandler(int signo) {
@@ -175,8 +425,81 @@ void Server::watcherRun() {
             std::placeholders::_2, std::placeholders::_3), this); 
     poller_->addFd(sig_pipefd[0], EV_READ);
 
+    if (ACCEPT_STRATEGY_WATCHER == opt_.acceptOption_.strategy_ &&
+            listenfd_ >= 0) {
+        for (int n = 0; n < workerNum_; n++) {
+            if (workerList_[n].pid > 0) {
+                Util::set_fl(workerList_[n].pipefd[1], O_NONBLOCK);
+            }
+        }
+        poller_->setFdReadCallback(listenfd_,
+            std::bind(&Server::onWatcherAccept, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3), this);
+        isListening_ = poller_->addFd(listenfd_, EV_READ);
+        poller_->addLoopHook(LOOP_HOOK_BEFORE_POLL,
+            std::bind(&Server::onWatcherBeforePoll, this));
+    }
+
+    const WorkerStatsOption& workerStats = opt_.workerStatsOption_;
+    if (workerStats.enable_ && workerStats.dumpIntervalMs_ > 0) {
+        poller_->addTimer(workerStats.dumpIntervalMs_, true,
+            std::bind(&Server::dumpWorkerStats, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3), this);
+    }
+
+    if (opt_.migrateOption_.enable_) {
+        // workers send back the conns they give away
+        for (int n = 0; n < workerNum_; n++) {
+            if (workerList_[n].pid <= 0) {
+                continue;
+            }
+            Util::set_fl(workerList_[n].pipefd[1], O_NONBLOCK);
+            poller_->setFdReadCallback(workerList_[n].pipefd[1],
+                std::bind(&Server::onPipeFdOfWatcher, this,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3), this);
+            poller_->addFd(workerList_[n].pipefd[1], EV_READ);
+        }
+        workerReqNums_.assign(workerNum_, 0);
+        poller_->addTimer(opt_.migrateOption_.intervalMs_, true,
+            std::bind(&Server::rebalanceWorkers, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3), this);
+    }
+
+    if (opt_.scaleOption_.enable_) {
+        scaleSamples_.resize(workerNum_);
+        poller_->addTimer(opt_.scaleOption_.intervalMs_, true,
+            std::bind(&Server::autoScale, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3), this);
+    }
+
+    if (isTakingOver_) {
+        // the old server drains once all our workers accept
+        poller_->addLoopHook(LOOP_HOOK_BEFORE_POLL,
+            std::bind(&Server::checkTakeoverDone, this));
+    } else if (opt_.hotRestartOption_.enable_) {
+        listenHotRestart();
+    }
+
     poller_->setTimeout(50);
-    poller_->runLoop();
+    while (true) {
+        poller_->runLoop();
+        // the loop also ends once all workers exited, then none is added
+        bool hasWorker = false;
+        for (int n = 0; n < workerNum_; n++) {
+            hasWorker = hasWorker || workerList_[n].pid > 0;
+        }
+        if (!isSpawnPending_ || !hasWorker) {
+            break;
+        }
+        // autoScale stopped the loop: fork here, not from its timer, so the
+        // child carries no half run loop iteration
+        isSpawnPending_ = false;
+        spawnWorker();
+        if (isWorker()) {
+            return;
+        }
+    }
 }
 
 void Server::workerRun() {
@@ -186,8 +509,16 @@ void Server::workerRun() {
     prctl(PR_SET_NAME, (unsigned long)workerName, 0, 0, 0);
     LOG(Info, "worker pid:%d", getpid());
 
+    // before any allocation of the worker
+    bindWorkerCpu();
+
     poller_ = new Poller(opt_.commonOption_.maxConnNum_);
     assert(poller_);
+    // 32KB of zeroed buffers per conn: touched by this worker only, and no
+    // more than its peak conns
+    connPool_ = new ObjectPool<ServerConnection>(std::min<uint32_t>(
+        CONN_POOL_WARMUP, opt_.commonOption_.maxConnNum_));
+    assert(connPool_);
     
     Util::registerSignal(SIGTERM, sigHandler);
     
@@ -202,26 +533,20 @@ void Server::workerRun() {
     Util::set_fl(sig_pipefd[0], O_NONBLOCK);
     Util::set_fl(workerList_[workerIndex_].pipefd[0], O_NONBLOCK);
 
-    const char *ip = opt_.serviceAddrOption_.ip_.c_str();
-    uint16_t port = opt_.serviceAddrOption_.port_;
-    int family = opt_.serviceAddrOption_.isIPv6_ ? AF_INET6 : AF_INET;
-    int listenfd = -1;
-    if (!listenOnAddress(family, ip, port, listenfd)) {
-        LOG(Error, "listenOnAddress failed, ip:%s, port:%d", ip, port);
+    // ACCEPT_STRATEGY_REUSEPORT: every worker listens on its own
+    if (listenfd_ < 0 && (ACCEPT_STRATEGY_REUSEPORT !=
+            opt_.acceptOption_.strategy_ || !listen())) {
+        LOG(Error, "no listenfd, accept strategy:%d",
+            opt_.acceptOption_.strategy_);
         return;
     }
-    listenfd_ = listenfd;
-    LOG(Info, "listenfd:%d", listenfd_);
 
     poller_->setFdReadCallback(sig_pipefd[0],
         std::bind(&Server::onSigPipeFdOfWorker, this, std::placeholders::_1, 
             std::placeholders::_2, std::placeholders::_3), this);
     poller_->addFd(sig_pipefd[0], EV_READ);
 
-    poller_->setFdReadCallback(listenfd_,
-        std::bind(&Server::onAccept, this, std::placeholders::_1, 
-            std::placeholders::_2, std::placeholders::_3), this);
-    poller_->addFd(listenfd_, EV_READ/*|EV_EXCLUSIVE*/);
+    registerListenFd();
 
     poller_->setFdReadCallback(workerList_[workerIndex_].pipefd[0],
         std::bind(&Server::onPipeFdOfWorker, this, std::placeholders::_1, 
@@ -232,8 +557,276 @@ void Server::workerRun() {
         std::bind(&Server::checkIdleConnections, this, std::placeholders::_1,
             std::placeholders::_2, std::placeholders::_3), this);
 
-    poller_->setTimeout(10);
+    rspQueue_ = new ResponseQueue();
+    if (!rspQueue_->init(poller_, std::bind(&Server::onPendingResponse, this,
+            std::placeholders::_1))) {
+        LOG(Error, "ResponseQueue init failed");
+        return;
+    }
+
+    // threads are started after fork, in the worker
+    if (!poolUris_.empty()) {
+        handlerPool_ = new HandlerPool(opt_.handlerPoolOption_.threadNum_);
+        for (uint32_t uri : poolUris_) {
+            handlerPool_->addUri(uri);
+        }
+        handlerPool_->start();
+
+        if (opt_.handlerPoolOption_.statsIntervalMs_ > 0) {
+            poller_->addTimer(opt_.handlerPoolOption_.statsIntervalMs_, true,
+                std::bind(&Server::dumpHandlerPoolStats, this,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3), this);
+        }
+    }
+
+    // requests of batchUris_ wait for the end of the fired events
+    if (!batchUris_.empty()) {
+        batchQueue_ = new BatchQueue(rspQueue_);
+        poller_->addLoopHook(LOOP_HOOK_AFTER_EVENTS, [this]() {
+            if (!batchQueue_->empty()) {
+                batchQueue_->flush();
+            }
+        });
+    }
+
+    HandlerContext context;
+    context.rspQueue = rspQueue_;
+    context.handlerPool = handlerPool_;
+    context.batchQueue = batchQueue_;
+    if (!uriLimiter_->empty()) {
+        uriLimiter_->setConnFinder([this](int fd, uint64_t connId) {
+            auto it = connMap_.find(fd);
+            return it != connMap_.end() && it->second &&
+                it->second->getId() == connId ? it->second.get() : nullptr;
+        });
+        context.uriLimiter = uriLimiter_;
+        // slots given back by responders, woken up by their responses
+        poller_->addLoopHook(LOOP_HOOK_BEFORE_POLL, [this]() {
+            uriLimiter_->pumpReleased();
+        });
+    }
+    codec_->setHandlerContext(context);
+
+    const AdmissionOption& admission = opt_.admissionOption_;
+    if (admission.enable_) {
+        codel_ = new CoDel(admission.targetUs_, admission.intervalMs_ * 1000);
+        codec_->setAdmission(codel_);
+    }
+    if (rateLimiter_.isCreated()) {
+        codec_->setRateLimiter(&rateLimiter_);
+    }
+    if (!responseCache_->empty()) {
+        codec_->setResponseCache(responseCache_);
+    }
+
+    if (opt_.workerStatsOption_.enable_ || opt_.scaleOption_.enable_) {
+        poller_->enableClock();
+    }
+    if (load_) {
+        poller_->addLoopHook(LOOP_HOOK_AFTER_EVENTS, [this]() {
+            load_->inflight.store(rspQueue_->getInflight(),
+                std::memory_order_relaxed);
+            load_->reqNum.store(reqNum_, std::memory_order_relaxed);
+            load_->bytesIn.store(ioCounters_.bytesIn,
+                std::memory_order_relaxed);
+            load_->bytesOut.store(ioCounters_.bytesOut,
+                std::memory_order_relaxed);
+            if (poller_->isClockOn()) {
+                load_->busyUs.store(poller_->getBusyUs(),
+                    std::memory_order_relaxed);
+            }
+            if (isAcceptPaused_) {
+                load_->acceptPausedUs.store(getAcceptPausedUs(),
+                    std::memory_order_relaxed);
+            }
+        });
+    }
+
+    const LoopStatsOption& loopStats = opt_.loopStatsOption_;
+    if (loopStats.enable_) {
+        poller_->enableStats(loopStats.slowCallbackUs_,
+            std::bind(&Server::onSlowCallback, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3));
+        if (loopStats.dumpIntervalMs_ > 0) {
+            poller_->addTimer(loopStats.dumpIntervalMs_, true,
+                std::bind(&Server::dumpLoopStats, this,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3), this);
+        }
+    }
+
+    if (opt_.migrateOption_.enable_) {
+        poller_->addTimer(opt_.migrateOption_.intervalMs_, true,
+            std::bind(&Server::rollReqWindow, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3), this);
+    }
+
+    if (cpu_ >= 0 && opt_.acceptOption_.steeringStatsMs_ > 0) {
+        poller_->addTimer(opt_.acceptOption_.steeringStatsMs_, true,
+            std::bind(&Server::reportCpuSteering, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3), this);
+    }
+
+    poller_->setTimeout(ACCEPT_STRATEGY_SEMLOCK == opt_.acceptOption_.strategy_
+        ? opt_.acceptOption_.lockRetryMs_ : 10);
+    if (opt_.busyPollOption_.enable_) {
+        poller_->setBusyPoll(opt_.busyPollOption_.spinIdleUs_);
+        LOG(Info, "busy poll on, spinIdleUs:%u, sockBusyPollUs:%d",
+            opt_.busyPollOption_.spinIdleUs_,
+            opt_.busyPollOption_.sockBusyPollUs_);
+    }
+    if (load_) {
+        load_->ready.store(1, std::memory_order_relaxed);
+    }
     poller_->runLoop();
+
+    if (handlerPool_) {
+        handlerPool_->stop();
+    }
+}
+
+void Server::registerListenFd() {
+    poller_->setFdReadCallback(listenfd_,
+        std::bind(&Server::onAccept, this, std::placeholders::_1, 
+            std::placeholders::_2, std::placeholders::_3), this);
+
+    switch (opt_.acceptOption_.strategy_) {
+        case ACCEPT_STRATEGY_WATCHER:
+            // conns come from the watcher through the pipe
+            close(listenfd_);
+            listenfd_ = -1;
+            break;
+        case ACCEPT_STRATEGY_SEMLOCK:
+            // listenfd_ is added by the lock holder, the lock is released
+            // after the fired events(accepts) of each loop are handled
+            poller_->addLoopHook(LOOP_HOOK_BEFORE_POLL,
+                std::bind(&Server::tryAcceptLock, this));
+            poller_->addLoopHook(LOOP_HOOK_AFTER_EVENTS, [this]() {
+                acceptLock_.unlock();
+            });
+            break;
+        default:
+            watchListenFd();
+            break;
+    }
+}
+
+bool Server::watchListenFd() {
+    int events = EV_READ;
+    if (ACCEPT_STRATEGY_EXCLUSIVE == opt_.acceptOption_.strategy_) {
+        // only one of the workers blocked in epoll_wait is woken up
+        events |= EV_EXCLUSIVE;
+    }
+    isListening_ = poller_->addFd(listenfd_, events);
+    return isListening_;
+}
+
+void Server::updateAcceptThrottle() {
+    if (!isWorker() || 0 == pauseConnNum_) {
+        return;
+    }
+
+    const AcceptStrategy strategy = opt_.acceptOption_.strategy_;
+    size_t conns = connMap_.size();
+    if (!isAcceptPaused_ && conns >= pauseConnNum_) {
+        isAcceptPaused_ = true;
+        pauseBeginUs_ = Poller::getMonotonicMicros();
+        // SEMLOCK: tryAcceptLock() does not compete while paused.
+        // WATCHER: the watcher skips paused workers
+        if (isListening_) {
+            poller_->delFd(listenfd_);
+            isListening_ = false;
+        }
+        if (load_) {
+            load_->acceptPaused.store(1, std::memory_order_relaxed);
+        }
+        LOG(Warn, "accept paused, conns:%zu,high watermark:%zu", conns,
+            pauseConnNum_);
+    } else if (isAcceptPaused_ && conns <= resumeConnNum_) {
+        isAcceptPaused_ = false;
+        acceptPausedUs_ += Poller::getMonotonicMicros() - pauseBeginUs_;
+        if (!isListening_ && listenfd_ >= 0 &&
+                ACCEPT_STRATEGY_SEMLOCK != strategy) {
+            watchListenFd();
+        }
+        if (load_) {
+            load_->acceptPausedUs.store(acceptPausedUs_,
+                std::memory_order_relaxed);
+            // a draining worker takes no conns anyway
+            load_->acceptPaused.store(isDraining_ ? 1 : 0,
+                std::memory_order_relaxed);
+        }
+        LOG(Info, "accept resumed, conns:%zu,low watermark:%zu,pausedUs:%lu",
+            conns, resumeConnNum_, (unsigned long)acceptPausedUs_);
+    }
+}
+
+uint64_t Server::getAcceptPausedUs() const {
+    if (isAcceptPaused_) {
+        return acceptPausedUs_ + (Poller::getMonotonicMicros() - pauseBeginUs_);
+    }
+    return acceptPausedUs_;
+}
+
+int Server::pickWorkerCpu() const {
+    const CommonOption& common = opt_.commonOption_;
+    if (CPU_AFFINITY_LIST == common.cpuAffinity_) {
+        if (common.cpuList_.empty()) {
+            LOG(Error, "CPU_AFFINITY_LIST with empty cpuList_");
+            return -1;
+        }
+        return common.cpuList_[workerIndex_ % common.cpuList_.size()];
+    }
+
+    std::vector<int> cpus;
+    if (CPU_AFFINITY_AUTO == common.cpuAffinity_ &&
+            Util::getAllowedCpus(cpus)) {
+        return cpus[workerIndex_ % cpus.size()];
+    }
+    return -1;
+}
+
+void Server::bindWorkerCpu() {
+    // cpu_ is set already by cpu steering
+    if (cpu_ < 0) {
+        cpu_ = pickWorkerCpu();
+    }
+    if (cpu_ < 0) {
+        return;
+    }
+
+    if (!Util::setCpuAffinity(cpu_)) {
+        cpu_ = -1;
+        return;
+    }
+
+    int node = Util::getCpuNode(cpu_);
+    if (opt_.commonOption_.numaBind_ && node >= 0 &&
+            Util::bindMemoryToNode(node)) {
+        LOG(Info, "worker:%d pinned to cpu:%d, memory bound to node:%d",
+            workerIndex_, cpu_, node);
+    } else {
+        LOG(Info, "worker:%d pinned to cpu:%d, node:%d", workerIndex_, cpu_,
+            node);
+    }
+}
+
+void Server::tryAcceptLock() {
+    if (isDraining_) {
+        return;
+    }
+
+    // like nginx: near the conn limit leave new conns to other workers
+    if (!isAcceptPaused_ && acceptLock_.tryLock()) {
+        if (!isListening_) {
+            isListening_ = poller_->addFd(listenfd_, EV_READ);
+        }
+    } else if (isListening_) {
+        // keep the fd while re-locking, drop it only when others hold it
+        poller_->delFd(listenfd_);
+        isListening_ = false;
+    }
 }
 
 void Server::onSigPipeFdOfWatcher(int fd, int events, void* arg) {
@@ -247,17 +840,25 @@ void Server::onSigPipeFdOfWatcher(int fd, int events, void* arg) {
             case SIGCHLD:
                 // SIGCHLD 信号处理函数是阻塞的，如果同时触发多个 SIGCHLD 的话，
                 // SIGCHLD信号不会排队，只调用一次信号处理函数
+                // 所以一次回收所有已退出的子进程
                 pid_t ret_pid;
-                while (-1 == (ret_pid = waitpid(-1, NULL, WNOHANG))) {
-                    continue;
-                }
-
-                for (int n = 0; n < workerNum_; n++) {
-                    if (ret_pid == workerList_[n].pid) {
-                        workerList_[n].pid = -1;
-                        close(workerList_[n].pipefd[1]);
-                        LOG(Info, "watcher catch SIGCHLD, worker pid:%d exit!",
-                             ret_pid);
+                while ((ret_pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+                    for (int n = 0; n < workerNum_; n++) {
+                        if (ret_pid == workerList_[n].pid) {
+                            workerList_[n].pid = -1;
+                            if (loadTable_.at(n)) {
+                                loadTable_.at(n)->reset();
+                            }
+                            if (poller_->hasEvent(workerList_[n].pipefd[1],
+                                                  EV_READ)) {
+                                poller_->delFd(workerList_[n].pipefd[1]);
+                            }
+                            close(workerList_[n].pipefd[1]);
+                            workerList_[n].pipefd[1] = -1;
+                            workerList_[n].isRetiring = false;
+                            LOG(Info, "watcher catch SIGCHLD, worker pid:%d "
+                                "exit!", ret_pid);
+                        }
                     }
                 }
                 break;
@@ -271,9 +872,8 @@ void Server::onSigPipeFdOfWatcher(int fd, int events, void* arg) {
                             "so kill worker pid:%d", workerList_[n].pid);
                     }
                 }
-                            
-                // 父进程退出runLoop
-                poller_->stop();
+
+                // 父进程在所有子进程退出后退出runLoop(见下), 端口随之释放
                 break;
             default:
                 break;
@@ -299,6 +899,7 @@ void Server::onSigPipeFdOfWorker(int fd, int events, void* arg) {
 
     for (int n = 0; n < rlen; n++) {
         switch (buf[n]) {
+            case SIGTERM:
             case SIGINT:
                 LOG(Info, "worker pid:%d catch SIGTERM or SIGINT", getpid());
                 poller_->stop();
@@ -314,42 +915,193 @@ void Server::onPipeFdOfWorker(int fd, int events, void* arg) {
         LOG(Error, "not EV_READ, fd:%d,events:%0x", fd, events);
         return;
     }
+
+    while (true) {
+        PipeMsg msg;
+        int passFd = -1;
+        int ret = PipeChannel::recv(fd, msg, passFd);
+        if (0 == ret) {
+            return;
+        } else if (ret < 0) {
+            LOG(Error, "pipe to watcher closed, fd:%d", fd);
+            poller_->delFd(fd);
+            return;
+        }
+
+        switch (msg.type) {
+            case PIPE_MSG_NEW_CONN:
+                // counted by the watcher already
+                if (passFd >= 0) {
+                    addConnection(passFd, msg.addr, true);
+                }
+                break;
+            case PIPE_MSG_DRAIN:
+                startDrain();
+                break;
+            case PIPE_MSG_MIGRATE_REQ:
+                migrateConns(msg.worker, msg.reqNum);
+                break;
+            default:
+                LOG(Error, "unknown pipe msg type:%u", msg.type);
+                if (passFd >= 0) {
+                    close(passFd);
+                }
+                break;
+        }
+    }
 }
 
 void Server::onAccept(int fd, int events, void* arg) {
     LOG(Debug, "fd:%d,events:%d", fd, events);
 
-    struct sockaddr_storage clientAddr;
-    socklen_t addrLen = sizeof(clientAddr);
+    // drain the backlog, bounded so that a storm does not starve the conns
+    for (uint32_t n = 0; n < opt_.acceptOption_.acceptBatch_; n++) {
+        struct sockaddr_storage clientAddr;
+        socklen_t addrLen = sizeof(clientAddr);
 
-    int acceptfd = accept(fd, (struct sockaddr*)&clientAddr, &addrLen);
-    if (acceptfd < 0) {
-        if (EINTR == errno || EAGAIN == errno /*|| EWOULDBLOCk == errno*/) {
-            return; 
-        } else {
-            LOG(Error, "accept failed! err:%s", strerror(errno));
+        int acceptfd = Socket::accept(fd, clientAddr, addrLen);
+        if (acceptfd < 0) {
+            if (EAGAIN != errno /*|| EWOULDBLOCk == errno*/) {
+                LOG(Error, "accept failed! err:%s", strerror(errno));
+            }
+            return;
+        }
+
+        addConnection(acceptfd, clientAddr, false);
+        // paused by accept throttling
+        if (!isListening_) {
             return;
         }
     }
+}
+
+void Server::onWatcherBeforePoll() {
+    // resume once a worker is below its low watermark again
+    if (!isListening_ && listenfd_ >= 0 &&
+            loadTable_.pickLeastLoaded([this](int n) {
+            return workerList_[n].pid > 0; }) >= 0) {
+        isListening_ = poller_->addFd(listenfd_, EV_READ);
+        LOG(Info, "watcher accept resumed");
+    }
+}
+
+void Server::onWatcherAccept(int fd, int events, void* arg) {
+    for (uint32_t i = 0; i < opt_.acceptOption_.acceptBatch_; i++) {
+        int index = loadTable_.pickLeastLoaded([this](int n) {
+            return workerList_[n].pid > 0;
+        });
+        WorkerLoad* load = loadTable_.at(index);
+        if (!load) {
+            // all paused(or dead), leave conns in the backlog
+            poller_->delFd(fd);
+            isListening_ = false;
+            LOG(Warn, "no worker takes conns, watcher accept paused");
+            return;
+        }
+
+        PipeMsg msg;
+        msg.type = PIPE_MSG_NEW_CONN;
+        socklen_t addrLen = sizeof(msg.addr);
 
+        // O_NONBLOCK is shared with the worker's copy
+        int acceptfd = Socket::accept(fd, msg.addr, addrLen);
+        if (acceptfd < 0) {
+            if (EAGAIN != errno) {
+                LOG(Error, "accept failed! err:%s", strerror(errno));
+            }
+            return;
+        }
+        msg.addrLen = addrLen;
+
+        // a full pipe(EAGAIN) of a worker behind on its messages: the
+        // next least loaded one is tried
+        const int MAX_TRIES = 4;
+        int tried[MAX_TRIES];
+        int triedNum = 0;
+        bool isPassed = false;
+        while (load) {
+            // count it now, the next accept must see it before the worker
+            // does
+            load->connNum.fetch_add(1, std::memory_order_relaxed);
+            if (PipeChannel::send(workerList_[index].pipefd[1], msg,
+                                  acceptfd)) {
+                isPassed = true;
+                break;
+            }
+            LOG(Warn, "pass acceptfd:%d to worker:%d failed, err:%s",
+                acceptfd, index, strerror(errno));
+            load->connNum.fetch_sub(1, std::memory_order_relaxed);
+            tried[triedNum++] = index;
+            if (triedNum == MAX_TRIES) {
+                break;
+            }
+            index = loadTable_.pickLeastLoaded([&](int n) {
+                return workerList_[n].pid > 0 &&
+                    std::find(tried, tried + triedNum, n) == tried + triedNum;
+            });
+            load = loadTable_.at(index);
+        }
+        if (!isPassed) {
+            acceptDroppedNum_++;
+            LOG(Error, "no worker took acceptfd:%d, dropped:%lu", acceptfd,
+                (unsigned long)acceptDroppedNum_);
+        }
+        // the worker holds its own copy
+        close(acceptfd);
+    }
+}
+
+bool Server::addConnection(int acceptfd,
+                           const struct sockaddr_storage& clientAddr,
+                           bool isCounted) {
     // limit acceptfd <= maxfd_, EventItemList in poller is array that index is fd
     if (unlikely(acceptfd > maxfd_)) {
         LOG(Warn, "too many conn, fd:%d, limited maxfd:%d", acceptfd, maxfd_);
         close(acceptfd);
-        return;
+        if (isCounted && load_) {
+            load_->connNum.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return false;
     }
 
-    Util::set_fl(acceptfd, O_NONBLOCK);
+    if (cpu_ >= 0) {
+        // cpu of the last received packet(the handshake ACK)
+        int rxCpu = Socket::getIncomingCpu(acceptfd);
+        steeredConnNum_++;
+        if (rxCpu >= 0 && rxCpu != cpu_) {
+            rxCpuMismatchNum_++;
+            LOG(Debug, "acceptfd:%d,rx cpu:%d,worker cpu:%d", acceptfd,
+                rxCpu, cpu_);
+        }
+    }
+
+    const BusyPollOption& busyPoll = opt_.busyPollOption_;
+    if (busyPoll.enable_ && busyPoll.sockBusyPollUs_ > 0) {
+        Socket::setBusyPoll(acceptfd, busyPoll.sockBusyPollUs_,
+                            busyPoll.preferBusyPoll_);
+    }
 
-    auto conn = connPool_.get();
+    auto conn = connPool_->get();
     if (!conn) {
         close(acceptfd);
         LOG(Error, "connPool_ get failed, acceptfd:%d", acceptfd);
-        return;
+        if (isCounted && load_) {
+            load_->connNum.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return false;
     }
     conn->setFd(acceptfd);
+    conn->setId(++connIdSeq_);
+    if (codel_) {
+        conn->enableRxTimestamp();
+    }
+    conn->resetReqWindow();
+    conn->setIoCounters(&ioCounters_);
     conn->setStatus(CONN_STATUS_OK);
     conn->updateLastActiveTime(time(nullptr));
+    if (!isCounted && load_) {
+        load_->connNum.fetch_add(1, std::memory_order_relaxed);
+    }
 
     AddrInfo *addr = conn->getRemoteAddr();
     if (clientAddr.ss_family == AF_INET) {
@@ -369,29 +1121,33 @@ void Server::onAccept(int fd, int events, void* arg) {
     }
 
     connMap_[acceptfd] = conn;
+    updateAcceptThrottle();
 
-    poller_->setFdReadCallback(acceptfd, 
-        [this, fd = acceptfd](int fd, int events, void* arg) {
-            onRead(fd, events, connMap_[fd]);
-        }, 
-        nullptr);
-    poller_->setFdWriteCallback(acceptfd, 
-        [this, fd = acceptfd](int fd, int events, void* arg) {
-            onWrite(fd, events, connMap_[fd]);
-        }, 
-        nullptr);
-        
-    poller_->addFd(acceptfd, EV_READ);
+    // events of acceptfd go straight to conn, see ServerConnection
+    conn->setServer(this);
+    poller_->addHandler(acceptfd, conn.get(), EV_READ);
         
     LOG(Info, "acceptfd:%d,remote ip:%s,port:%u", 
         acceptfd, addr->ip, addr->port);
+    return true;
+}
+
+void ServerConnection::handleRead(int fd, int events) {
+    server_->onRead(fd, events, this);
 }
 
-void Server::onRead(int fd, int events, const std::shared_ptr<Connection>& conn) {
+void ServerConnection::handleWrite(int fd, int events) {
+    server_->onWrite(fd, events, this);
+}
+
+void Server::onRead(int fd, int events, Connection* conn) {
     bool isUpdate = false;
 
     if (conn->tcpRecv()) {
-        if (!codec_->processMessage(conn.get())) {
+        uint64_t reqNum = conn->getReqNum();
+        bool isOk = codec_->processMessage(conn);
+        reqNum_ += conn->getReqNum() - reqNum;
+        if (!isOk) {
             LOG(Error, "processMessage pack fail or protocolType err,"
                 "delFd fd:%d,client ip:%s,port:%u",
                 fd, conn->getRemoteAddr()->ip, conn->getRemoteAddr()->port);
@@ -404,11 +1160,11 @@ void Server::onRead(int fd, int events, const std::shared_ptr<Connection>& conn)
     if (conn->hasPendingRsp()) {
         conn->tcpSend();
         if (conn->hasPendingRsp()) {
-            if (!(events & EV_WRITE)) {
+            if (!poller_->hasEvent(fd, EV_WRITE)) {
                 poller_->addEvent(fd, EV_WRITE);
             } 
         } else {
-            if (events & EV_WRITE) {
+            if (poller_->hasEvent(fd, EV_WRITE)) {
                 poller_->delEvent(fd, EV_WRITE);
             }
         }
@@ -427,12 +1183,13 @@ void Server::onRead(int fd, int events, const std::shared_ptr<Connection>& conn)
     }
 }
 
-void Server::onWrite(int fd, int events, const std::shared_ptr<Connection>& conn) {
+void Server::onWrite(int fd, int events, Connection* conn) {
     if (conn->hasPendingRsp()) {
         if (!conn->tcpSend()) {
             LOG(Error, "tcpSend err, delFd fd:%d,client ip:%s,port:%u",
                 fd, conn->getRemoteAddr()->ip, conn->getRemoteAddr()->port);
             clearConnAndEraseFromConnMap(conn);
+            return;
         }
 
         if (!conn->hasPendingRsp()) {
@@ -456,7 +1213,7 @@ void Server::checkIdleConnections(int fd, int events, void* arg) {
     auto it = connMap_.begin();
     while (it != connMap_.end()) {
         int fd = it->first;
-        std::shared_ptr<Connection>& conn = it->second;
+        auto& conn = it->second;
         if (!conn || conn->getStatus() != CONN_STATUS_OK) {
             ++it;
             continue;
@@ -483,9 +1240,679 @@ void Server::checkIdleConnections(int fd, int events, void* arg) {
 
             // no pending data, close the connection
             shutdown(conn->getFd(), SHUT_WR);
-            it = clearConnAndEraseFromConnMap(conn);
+            it = clearConnAndEraseFromConnMap(conn.get());
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Server::onPendingResponse(PendingResponse& rsp) {
+    auto it = connMap_.find(rsp.fd);
+    if (it == connMap_.end() || !it->second 
+            || it->second->getId() != rsp.connId) {
+        LOG(Warn, "conn closed, drop response. fd:%d,rspUri:0x%xu",
+            rsp.fd, rsp.rspUri);
+        return;
+    }
+
+    // hold a ref, clearConnAndEraseFromConnMap() erases it from connMap_
+    std::shared_ptr<Connection> conn = it->second;
+    int fd = conn->getFd();
+    conn->subInflight();
+    if (rsp.isDropped) {
+        return;
+    }
+
+    if (!Codec::sendMessage(conn.get(), rsp.protocolType, rsp.rspUri,
+                            rsp.data, rsp.traceId)) {
+        if (conn->getStatus() == CONN_STATUS_BROKEN) {
+            LOG(Info, "sock broken! delFd fd:%d,client ip:%s,port:%u",
+                fd, conn->getRemoteAddr()->ip, conn->getRemoteAddr()->port);
+            clearConnAndEraseFromConnMap(conn.get());
+            return;
+        }
+        LOG(Error, "sendMessage fail, fd:%d,rspUri:0x%xu", fd, rsp.rspUri);
+    }
+
+    if (conn->hasPendingRsp() && !poller_->hasEvent(fd, EV_WRITE)) {
+        poller_->addEvent(fd, EV_WRITE);
+    }
+    conn->updateLastActiveTime(time(nullptr));
+}
+
+void Server::dumpHandlerPoolStats(int fd, int events, void* arg) {
+    if (handlerPool_) {
+        handlerPool_->dumpStats();
+    }
+}
+
+void Server::onSlowCallback(int fd, int events, int64_t costUs) {
+    // fd is reused by accepted conns only, others(listenfd, pipes) have no uri
+    uint32_t uri = 0;
+    auto it = fd >= 0 ? connMap_.find(fd) : connMap_.end();
+    if (it != connMap_.end() && it->second) {
+        uri = it->second->getLastUri();
+    }
+    LOG(Warn, "slow callback, fd:%d,events:%d,lastUri:0x%x,costUs:%ld",
+        fd, events, uri, (long)costUs);
+}
+
+// write a temp file then rename, readers never see a partial file
+static void dumpToFile(const char* path, const std::string& out) {
+    char tmpPath[272];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE* fp = fopen(tmpPath, "w");
+    if (!fp) {
+        LOG(Error, "open %s failed, err:%s", tmpPath, strerror(errno));
+        return;
+    }
+    fwrite(out.data(), 1, out.size(), fp);
+    fclose(fp);
+    if (rename(tmpPath, path) < 0) {
+        LOG(Error, "rename %s failed, err:%s", tmpPath, strerror(errno));
+    }
+}
+
+void Server::dumpLoopStats(int fd, int events, void* arg) {
+    const LoopStats* stats = poller_->getStats();
+    if (!stats) {
+        return;
+    }
+
+    char head[256];
+    snprintf(head, sizeof(head), "pid %d\nworker %d\nconnections %zu\n"
+        "spinning %d\ncpu %d\nsteered_conns %lu\nrx_cpu_mismatch %lu\n"
+        "accept_paused %d\naccept_paused_us %lu\n",
+        getpid(), workerIndex_, connMap_.size(), poller_->isSpinning() ? 1 : 0,
+        cpu_, (unsigned long)steeredConnNum_,
+        (unsigned long)rxCpuMismatchNum_, isAcceptPaused_ ? 1 : 0,
+        (unsigned long)getAcceptPausedUs());
+    std::string out(head);
+    stats->dump(out, Poller::getMonotonicMicros());
+    uriLimiter_->forEach([&out](uint32_t uri, const UriLimitStats& s) {
+        char line[256];
+        snprintf(line, sizeof(line), "uri_limit 0x%x concurrent %u queued %u "
+            "started %lu rejected %lu\n", uri,
+            s.concurrent.load(std::memory_order_relaxed),
+            s.queued.load(std::memory_order_relaxed),
+            (unsigned long)s.started.load(std::memory_order_relaxed),
+            (unsigned long)s.rejected.load(std::memory_order_relaxed));
+        out += line;
+    });
+    responseCache_->forEach([&out](uint32_t uri, const UriCacheStats& s) {
+        char line[256];
+        snprintf(line, sizeof(line), "cache 0x%x entries %u bytes %lu hits %lu "
+            "misses %lu evictions %lu expirations %lu\n", uri, s.entries,
+            (unsigned long)s.bytes, (unsigned long)s.hits,
+            (unsigned long)s.misses, (unsigned long)s.evictions,
+            (unsigned long)s.expirations);
+        out += line;
+    });
+    if (codel_) {
+        char line[128];
+        snprintf(line, sizeof(line), "codel congested %d times %lu "
+            "rejected %lu\n", codel_->isCongested() ? 1 : 0,
+            (unsigned long)codel_->getCongestedNum(),
+            (unsigned long)codel_->getRejectedNum());
+        out += line;
+    }
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s.%d",
+        opt_.loopStatsOption_.dumpPath_.c_str(), workerIndex_);
+    dumpToFile(path, out);
+}
+
+void Server::dumpWorkerStats(int fd, int events, void* arg) {
+    char head[64];
+    snprintf(head, sizeof(head), "pid %d\n", getpid());
+    std::string out(head);
+    loadTable_.report(loadSamples_, Poller::getMonotonicMicros(), out);
+    if (ACCEPT_STRATEGY_WATCHER == opt_.acceptOption_.strategy_) {
+        char line[64];
+        snprintf(line, sizeof(line), "accept_dropped %lu\n",
+            (unsigned long)acceptDroppedNum_);
+        out += line;
+    }
+    rateLimiter_.report(out);
+    shmCache_.report(out);
+    dumpToFile(opt_.workerStatsOption_.dumpPath_.c_str(), out);
+}
+
+void Server::reportCpuSteering(int fd, int events, void* arg) {
+    LOG(Info, "cpu steering, worker:%d,cpu:%d,conns:%lu,rxCpuMismatch:%lu"
+        "(%.1f%%)", workerIndex_, cpu_, (unsigned long)steeredConnNum_,
+        (unsigned long)rxCpuMismatchNum_, steeredConnNum_ > 0 ?
+        100.0 * rxCpuMismatchNum_ / steeredConnNum_ : 0.0);
+}
+
+std::string Server::getHotRestartPath() const {
+    const HotRestartOption& hotRestart = opt_.hotRestartOption_;
+    if (!hotRestart.path_.empty()) {
+        return hotRestart.path_;
+    }
+    return "/tmp/tinyrpc_hot_restart." +
+        std::to_string(opt_.serviceAddrOption_.port_);
+}
+
+bool Server::takeOver() {
+    std::string path = getHotRestartPath();
+    if (!hotRestart_.connect(path, 3000)) {
+        return false;
+    }
+
+    int fd = -1;
+    if (!hotRestart_.takeListenFd(fd)) {
+        hotRestart_.close();
+        return false;
+    }
+
+    if (fd >= 0) {
+        // the new config may listen elsewhere
+        struct sockaddr_storage addr;
+        socklen_t len = sizeof(addr);
+        uint16_t port = 0;
+        if (0 == getsockname(fd, (struct sockaddr*)&addr, &len)) {
+            port = ntohs(AF_INET6 == addr.ss_family
+                ? ((struct sockaddr_in6*)&addr)->sin6_port
+                : ((struct sockaddr_in*)&addr)->sin_port);
+        }
+        if (ACCEPT_STRATEGY_REUSEPORT == opt_.acceptOption_.strategy_ ||
+                port != opt_.serviceAddrOption_.port_) {
+            LOG(Warn, "listenfd of the old server is not usable, port:%u",
+                port);
+            close(fd);
+        } else {
+            Util::set_fl(fd, O_NONBLOCK);
+            listenfd_ = fd;
+        }
+    }
+    LOG(Info, "taking over from %s, listenfd:%d", path.c_str(), listenfd_);
+    return true;
+}
+
+void Server::checkTakeoverDone() {
+    if (!isTakingOver_) {
+        return;
+    }
+    for (int n = 0; n < workerNum_; n++) {
+        WorkerLoad* load = loadTable_.at(n);
+        if (workerList_[n].pid > 0 && load &&
+                !load->ready.load(std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    // the old server stops accepting and drains
+    if (!hotRestart_.sendDone()) {
+        LOG(Error, "send take over done failed");
+    }
+    isTakingOver_ = false;
+    LOG(Info, "take over done");
+    listenHotRestart();
+}
+
+void Server::listenHotRestart() {
+    if (!hotRestart_.listen(getHotRestartPath())) {
+        return;
+    }
+    poller_->setFdReadCallback(hotRestart_.getFd(),
+        std::bind(&Server::onHotRestartAccept, this, std::placeholders::_1,
+            std::placeholders::_2, std::placeholders::_3), this);
+    poller_->addFd(hotRestart_.getFd(), EV_READ);
+}
+
+void Server::onHotRestartAccept(int fd, int events, void* arg) {
+    int connfd = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (connfd < 0) {
+        if (EAGAIN != errno) {
+            LOG(Error, "hot restart accept failed, err:%s", strerror(errno));
+        }
+        return;
+    }
+    poller_->setFdReadCallback(connfd,
+        std::bind(&Server::onHotRestartMsg, this, std::placeholders::_1,
+            std::placeholders::_2, std::placeholders::_3), this);
+    poller_->addFd(connfd, EV_READ);
+}
+
+void Server::onHotRestartMsg(int fd, int events, void* arg) {
+    while (true) {
+        PipeMsg msg;
+        int passFd = -1;
+        int ret = PipeChannel::recv(fd, msg, passFd);
+        if (passFd >= 0) {
+            close(passFd);
+        }
+        if (0 == ret) {
+            return;
+        } else if (ret < 0) {
+            // the new server failed before DONE, keep serving
+            LOG(Warn, "hot restart conn closed, fd:%d", fd);
+            poller_->delFd(fd);
+            close(fd);
+            return;
+        }
+
+        switch (msg.type) {
+            case PIPE_MSG_TAKEOVER_REQ:
+                LOG(Info, "taken over, pass listenfd:%d", listenfd_);
+                HotRestart::replyListenFd(fd, listenfd_);
+                break;
+            case PIPE_MSG_TAKEOVER_DONE:
+                poller_->delFd(fd);
+                close(fd);
+                drainWorkers();
+                return;
+            default:
+                LOG(Error, "unknown hot restart msg type:%u", msg.type);
+                break;
+        }
+    }
+}
+
+void Server::drainWorkers() {
+    LOG(Info, "taken over, drain workers and exit");
+    isDraining_ = true;
+
+    // the path belongs to the new server now
+    if (hotRestart_.getFd() >= 0) {
+        poller_->delFd(hotRestart_.getFd());
+        hotRestart_.close();
+    }
+
+    // ACCEPT_STRATEGY_WATCHER: the new watcher accepts from the same queue
+    if (listenfd_ >= 0) {
+        if (isListening_) {
+            poller_->delFd(listenfd_);
+            isListening_ = false;
+        }
+        close(listenfd_);
+        listenfd_ = -1;
+    }
+
+    PipeMsg msg;
+    msg.type = PIPE_MSG_DRAIN;
+    for (int n = 0; n < workerNum_; n++) {
+        if (workerList_[n].pid > 0 &&
+                !PipeChannel::send(workerList_[n].pipefd[1], msg)) {
+            LOG(Error, "drain worker:%d failed, kill it", n);
+            kill(workerList_[n].pid, SIGTERM);
+        }
+    }
+    // runLoop ends when all workers exit, see onSigPipeFdOfWatcher
+}
+
+void Server::startDrain() {
+    if (isDraining_) {
+        return;
+    }
+    isDraining_ = true;
+    drainBeginTime_ = time(nullptr);
+
+    if (listenfd_ >= 0) {
+        if (isListening_) {
+            poller_->delFd(listenfd_);
+            isListening_ = false;
+        }
+        // REUSEPORT: conns queued on our own listenfd would be reset by
+        // close, take them. a shared listenfd is served by the new workers
+        if (ACCEPT_STRATEGY_REUSEPORT == opt_.acceptOption_.strategy_) {
+            struct sockaddr_storage clientAddr;
+            socklen_t addrLen = sizeof(clientAddr);
+            int acceptfd = -1;
+            while ((acceptfd = Socket::accept(listenfd_, clientAddr,
+                                              addrLen)) >= 0) {
+                addConnection(acceptfd, clientAddr, false);
+            }
+        }
+        close(listenfd_);
+        listenfd_ = -1;
+    }
+    // no more conns from the watcher or the accept lock
+    if (load_) {
+        load_->acceptPaused.store(1, std::memory_order_relaxed);
+    }
+    if (acceptLock_.isLocked()) {
+        acceptLock_.unlock();
+    }
+    LOG(Info, "worker:%d draining, conns:%zu", workerIndex_, connMap_.size());
+
+    poller_->addTimer(100, true,
+        std::bind(&Server::checkDrain, this, std::placeholders::_1,
+            std::placeholders::_2, std::placeholders::_3), this);
+    checkDrain(-1, 0, nullptr);
+}
+
+void Server::checkDrain(int fd, int events, void* arg) {
+    const HotRestartOption& hotRestart = opt_.hotRestartOption_;
+    time_t now = time(nullptr);
+    bool isTimeout = now - drainBeginTime_ >= hotRestart.drainTimeoutSec_;
+    // pool threads may still run requests of closed conns
+    bool hasInflight = rspQueue_ && rspQueue_->getInflight() > 0;
+
+    auto it = connMap_.begin();
+    while (it != connMap_.end()) {
+        auto& conn = it->second;
+        bool isIdle = isConnIdle(conn.get()) &&
+            now - conn->getLastActiveTime() >= hotRestart.drainIdleSec_;
+        if (isTimeout || isIdle) {
+            it = clearConnAndEraseFromConnMap(conn.get());
         } else {
             ++it;
         }
     }
+
+    if (connMap_.empty() && (!hasInflight || isTimeout)) {
+        LOG(Info, "worker:%d drained, exit", workerIndex_);
+        poller_->stop();
+    }
+}
+
+void Server::onPipeFdOfWatcher(int fd, int events, void* arg) {
+    while (true) {
+        PipeMsg msg;
+        int passFd = -1;
+        int ret = PipeChannel::recv(fd, msg, passFd);
+        if (0 == ret) {
+            return;
+        } else if (ret < 0) {
+            // the worker exited, fd is closed on SIGCHLD
+            poller_->delFd(fd);
+            return;
+        }
+
+        if (PIPE_MSG_MIGRATE_CONN != msg.type || passFd < 0) {
+            LOG(Error, "unexpected pipe msg type:%u from worker", msg.type);
+            if (passFd >= 0) {
+                close(passFd);
+            }
+            continue;
+        }
+
+        // the target may be gone or paused since the request
+        int index = msg.worker;
+        WorkerLoad* load = loadTable_.at(index);
+        if (!load || workerList_[index].pid <= 0 ||
+                load->acceptPaused.load(std::memory_order_relaxed)) {
+            index = loadTable_.pickLeastLoaded([this](int n) {
+                return workerList_[n].pid > 0;
+            });
+            load = loadTable_.at(index);
+        }
+
+        msg.type = PIPE_MSG_NEW_CONN;
+        if (!load) {
+            LOG(Error, "no worker takes migrated fd:%d, closed", passFd);
+        } else {
+            load->connNum.fetch_add(1, std::memory_order_relaxed);
+            if (!PipeChannel::send(workerList_[index].pipefd[1], msg,
+                                   passFd)) {
+                LOG(Error, "pass migrated fd:%d to worker:%d failed",
+                    passFd, index);
+                load->connNum.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        close(passFd);
+    }
+}
+
+void Server::rebalanceWorkers(int fd, int events, void* arg) {
+    const MigrateOption& migrate = opt_.migrateOption_;
+
+    int hot = -1;
+    int cold = -1;
+    uint64_t hotReqNum = 0;
+    uint64_t coldReqNum = 0;
+    uint64_t totalReqNum = 0;
+    int aliveNum = 0;
+    for (int n = 0; n < workerNum_; n++) {
+        WorkerLoad* load = loadTable_.at(n);
+        if (!load) {
+            return;
+        }
+        // requests of the last interval, a new worker starts from 0
+        uint64_t total = load->reqNum.load(std::memory_order_relaxed);
+        uint64_t reqNum = total >= workerReqNums_[n] ?
+            total - workerReqNums_[n] : total;
+        workerReqNums_[n] = total;
+
+        if (workerList_[n].pid <= 0 ||
+                !load->ready.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        aliveNum++;
+        totalReqNum += reqNum;
+        if (hot < 0 || reqNum > hotReqNum) {
+            hot = n;
+            hotReqNum = reqNum;
+        }
+        if (!load->acceptPaused.load(std::memory_order_relaxed) &&
+                (cold < 0 || reqNum < coldReqNum)) {
+            cold = n;
+            coldReqNum = reqNum;
+        }
+    }
+
+    if (skipNextRebalance_ || isDraining_) {
+        skipNextRebalance_ = false;
+        return;
+    }
+    if (hot < 0 || cold < 0 || hot == cold) {
+        return;
+    }
+
+    uint64_t gap = hotReqNum - coldReqNum;
+    uint64_t avg = totalReqNum / aliveNum;
+    if (gap < migrate.minReqNum_ || gap * 100 <= avg * migrate.imbalancePct_) {
+        return;
+    }
+
+    // moving half of the gap evens them out, more would swap the roles
+    PipeMsg msg;
+    msg.type = PIPE_MSG_MIGRATE_REQ;
+    msg.worker = cold;
+    msg.reqNum = (uint32_t)std::min<uint64_t>(gap / 2, UINT32_MAX);
+    if (PipeChannel::send(workerList_[hot].pipefd[1], msg)) {
+        skipNextRebalance_ = true;
+        LOG(Info, "migrate reqs:%u from worker:%d(%lu) to worker:%d(%lu)",
+            msg.reqNum, hot, hotReqNum, cold, coldReqNum);
+    }
+}
+
+void Server::rollReqWindow(int fd, int events, void* arg) {
+    for (auto& it : connMap_) {
+        it.second->rollReqWindow();
+    }
+}
+
+void Server::migrateConns(int target, uint32_t reqBudget) {
+    if (isDraining_) {
+        return;
+    }
+
+    // busiest first, conns without requests do not move load
+    std::vector<ServerConnection*> conns;
+    for (auto& it : connMap_) {
+        ServerConnection* conn = it.second.get();
+        if (conn->isOk() && conn->getRecentReqNum() > 0 && isConnIdle(conn)) {
+            conns.push_back(conn);
+        }
+    }
+    std::sort(conns.begin(), conns.end(),
+        [](const ServerConnection* a, const ServerConnection* b) {
+            return a->getRecentReqNum() > b->getRecentReqNum();
+        });
+
+    uint32_t movedNum = 0;
+    for (ServerConnection* conn : conns) {
+        if (movedNum >= opt_.migrateOption_.maxConnNum_) {
+            break;
+        }
+        uint64_t reqNum = conn->getRecentReqNum();
+        if (reqNum > reqBudget) {
+            continue;
+        }
+        if (!migrateConn(conn, target)) {
+            break;
+        }
+        reqBudget -= reqNum;
+        movedNum++;
+    }
+    LOG(Info, "worker:%d migrated conns:%u to worker:%d, idle:%zu,total:%lu",
+        workerIndex_, movedNum, target, conns.size(), migratedConnNum_);
+}
+
+bool Server::migrateConn(ServerConnection* conn, int target) {
+    int fd = conn->getFd();
+
+    PipeMsg msg;
+    msg.type = PIPE_MSG_MIGRATE_CONN;
+    msg.worker = target;
+    msg.reqNum = (uint32_t)std::min<uint64_t>(conn->getRecentReqNum(),
+                                              UINT32_MAX);
+    socklen_t addrLen = sizeof(msg.addr);
+    if (getpeername(fd, (struct sockaddr*)&msg.addr, &addrLen) < 0) {
+        LOG(Error, "getpeername failed, fd:%d,err:%s", fd, strerror(errno));
+        return false;
+    }
+    msg.addrLen = addrLen;
+
+    // an epoll item lives as long as the file, not our fd: drop it first or
+    // the events of the moved socket would still wake us up
+    poller_->delFd(fd);
+    if (!PipeChannel::send(workerList_[workerIndex_].pipefd[0], msg, fd)) {
+        poller_->addHandler(fd, conn, EV_READ);
+        return false;
+    }
+
+    LOG(Info, "migrate fd:%d,remote ip:%s,port:%u,reqs:%u to worker:%d", fd,
+        conn->getRemoteAddr()->ip, conn->getRemoteAddr()->port, msg.reqNum,
+        target);
+    migratedConnNum_++;
+    close(fd);
+    conn->reset();
+    if (load_) {
+        load_->connNum.fetch_sub(1, std::memory_order_relaxed);
+    }
+    // the last ref, conn goes back to the pool
+    connMap_.erase(fd);
+    updateAcceptThrottle();
+    return true;
+}
+
+void Server::autoScale(int fd, int events, void* arg) {
+    const ScaleOption& scale = opt_.scaleOption_;
+    if (isDraining_ || isTakingOver_) {
+        return;
+    }
+
+    // busy percent of the loops since the last round
+    int64_t nowUs = Poller::getMonotonicMicros();
+    uint32_t workerNum = 0;
+    uint32_t sampledNum = 0;
+    double busySum = 0;
+    for (int n = 0; n < workerNum_; n++) {
+        WorkerLoad* load = loadTable_.at(n);
+        WorkerLoadSample& last = scaleSamples_[n];
+        if (!load || workerList_[n].pid <= 0 || workerList_[n].isRetiring ||
+                !load->ready.load(std::memory_order_relaxed)) {
+            last.us = 0;
+            continue;
+        }
+        workerNum++;
+
+        uint64_t busyUs = load->busyUs.load(std::memory_order_relaxed);
+        if (last.us > 0 && nowUs > last.us && busyUs >= last.busyUs) {
+            busySum += (busyUs - last.busyUs) * 100.0 / (nowUs - last.us);
+            sampledNum++;
+        }
+        last.us = nowUs;
+        last.busyUs = busyUs;
+    }
+    // a new worker has no rate yet
+    if (0 == sampledNum || sampledNum < workerNum) {
+        return;
+    }
+
+    double busy = busySum / sampledNum;
+    scaleUpRounds_ = busy >= scale.upBusyPct_ ? scaleUpRounds_ + 1 : 0;
+    // the rest must stay below upBusyPct_ with the load of the retired one
+    scaleDownRounds_ = busy <= scale.downBusyPct_ && workerNum > 1 &&
+        busySum / (workerNum - 1) < scale.upBusyPct_ ?
+        scaleDownRounds_ + 1 : 0;
+
+    if (scaleUpRounds_ >= scale.upRounds_ && workerNum < scale.maxWorkerNum_) {
+        LOG(Info, "workers:%u busy:%.1f%%, scale up", workerNum, busy);
+        scaleUpRounds_ = 0;
+        isSpawnPending_ = true;
+        poller_->stop();
+    } else if (scaleDownRounds_ >= scale.downRounds_ &&
+               workerNum > scale.minWorkerNum_) {
+        LOG(Info, "workers:%u busy:%.1f%%, scale down", workerNum, busy);
+        scaleDownRounds_ = 0;
+        retireWorker();
+    }
+}
+
+bool Server::spawnWorker() {
+    int index = -1;
+    for (int n = 0; n < workerNum_; n++) {
+        if (workerList_[n].pid <= 0) {
+            index = n;
+            break;
+        }
+    }
+    WorkerLoad* load = loadTable_.at(index);
+    if (!load) {
+        return false;
+    }
+    load->reset();
+
+    pid_t pid = forkWorker(index);
+    if (pid < 0) {
+        return false;
+    } else if (0 == pid) {
+        // child: run() goes on with workerRun()
+        isTakingOver_ = false;
+        isDraining_ = false;
+        Util::registerSignal(SIGCHLD, SIG_DFL);
+        return true;
+    }
+
+    int pipefd = workerList_[index].pipefd[1];
+    if (ACCEPT_STRATEGY_WATCHER == opt_.acceptOption_.strategy_ ||
+            opt_.migrateOption_.enable_) {
+        Util::set_fl(pipefd, O_NONBLOCK);
+    }
+    if (opt_.migrateOption_.enable_) {
+        poller_->setFdReadCallback(pipefd,
+            std::bind(&Server::onPipeFdOfWatcher, this, std::placeholders::_1,
+                std::placeholders::_2, std::placeholders::_3), this);
+        poller_->addFd(pipefd, EV_READ);
+    }
+    LOG(Info, "worker:%d pid:%d spawned", index, pid);
+    return true;
+}
+
+bool Server::retireWorker() {
+    // the last one, slots fill from the front
+    for (int n = workerNum_ - 1; n >= 0; n--) {
+        if (workerList_[n].pid <= 0 || workerList_[n].isRetiring) {
+            continue;
+        }
+
+        PipeMsg msg;
+        msg.type = PIPE_MSG_DRAIN;
+        if (!PipeChannel::send(workerList_[n].pipefd[1], msg)) {
+            LOG(Error, "drain worker:%d failed", n);
+            return false;
+        }
+        workerList_[n].isRetiring = true;
+        LOG(Info, "worker:%d pid:%d retiring", n, workerList_[n].pid);
+        return true;
+    }
+    return false;
 }
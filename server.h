@@ -10,22 +10,64 @@
 #include "option.h"
 #include "log.h"
 #include "objectpool.h"
+#include "responder.h"
+#include "handler_pool.h"
+#include "uri_limit.h"
+#include "rate_limit.h"
+#include "response_cache.h"
+#include "shm_cache.h"
+#include "accept_lock.h"
+#include "worker_load.h"
+#include "hot_restart.h"
+#include "dispatcher_base/service.h"
 #include <vector>
 #include <unordered_map>
 
 namespace tinyrpc {
 
+class Server;
+
+// accepted conn, it is the poller's event handler of its own fd
+class ServerConnection : public Connection, public EventHandler {
+public:
+    ServerConnection() : server_(nullptr), markReqNum_(0), recentReqNum_(0) {}
+
+    void setServer(Server* server) { server_ = server; }
+
+    // requests of the last window, see MigrateOption
+    void rollReqWindow() {
+        recentReqNum_ = getReqNum() - markReqNum_;
+        markReqNum_ = getReqNum();
+    }
+    void resetReqWindow() { markReqNum_ = recentReqNum_ = 0; }
+    uint64_t getRecentReqNum() const { return recentReqNum_; }
+
+    void handleRead(int fd, int events) override;
+    void handleWrite(int fd, int events) override;
+
+private:
+    Server* server_;
+    uint64_t markReqNum_;
+    uint64_t recentReqNum_;
+};
+
 typedef struct Process {
     pid_t pid;
     // socketpair for IPC between parent and child
     int pipefd[2];
-    Process() : pid(-1) {}
+    // ScaleOption: sent PIPE_MSG_DRAIN, exits once drained
+    bool isRetiring;
+    Process() : pid(-1), pipefd{-1, -1}, isRetiring(false) {}
 } Process;
 
 class Server {
+    friend class ServerConnection;
+
 public:
     enum {
         PROCESS_MAXNUM = 32,
+        // conns created with the pool, it grows on demand up to the peak
+        CONN_POOL_WARMUP = 128,
     };
 
     explicit Server(const std::vector<option>& vecOpt);
@@ -33,18 +75,18 @@ public:
 
     void run(void);
 
+    // mode: CALLBACK_MODE_INLINE or CALLBACK_MODE_POOL
     template<typename REQ, typename RSP>
     bool pbRegisterCallback(std::function<void(const std::shared_ptr<REQ>&,
-                            const std::shared_ptr<RSP>&)> callback) {
-        std::shared_ptr<Protocol> protocol = codec_->getProtocol(PROTOCOL_TYPE_PB);
-        if (!protocol) {
-            LOG(Error, "pbRegisterCallback protocol type error");
+                            const std::shared_ptr<RSP>&)> callback,
+                            CallbackMode mode = CALLBACK_MODE_INLINE) {
+        auto dispatcher = getDispatcher<pb::Dispatcher>(PROTOCOL_TYPE_PB);
+        if (!dispatcher || !checkCallbackMode(mode, REQ::URI)) {
+            LOG(Error, "pbRegisterCallback protocol type or mode error");
             return false;
         }
 
-        auto dispatcher = std::static_pointer_cast<pb::Dispatcher>(
-                protocol->getDispatcher());
-        dispatcher->registerCallback<REQ,RSP>(callback);
+        dispatcher->registerCallback<REQ,RSP>(callback, mode);
         LOG(Info, "pbRegisterCallback reqUri:0x%xu", REQ::URI);
 
         return true;
@@ -52,35 +94,246 @@ public:
 
     template<typename REQ, typename RSP>
     bool ccRegisterCallback(std::function<void(const std::shared_ptr<REQ>&,
-                            const std::shared_ptr<RSP>&)> callback) {
-        std::shared_ptr<Protocol> protocol = codec_->getProtocol(PROTOCOL_TYPE_CC);
-        if (!protocol) {
-            LOG(Error, "ccRegisterCallback protocol type error");
+                            const std::shared_ptr<RSP>&)> callback,
+                            CallbackMode mode = CALLBACK_MODE_INLINE) {
+        auto dispatcher = getDispatcher<cc::Dispatcher>(PROTOCOL_TYPE_CC);
+        if (!dispatcher || !checkCallbackMode(mode, REQ::URI)) {
+            LOG(Error, "ccRegisterCallback protocol type or mode error");
             return false;
         }
 
-        auto dispatcher = std::static_pointer_cast<cc::Dispatcher>(
-                protocol->getDispatcher());
-        dispatcher->registerCallback<REQ,RSP>(callback);
+        dispatcher->registerCallback<REQ,RSP>(callback, mode);
         LOG(Info, "ccRegisterCallback reqUri:0x%xu", REQ::URI);
 
         return true;
     }
 
+    // runtime interceptors around every handler, see interceptor.h. before
+    // run()
+    void addInterceptor(const std::shared_ptr<Interceptor>& interceptor) {
+        codec_->addInterceptor(interceptor);
+    }
+
+    // a custom wire format at protocolType(PROTOCOL_TYPE_USER and up), see
+    // Codec::registerProtocol. before run()
+    bool registerProtocol(uint32_t protocolType,
+                          const std::shared_ptr<Protocol>& protocol) {
+        return codec_->registerProtocol(protocolType, protocol);
+    }
+
+    // the methods of a ServiceDef, called directly with concrete types inline
+    // on the worker loop, CHAIN is around them. uris not in DEF still go to
+    // the callbacks registered by xxRegisterCallback. before run()
+    template<typename DEF, typename CHAIN = InterceptorChain<>>
+    bool registerService(typename DEF::Service* service) {
+        uint32_t protocolType = DEF::PROTOCOL_TYPE;
+        auto protocol = std::make_shared<detail::ServiceProtocol<DEF, CHAIN>>(
+            service, codec_->getProtocol(protocolType));
+        if (!service || !codec_->replaceProtocol(protocolType, protocol)) {
+            LOG(Error, "registerService failed! protocolType:%u",
+                protocolType);
+            return false;
+        }
+
+        LOG(Info, "registerService protocolType:%u", protocolType);
+        return true;
+    }
+
+    // the handler may return before the response is ready, the response is
+    // sent when responder->done() is called, from any thread
+    template<typename REQ, typename RSP>
+    bool pbRegisterDeferredCallback(std::function<void(
+                            const std::shared_ptr<REQ>&,
+                            const std::shared_ptr<RSP>&,
+                            const ResponderPtr&)> callback) {
+        auto dispatcher = getDispatcher<pb::Dispatcher>(PROTOCOL_TYPE_PB);
+        if (!dispatcher) {
+            LOG(Error, "pbRegisterDeferredCallback protocol type error");
+            return false;
+        }
+
+        dispatcher->registerDeferredCallback<REQ,RSP>(callback);
+        LOG(Info, "pbRegisterDeferredCallback reqUri:0x%xu", REQ::URI);
+
+        return true;
+    }
+
+    template<typename REQ, typename RSP>
+    bool ccRegisterDeferredCallback(std::function<void(
+                            const std::shared_ptr<REQ>&,
+                            const std::shared_ptr<RSP>&,
+                            const ResponderPtr&)> callback) {
+        auto dispatcher = getDispatcher<cc::Dispatcher>(PROTOCOL_TYPE_CC);
+        if (!dispatcher) {
+            LOG(Error, "ccRegisterDeferredCallback protocol type error");
+            return false;
+        }
+
+        dispatcher->registerDeferredCallback<REQ,RSP>(callback);
+        LOG(Info, "ccRegisterDeferredCallback reqUri:0x%xu", REQ::URI);
+
+        return true;
+    }
+
+    // the callback gets every REQ read in one loop iteration, from all
+    // conns, at once: rsps[i] is the response of reqs[i], sent when it
+    // returns. on the worker loop, after the fired events
+    template<typename REQ, typename RSP>
+    bool pbRegisterBatchCallback(std::function<void(
+                            const std::vector<std::shared_ptr<REQ>>&,
+                            const std::vector<std::shared_ptr<RSP>>&)>
+                            callback) {
+        auto dispatcher = getDispatcher<pb::Dispatcher>(PROTOCOL_TYPE_PB);
+        if (!dispatcher) {
+            LOG(Error, "pbRegisterBatchCallback protocol type error");
+            return false;
+        }
+
+        dispatcher->registerBatchCallback<REQ,RSP>(callback);
+        batchUris_.push_back(REQ::URI);
+        LOG(Info, "pbRegisterBatchCallback reqUri:0x%xu", REQ::URI);
+
+        return true;
+    }
+
+    template<typename REQ, typename RSP>
+    bool ccRegisterBatchCallback(std::function<void(
+                            const std::vector<std::shared_ptr<REQ>>&,
+                            const std::vector<std::shared_ptr<RSP>>&)>
+                            callback) {
+        auto dispatcher = getDispatcher<cc::Dispatcher>(PROTOCOL_TYPE_CC);
+        if (!dispatcher) {
+            LOG(Error, "ccRegisterBatchCallback protocol type error");
+            return false;
+        }
+
+        dispatcher->registerBatchCallback<REQ,RSP>(callback);
+        batchUris_.push_back(REQ::URI);
+        LOG(Info, "ccRegisterBatchCallback reqUri:0x%xu", REQ::URI);
+
+        return true;
+    }
+
+    // bulkhead of reqUri, a CALLBACK_MODE_DEFERRED/POOL callback: per worker
+    // at most limit.maxConcurrent_ at once, limit.maxQueued_ waiting, the
+    // others get PROTOCOL_URI_OVERLOADED. see UriLimiter. before run()
+    bool setUriLimit(uint32_t reqUri, const UriLimit& limit) {
+        return uriLimiter_->setLimit(reqUri, limit);
+    }
+
+    // worker side, nullptr if reqUri is not limited
+    const UriLimitStats* getUriLimitStats(uint32_t reqUri) const {
+        const UriBulkhead* bulkhead = uriLimiter_->find(reqUri);
+        return bulkhead ? &bulkhead->getStats() : nullptr;
+    }
+
+    // responses of reqUri, an idempotent uri with an inline callback, are
+    // kept per worker for cache.ttlMs_, up to cache.maxBytes_(LRU). a
+    // request with the same body bytes is answered from cache. see
+    // ResponseCache. after the callback or service of reqUri and the
+    // interceptors are added, before run(). false if it is not inline
+    // (deferred, pool, batch) or interceptors run around it
+    bool setUriCache(uint32_t reqUri, const UriCache& cache) {
+        return responseCache_->setUri(reqUri, cache);
+    }
+
+    // worker side, nullptr if reqUri is not cached
+    const UriCacheStats* getUriCacheStats(uint32_t reqUri) const {
+        const UriCacheTable* table = responseCache_->find(reqUri);
+        return table ? &table->getStats() : nullptr;
+    }
+
+    // worker's loop, valid in handlers; timers and coroutines run on it
+    Poller* getPoller() const { return poller_; }
+
+    // ShmCacheOption cache of all workers, valid in handlers. nullptr if
+    // not enabled
+    ShmCache* getShmCache() {
+        return shmCache_.isCreated() ? &shmCache_ : nullptr;
+    }
+
+    // worker side, nullptr if uri is not routed to the HandlerPool
+    const HandlerPool::UriStats* getHandlerPoolStats(uint32_t reqUri) const {
+        return handlerPool_ ? handlerPool_->getUriStats(reqUri) : nullptr;
+    }
+
+    // worker side, time not accepting because of the conn limit, in us
+    uint64_t getAcceptPausedUs() const;
+
 private:
+    template<typename DISPATCHER>
+    std::shared_ptr<DISPATCHER> getDispatcher(uint32_t protocolType) {
+        std::shared_ptr<Protocol> protocol = codec_->getProtocol(protocolType);
+        if (!protocol) {
+            return nullptr;
+        }
+        return std::static_pointer_cast<DISPATCHER>(protocol->getDispatcher());
+    }
+
+    bool checkCallbackMode(CallbackMode mode, uint32_t reqUri) {
+        if (mode == CALLBACK_MODE_POOL) {
+            poolUris_.push_back(reqUri);
+            return true;
+        }
+        return mode == CALLBACK_MODE_INLINE;
+    }
+
+    bool listen();
+    bool listenPerCpu();
     bool listenOnAddress(int family, const char* ip, uint16_t port, 
-                         int& listenfd);
+                         bool reusePort, int& listenfd);
     bool isWorker() const { return workerIndex_ >= 0; }
     //void clearConn(std::unique_ptr<Connection>& conn);
-    auto clearConnAndEraseFromConnMap(const std::shared_ptr<Connection>& conn);
+    auto clearConnAndEraseFromConnMap(Connection* conn);
     
     void onSigPipeFdOfWatcher(int fd, int events, void* arg);
     void onSigPipeFdOfWorker(int fd, int events, void* arg);
     void onPipeFdOfWorker(int fd, int events, void* arg);
+    void onPipeFdOfWatcher(int fd, int events, void* arg);
     void onAccept(int fd, int events, void* arg);
-    void onRead(int fd, int events, const std::shared_ptr<Connection>& conn);
-    void onWrite(int fd, int events, const std::shared_ptr<Connection>& conn);
+    void onWatcherAccept(int fd, int events, void* arg);
+    bool addConnection(int acceptfd, const struct sockaddr_storage& clientAddr,
+                       bool isCounted);
+    void onRead(int fd, int events, Connection* conn);
+    void onWrite(int fd, int events, Connection* conn);
     void checkIdleConnections(int fd, int events, void* arg);
+    void onPendingResponse(PendingResponse& rsp);
+    void dumpHandlerPoolStats(int fd, int events, void* arg);
+    void onSlowCallback(int fd, int events, int64_t costUs);
+    void dumpLoopStats(int fd, int events, void* arg);
+    void dumpWorkerStats(int fd, int events, void* arg);
+    void reportCpuSteering(int fd, int events, void* arg);
+    void registerListenFd();
+    void tryAcceptLock();
+    bool watchListenFd();
+    void updateAcceptThrottle();
+    void onWatcherBeforePoll();
+    std::string getHotRestartPath() const;
+    bool takeOver();
+    void checkTakeoverDone();
+    void listenHotRestart();
+    void onHotRestartAccept(int fd, int events, void* arg);
+    void onHotRestartMsg(int fd, int events, void* arg);
+    void drainWorkers();
+    void startDrain();
+    void checkDrain(int fd, int events, void* arg);
+    void rebalanceWorkers(int fd, int events, void* arg);
+    void rollReqWindow(int fd, int events, void* arg);
+    void migrateConns(int target, uint32_t reqBudget);
+    bool migrateConn(ServerConnection* conn, int target);
+    // nothing buffered either way and no response to come
+    static bool isConnIdle(Connection* conn) {
+        return !conn->hasPendingRsp() && 0 == conn->getRcvBuf()->size() &&
+            0 == conn->getInflight();
+    }
+    int pickWorkerCpu() const;
+    void bindWorkerCpu();
+
+    pid_t forkWorker(int index);
+    void autoScale(int fd, int events, void* arg);
+    // watcher, out of its loop. in the child the watcher state is dropped
+    bool spawnWorker();
+    bool retireWorker();
 
     // run on child process
     void workerRun(void);
@@ -89,7 +342,8 @@ private:
 
     ServerOptions opt_;
 
-    // worker process(child process)
+    // worker process(child process), workerNum_ slots: the initial workers,
+    // up to ScaleOption::maxWorkerNum_ with scaling. pid -1: free slot
     Process* workerList_;
     int workerNum_;
     // index of parent:-1, index of children:[0,n]
@@ -97,14 +351,82 @@ private:
 
     // worker process accept conn from nonblock listenfd_ 
     int listenfd_;
+    // ACCEPT_STRATEGY_SEMLOCK, listenfd_ is watched while holding it
+    AcceptLock acceptLock_;
+    bool isListening_;
+    // AcceptOption::cpuSteering_: listenfd of every worker, created before
+    // fork in worker order, that is the index in the reuseport group
+    std::vector<int> cpuListenFds_;
+    // cpu this worker is pinned to, -1: not pinned
+    int cpu_;
+    // conn watermarks of accept throttling, see AcceptOption::pausePct_
+    size_t pauseConnNum_;
+    size_t resumeConnNum_;
+    bool isAcceptPaused_;
+    int64_t pauseBeginUs_;
+    uint64_t acceptPausedUs_;   // finished pauses
+    // accepted conns, and those whose rx cpu is not cpu_
+    uint64_t steeredConnNum_;
+    uint64_t rxCpuMismatchNum_;
+    // watcher: ACCEPT_STRATEGY_WATCHER conns no worker's pipe took
+    uint64_t acceptDroppedNum_;
+    // watcher: conn to the old server while taking over, then listening
+    // for the next restart
+    HotRestart hotRestart_;
+    bool isTakingOver_;
+    // taken over: the watcher stops accepting, workers drain and exit
+    bool isDraining_;
+    time_t drainBeginTime_;
+    // per worker conns and inflight requests, shared by all processes
+    WorkerLoadTable loadTable_;
+    // loadTable_ entry of this worker
+    WorkerLoad* load_;
+    // RateLimitOption buckets, shared by all processes
+    RateLimiter rateLimiter_;
+    // ShmCacheOption items, shared by all processes
+    ShmCache shmCache_;
+    // worker: requests dispatched and bytes of all conns, published to load_
+    uint64_t reqNum_;
+    IoCounters ioCounters_;
+    // watcher: WorkerStatsOption, loadTable_ totals at the last dump
+    std::vector<WorkerLoadSample> loadSamples_;
+    // worker: conns handed to other workers
+    uint64_t migratedConnNum_;
+    // watcher: WorkerLoad::reqNum at the last rebalance
+    std::vector<uint64_t> workerReqNums_;
+    // watcher: skip a round after a migration, the rates lag behind
+    bool skipNextRebalance_;
+    // watcher: ScaleOption, loadTable_ totals and rounds over/under
+    std::vector<WorkerLoadSample> scaleSamples_;
+    uint32_t scaleUpRounds_;
+    uint32_t scaleDownRounds_;
+    // watcher: autoScale wants a worker, forked once the loop has returned
+    bool isSpawnPending_;
     // max fd accepted from listenfd_
     int maxfd_;
 
     Poller* poller_;   
     Codec* codec_;
 
-    ObjectPool<Connection> connPool_;
-    std::unordered_map<int, std::shared_ptr<Connection>> connMap_;
+    // deferred/pool responses back to poller_
+    ResponseQueue* rspQueue_;
+    // run CALLBACK_MODE_POOL callbacks of poolUris_
+    HandlerPool* handlerPool_;
+    std::vector<uint32_t> poolUris_;
+    // CALLBACK_MODE_BATCH requests of batchUris_ until the loop hook
+    BatchQueue* batchQueue_;
+    std::vector<uint32_t> batchUris_;
+    // UriLimits, set before fork
+    UriLimiter* uriLimiter_;
+    // AdmissionOption, allocated by the worker
+    CoDel* codel_;
+    // UriCaches, set before run()
+    ResponseCache* responseCache_;
+    uint64_t connIdSeq_;
+
+    // allocated by the worker after fork(and cpu/numa binding)
+    ObjectPool<ServerConnection>* connPool_;
+    std::unordered_map<int, std::shared_ptr<ServerConnection>> connMap_;
 };
 
 
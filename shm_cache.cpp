@@ -0,0 +1,422 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "shm_cache.h"
+#include "log.h"
+#include "util.h"
+#include <sys/mman.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <new>
+
+namespace tinyrpc {
+
+static const uint32_t CLASS_MAX = 64;
+static const uint32_t CHUNK_MIN = 64;
+
+// a chunk of a page: the item header, the key, then the value. pointers
+// are the same in all processes, the map is inherited by fork
+struct ShmItem {
+    ShmItem* hashNext;
+    ShmItem* prev;          // LRU of its class
+    ShmItem* next;          // LRU of its class, or the free list
+    int64_t expireMs;       // monotonic, 0: never
+    uint64_t hash;
+    uint32_t keyLen;
+    uint32_t valueLen;
+    uint32_t flags;
+    uint32_t classId;
+
+    char* key() { return reinterpret_cast<char*>(this + 1); }
+    char* value() { return key() + keyLen; }
+};
+
+struct SlabClass {
+    uint32_t chunkBytes;
+    uint32_t pageNum;       // pages handed to this class
+    ShmItem* freeList;
+    ShmItem* lruHead;       // most recently used
+    ShmItem* lruTail;
+};
+
+// the head of a shard, its buckets and pages follow
+struct alignas(64) ShmShard {
+    pthread_mutex_t mutex;
+    uint32_t classNum;
+    uint32_t bucketMask;
+    uint32_t pageNum;
+    uint32_t usedPageNum;
+    uint32_t slabBytes;
+    ShmItem** buckets;
+    char* pages;
+    SlabClass classes[CLASS_MAX];
+    ShmCacheStats stats;
+};
+
+} // namespace tinyrpc
+
+using namespace tinyrpc;
+
+static int64_t getMonotonicMillis() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static size_t alignUp(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+// the items of a shard whose owner died are dropped, the pages start over
+static void clearShard(ShmShard* shard) {
+    memset(shard->buckets, 0, sizeof(ShmItem*) * (shard->bucketMask + 1));
+    for (uint32_t i = 0; i < shard->classNum; i++) {
+        SlabClass& cls = shard->classes[i];
+        cls.pageNum = 0;
+        cls.freeList = cls.lruHead = cls.lruTail = nullptr;
+    }
+    shard->usedPageNum = 0;
+    shard->stats.items = 0;
+    shard->stats.bytes = 0;
+}
+
+namespace {
+
+class ShardLock {
+public:
+    explicit ShardLock(ShmShard* shard) : shard_(shard), locked_(false) {
+        int ret = pthread_mutex_lock(&shard_->mutex);
+        if (EOWNERDEAD == ret) {
+            LOG(Warn, "shm cache shard owner died, shard cleared");
+            clearShard(shard_);
+            pthread_mutex_consistent(&shard_->mutex);
+            locked_ = true;
+        } else if (0 != ret) {
+            LOG(Error, "lock shm cache shard failed, err:%s", strerror(ret));
+        } else {
+            locked_ = true;
+        }
+    }
+    ~ShardLock() {
+        if (locked_) {
+            pthread_mutex_unlock(&shard_->mutex);
+        }
+    }
+
+    // false: the shard must not be touched
+    bool locked() const { return locked_; }
+
+private:
+    ShmShard* shard_;
+    bool locked_;
+};
+
+} // namespace
+
+static ShmItem* findItem(ShmShard* shard, uint64_t hash, const char* key,
+                         uint32_t keyLen) {
+    ShmItem* item = shard->buckets[hash & shard->bucketMask];
+    for (; item; item = item->hashNext) {
+        if (item->hash == hash && item->keyLen == keyLen &&
+            0 == memcmp(item->key(), key, keyLen)) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+static void lruUnlink(SlabClass& cls, ShmItem* item) {
+    (item->prev ? item->prev->next : cls.lruHead) = item->next;
+    (item->next ? item->next->prev : cls.lruTail) = item->prev;
+}
+
+static void lruPushFront(SlabClass& cls, ShmItem* item) {
+    item->prev = nullptr;
+    item->next = cls.lruHead;
+    (cls.lruHead ? cls.lruHead->prev : cls.lruTail) = item;
+    cls.lruHead = item;
+}
+
+// out of the table and the LRU, the chunk is not freed
+static void unlinkItem(ShmShard* shard, ShmItem* item) {
+    ShmItem** link = &shard->buckets[item->hash & shard->bucketMask];
+    while (*link != item) {
+        link = &(*link)->hashNext;
+    }
+    *link = item->hashNext;
+    lruUnlink(shard->classes[item->classId], item);
+    shard->stats.items--;
+    shard->stats.bytes -= item->keyLen + item->valueLen;
+}
+
+static void freeItem(ShmShard* shard, ShmItem* item) {
+    unlinkItem(shard, item);
+    SlabClass& cls = shard->classes[item->classId];
+    item->next = cls.freeList;
+    cls.freeList = item;
+}
+
+// a free chunk of the class: the free list, a new page, or the LRU tail
+static ShmItem* allocItem(ShmShard* shard, uint32_t classId) {
+    SlabClass& cls = shard->classes[classId];
+    if (!cls.freeList && shard->usedPageNum < shard->pageNum) {
+        char* page = shard->pages +
+            (size_t)shard->usedPageNum++ * shard->slabBytes;
+        cls.pageNum++;
+        uint32_t chunkNum = shard->slabBytes / cls.chunkBytes;
+        for (uint32_t i = 0; i < chunkNum; i++) {
+            ShmItem* chunk = reinterpret_cast<ShmItem*>(
+                page + (size_t)i * cls.chunkBytes);
+            chunk->next = cls.freeList;
+            cls.freeList = chunk;
+        }
+    }
+
+    if (cls.freeList) {
+        ShmItem* item = cls.freeList;
+        cls.freeList = item->next;
+        return item;
+    }
+    if (cls.lruTail) {
+        ShmItem* item = cls.lruTail;
+        unlinkItem(shard, item);
+        shard->stats.evictions++;
+        return item;
+    }
+    return nullptr;
+}
+
+ShmCache::ShmCache()
+    : base_(nullptr)
+    , mapBytes_(0)
+    , shardBytes_(0)
+    , shardNum_(0)
+    , maxItemBytes_(0) {
+}
+
+bool ShmCache::create(const ShmCacheOption& opt) {
+    // the last class holds maxItemBytes_ in a chunk of 8 bytes aligned
+    if (0 == opt.shardNum_ || alignUp(opt.maxItemBytes_, 8) > opt.slabBytes_ ||
+        opt.maxItemBytes_ < CHUNK_MIN) {
+        LOG(Error, "bad shm cache option, shards:%u,slab:%u,max item:%u",
+            opt.shardNum_, opt.slabBytes_, opt.maxItemBytes_);
+        return false;
+    }
+
+    // a shard: its head, the buckets(an item per 512 bytes), the pages
+    shardBytes_ = alignUp(opt.memBytes_ / opt.shardNum_, 64);
+    uint32_t bucketNum = 64;
+    while (bucketNum < shardBytes_ / 512) {
+        bucketNum <<= 1;
+    }
+    size_t headBytes = alignUp(sizeof(ShmShard) + sizeof(ShmItem*) * bucketNum,
+        64);
+    if (shardBytes_ < headBytes + opt.slabBytes_) {
+        LOG(Error, "shm cache too small for a page per shard, mem:%lu",
+            (unsigned long)opt.memBytes_);
+        return false;
+    }
+
+    mapBytes_ = shardBytes_ * opt.shardNum_;
+    void* addr = mmap(nullptr, mapBytes_, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == addr) {
+        LOG(Error, "mmap failed, err:%s", strerror(errno));
+        mapBytes_ = 0;
+        return false;
+    }
+    base_ = static_cast<char*>(addr);
+    shardNum_ = opt.shardNum_;
+    maxItemBytes_ = opt.maxItemBytes_;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    for (uint32_t n = 0; n < shardNum_; n++) {
+        char* start = base_ + shardBytes_ * n;
+        ShmShard* shard = new (start) ShmShard();
+        pthread_mutex_init(&shard->mutex, &attr);
+        shard->bucketMask = bucketNum - 1;
+        shard->buckets = reinterpret_cast<ShmItem**>(start + sizeof(ShmShard));
+        shard->pages = start + headBytes;
+        shard->slabBytes = opt.slabBytes_;
+        shard->pageNum = (shardBytes_ - headBytes) / opt.slabBytes_;
+        shard->stats.pages = shard->pageNum;
+
+        // chunks grow by 1.25x, the last class holds maxItemBytes_
+        uint32_t chunkBytes = CHUNK_MIN;
+        while (shard->classNum < CLASS_MAX - 1 &&
+               chunkBytes < maxItemBytes_) {
+            shard->classes[shard->classNum++].chunkBytes = chunkBytes;
+            chunkBytes = alignUp(chunkBytes + chunkBytes / 4, 8);
+        }
+        shard->classes[shard->classNum++].chunkBytes =
+            alignUp(maxItemBytes_, 8);
+        clearShard(shard);
+    }
+    pthread_mutexattr_destroy(&attr);
+    return true;
+}
+
+void ShmCache::destroy() {
+    if (base_) {
+        munmap(base_, mapBytes_);
+        base_ = nullptr;
+        mapBytes_ = 0;
+        shardNum_ = 0;
+    }
+}
+
+ShmShard* ShmCache::getShard(uint64_t hash) const {
+    // the high bits, the low ones pick the bucket
+    return reinterpret_cast<ShmShard*>(base_ +
+        shardBytes_ * ((hash >> 40) % shardNum_));
+}
+
+int ShmCache::getClass(const ShmShard* shard, size_t itemBytes) const {
+    for (uint32_t i = 0; i < shard->classNum; i++) {
+        if (itemBytes <= shard->classes[i].chunkBytes) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ShmCache::get(const char* key, uint32_t keyLen, std::string& value,
+                   uint32_t* flags) {
+    if (!base_) {
+        return false;
+    }
+    uint64_t hash = Util::hashBytes(key, keyLen);
+    ShmShard* shard = getShard(hash);
+
+    ShardLock lock(shard);
+    if (!lock.locked()) {
+        return false;
+    }
+    shard->stats.gets++;
+    ShmItem* item = findItem(shard, hash, key, keyLen);
+    if (!item) {
+        return false;
+    }
+    if (item->expireMs > 0 && item->expireMs <= getMonotonicMillis()) {
+        freeItem(shard, item);
+        shard->stats.expirations++;
+        return false;
+    }
+
+    SlabClass& cls = shard->classes[item->classId];
+    lruUnlink(cls, item);
+    lruPushFront(cls, item);
+    value.assign(item->value(), item->valueLen);
+    if (flags) {
+        *flags = item->flags;
+    }
+    shard->stats.hits++;
+    return true;
+}
+
+bool ShmCache::set(const char* key, uint32_t keyLen, const char* value,
+                   uint32_t valueLen, uint32_t ttlMs, uint32_t flags) {
+    if (!base_) {
+        return false;
+    }
+    uint64_t hash = Util::hashBytes(key, keyLen);
+    ShmShard* shard = getShard(hash);
+    int classId = getClass(shard, sizeof(ShmItem) + keyLen + valueLen);
+
+    ShardLock lock(shard);
+    if (!lock.locked()) {
+        return false;
+    }
+    shard->stats.sets++;
+    ShmItem* old = findItem(shard, hash, key, keyLen);
+    if (old) {
+        freeItem(shard, old);
+    }
+    ShmItem* item = classId >= 0 ? allocItem(shard, classId) : nullptr;
+    if (!item) {
+        shard->stats.failedSets++;
+        return false;
+    }
+
+    item->expireMs = ttlMs > 0 ? getMonotonicMillis() + ttlMs : 0;
+    item->hash = hash;
+    item->keyLen = keyLen;
+    item->valueLen = valueLen;
+    item->flags = flags;
+    item->classId = classId;
+    memcpy(item->key(), key, keyLen);
+    memcpy(item->value(), value, valueLen);
+
+    ShmItem*& bucket = shard->buckets[hash & shard->bucketMask];
+    item->hashNext = bucket;
+    bucket = item;
+    lruPushFront(shard->classes[classId], item);
+    shard->stats.items++;
+    shard->stats.bytes += keyLen + valueLen;
+    return true;
+}
+
+bool ShmCache::erase(const char* key, uint32_t keyLen) {
+    if (!base_) {
+        return false;
+    }
+    uint64_t hash = Util::hashBytes(key, keyLen);
+    ShmShard* shard = getShard(hash);
+
+    ShardLock lock(shard);
+    if (!lock.locked()) {
+        return false;
+    }
+    ShmItem* item = findItem(shard, hash, key, keyLen);
+    if (!item) {
+        return false;
+    }
+    freeItem(shard, item);
+    return true;
+}
+
+ShmCacheStats ShmCache::getStats() const {
+    ShmCacheStats total;
+    for (uint32_t n = 0; n < shardNum_; n++) {
+        ShmShard* shard = reinterpret_cast<ShmShard*>(base_ + shardBytes_ * n);
+        ShardLock lock(shard);
+        if (!lock.locked()) {
+            continue;
+        }
+        const ShmCacheStats& s = shard->stats;
+        total.gets += s.gets;
+        total.hits += s.hits;
+        total.sets += s.sets;
+        total.failedSets += s.failedSets;
+        total.evictions += s.evictions;
+        total.expirations += s.expirations;
+        total.items += s.items;
+        total.bytes += s.bytes;
+        total.usedPages += shard->usedPageNum;
+        total.pages += s.pages;
+    }
+    return total;
+}
+
+void ShmCache::report(std::string& out) const {
+    if (!base_) {
+        return;
+    }
+    ShmCacheStats s = getStats();
+    char line[256];
+    snprintf(line, sizeof(line), "shm_cache items %lu bytes %lu pages %lu/%lu "
+        "gets %lu hits %lu sets %lu failed_sets %lu evictions %lu "
+        "expirations %lu\n", (unsigned long)s.items, (unsigned long)s.bytes,
+        (unsigned long)s.usedPages, (unsigned long)s.pages,
+        (unsigned long)s.gets, (unsigned long)s.hits, (unsigned long)s.sets,
+        (unsigned long)s.failedSets, (unsigned long)s.evictions,
+        (unsigned long)s.expirations);
+    out += line;
+}
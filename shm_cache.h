@@ -0,0 +1,103 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __SHM_CACHE_H__
+#define __SHM_CACHE_H__
+
+#include "option.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+namespace tinyrpc {
+
+struct ShmCacheStats {
+    uint64_t gets;
+    uint64_t hits;
+    uint64_t sets;
+    uint64_t failedSets;    // too large, or no memory for the size class
+    uint64_t evictions;     // LRU of a size class, for a set
+    uint64_t expirations;   // found after ttl
+    uint64_t items;
+    uint64_t bytes;         // keys and values
+    uint64_t usedPages;
+    uint64_t pages;
+
+    ShmCacheStats()
+        : gets(0), hits(0), sets(0), failedSets(0), evictions(0)
+        , expirations(0), items(0), bytes(0), usedPages(0), pages(0) {}
+};
+
+struct ShmShard;
+
+/*
+ * Key/value cache in shared memory(MAP_SHARED | MAP_ANONYMOUS), created by
+ * the watcher before fork: every worker reads and writes the same items,
+ * so the capacity is memBytes_ for the host, not per worker.
+ *
+ * Keys are hashed to shardNum_ shards, a shard is a hash table under a
+ * robust process-shared mutex: if a worker dies holding it, the next one
+ * to lock clears the shard(its items may be half written) and goes on.
+ *
+ * Memory of a shard is cut in slabBytes_ pages. A page goes to the size
+ * class(chunks growing by 1.25x up to maxItemBytes_) that first runs out
+ * of chunks. Once all pages are handed out a set evicts the least recently
+ * used item of its own class; a class that never got a page has nothing
+ * to evict and the set fails.
+ */
+class ShmCache {
+public:
+    ShmCache();
+    ShmCache(const ShmCache&) = delete;
+    ShmCache& operator = (const ShmCache&) = delete;
+    ~ShmCache() { destroy(); }
+
+    // by the watcher, before fork
+    bool create(const ShmCacheOption& opt);
+    void destroy();
+    bool isCreated() const { return nullptr != base_; }
+
+    // the value of key and the flags it was set with. false: not there, or
+    // expired
+    bool get(const char* key, uint32_t keyLen, std::string& value,
+             uint32_t* flags = nullptr);
+    bool get(const std::string& key, std::string& value,
+             uint32_t* flags = nullptr) {
+        return get(key.data(), key.size(), value, flags);
+    }
+
+    // ttlMs 0: until evicted. false: the item is larger than maxItemBytes_
+    // or there is no memory for its size class
+    bool set(const char* key, uint32_t keyLen, const char* value,
+             uint32_t valueLen, uint32_t ttlMs = 0, uint32_t flags = 0);
+    bool set(const std::string& key, const std::string& value,
+             uint32_t ttlMs = 0, uint32_t flags = 0) {
+        return set(key.data(), key.size(), value.data(), value.size(), ttlMs,
+            flags);
+    }
+
+    bool erase(const char* key, uint32_t keyLen);
+    bool erase(const std::string& key) {
+        return erase(key.data(), key.size());
+    }
+
+    // all shards, each locked in turn
+    ShmCacheStats getStats() const;
+    void report(std::string& out) const;
+
+private:
+    ShmShard* getShard(uint64_t hash) const;
+    // size class of an item of itemBytes, -1 if too large
+    int getClass(const ShmShard* shard, size_t itemBytes) const;
+
+    char* base_;
+    size_t mapBytes_;
+    size_t shardBytes_;
+    uint32_t shardNum_;
+    uint32_t maxItemBytes_;
+};
+
+} // namespace tinyrpc
+
+#endif // __SHM_CACHE_H__
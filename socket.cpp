@@ -13,6 +13,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/filter.h>
 #include <iostream>
 
 using namespace tinyrpc;
@@ -23,6 +26,36 @@ void Socket::setNonBlocking(int sockfd) {
     fcntl(sockfd, F_SETFL, flags | O_NONBLOCK);
 }
 
+bool Socket::setBusyPoll(int sockfd, int busyPollUs, bool preferBusyPoll) {
+#ifdef SO_BUSY_POLL
+    if (setsockopt(sockfd, SOL_SOCKET, SO_BUSY_POLL, &busyPollUs,
+                   sizeof(busyPollUs)) < 0) {
+        LOG(Warn, "SO_BUSY_POLL failed, fd:%d, err:%s", sockfd,
+            strerror(errno));
+        return false;
+    }
+#else
+    LOG(Warn, "SO_BUSY_POLL is not supported. fd:%d", sockfd);
+    return false;
+#endif
+
+    if (preferBusyPoll) {
+#ifdef SO_PREFER_BUSY_POLL
+        int optval = 1;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &optval,
+                       sizeof(optval)) < 0) {
+            LOG(Warn, "SO_PREFER_BUSY_POLL failed, fd:%d, err:%s", sockfd,
+                strerror(errno));
+            return false;
+        }
+#else
+        LOG(Warn, "SO_PREFER_BUSY_POLL is not supported. fd:%d", sockfd);
+        return false;
+#endif
+    }
+    return true;
+}
+
 int Socket::connect(const std::string& host, const std::string& port, 
                     int timeoutMs) {
     struct addrinfo hints;
@@ -110,4 +143,88 @@ int Socket::connect(const std::string& host, const std::string& port,
     Util::clear_fl(sockfd, O_NONBLOCK);
 
     return sockfd;
+}
+
+bool Socket::setIncomingCpu(int sockfd, int cpu) {
+#ifdef SO_INCOMING_CPU
+    if (setsockopt(sockfd, SOL_SOCKET, SO_INCOMING_CPU, &cpu,
+                   sizeof(cpu)) < 0) {
+        LOG(Warn, "SO_INCOMING_CPU failed, fd:%d, cpu:%d, err:%s", sockfd,
+            cpu, strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    LOG(Warn, "SO_INCOMING_CPU is not supported. fd:%d", sockfd);
+    return false;
+#endif
+}
+
+int Socket::getIncomingCpu(int sockfd) {
+#ifdef SO_INCOMING_CPU
+    int cpu = -1;
+    socklen_t len = sizeof(cpu);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) < 0) {
+        return -1;
+    }
+    return cpu;
+#else
+    return -1;
+#endif
+}
+
+bool Socket::attachReuseportCpuBpf(int sockfd, uint32_t groupSize) {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    if (0 == groupSize) {
+        return false;
+    }
+    // A = raw_smp_processor_id(); A %= groupSize; return A
+    // an index out of the group falls back to the reuseport hash
+    struct sock_filter code[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU) },
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, groupSize },
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_fprog prog;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+
+    if (setsockopt(sockfd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+                   sizeof(prog)) < 0) {
+        LOG(Error, "SO_ATTACH_REUSEPORT_CBPF failed, fd:%d, err:%s", sockfd,
+            strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    LOG(Warn, "SO_ATTACH_REUSEPORT_CBPF is not supported. fd:%d", sockfd);
+    return false;
+#endif
+}
+
+int Socket::accept(int listenfd, struct sockaddr_storage& addr,
+                   socklen_t& addrLen) {
+    while (true) {
+        socklen_t len = sizeof(addr);
+        int fd = ::accept4(listenfd, (struct sockaddr*)&addr, &len,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0) {
+            addrLen = len;
+            return fd;
+        }
+        // the peer reset before accept, take the next one
+        if (EINTR != errno && ECONNABORTED != errno) {
+            return -1;
+        }
+    }
+}
+
+bool Socket::setDeferAccept(int listenfd, int seconds) {
+    if (setsockopt(listenfd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &seconds,
+                   sizeof(seconds)) < 0) {
+        LOG(Warn, "TCP_DEFER_ACCEPT failed, fd:%d, err:%s", listenfd,
+            strerror(errno));
+        return false;
+    }
+    return true;
 }
\ No newline at end of file
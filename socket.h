@@ -5,7 +5,9 @@
 #ifndef __SOCKET_H__
 #define __SOCKET_H__
 
+#include <stdint.h>
 #include <string>
+#include <sys/socket.h>
 
 namespace tinyrpc {
 
@@ -19,6 +21,31 @@ public:
     // 设置 socket 为非阻塞模式
     static void setNonBlocking(int sockfd);
 
+    // SO_BUSY_POLL: recv busy-waits on the device queue up to busyPollUs,
+    // larger than net.core.busy_read needs CAP_NET_ADMIN.
+    // preferBusyPoll: SO_PREFER_BUSY_POLL(since Linux 5.11)
+    static bool setBusyPoll(int sockfd, int busyPollUs, bool preferBusyPoll);
+
+    // SO_INCOMING_CPU: set on a listenfd it is a hint for the kernel's
+    // listener lookup, get on an accepted fd it is the cpu that handled
+    // its last received packet(-1 on error)
+    static bool setIncomingCpu(int sockfd, int cpu);
+    static int getIncomingCpu(int sockfd);
+
+    // SO_ATTACH_REUSEPORT_CBPF: the reuseport group of sockfd picks the
+    // socket by index `rx cpu % groupSize`, index is the order the sockets
+    // joined the group(listen order)
+    static bool attachReuseportCpuBpf(int sockfd, uint32_t groupSize);
+
+    // accept4(SOCK_NONBLOCK | SOCK_CLOEXEC), retried on EINTR and
+    // ECONNABORTED. -1 with errno set(EAGAIN: backlog drained)
+    static int accept(int listenfd, struct sockaddr_storage& addr,
+                      socklen_t& addrLen);
+
+    // TCP_DEFER_ACCEPT: a conn is queued for accept once its first data
+    // arrives(or after about seconds)
+    static bool setDeferAccept(int listenfd, int seconds);
+
     // TODO: 添加更多 socket 相关操作 no delay、keep alive、reuse addr、reuse port、SO_LINGER 等
 };
 
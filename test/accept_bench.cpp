@@ -0,0 +1,198 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// connection storm against each AcceptStrategy: a server is forked per
+// strategy, client threads open connections as fast as they can and keep
+// them open, every connection asks which worker(pid) serves it.
+// reports accepted conns/s and the per-worker connection skew.
+
+#include "server.h"
+#include "client/client_pb.h"
+#include "proto_pb/echo.pb.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+struct BenchStrategy {
+    const char* name;
+    AcceptStrategy strategy;
+    bool cpuSteering;
+};
+
+// answer with the pid of the worker
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    rsp->set_retcode(1);
+    rsp->set_sid(to_string(getpid()));
+}
+
+static pid_t startServer(const BenchStrategy& bs, int workerNum, int port) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    ServiceAddrOption serviceAddrOption;
+    serviceAddrOption.ip_ = "127.0.0.1";
+    serviceAddrOption.port_ = port;
+    serviceAddrOption.isIPv6_ = false;
+
+    CommonOption commonOption;
+    commonOption.workerNum_ = workerNum;
+    commonOption.idleTimeout_ = 600;
+    commonOption.maxConnNum_ = 10000;
+
+    AcceptOption acceptOption;
+    acceptOption.strategy_ = bs.strategy;
+    acceptOption.cpuSteering_ = bs.cpuSteering;
+
+    vector<option> vecOpt;
+    vecOpt.push_back(ServerOptions::createServiceAddrOption(serviceAddrOption));
+    vecOpt.push_back(ServerOptions::createCommonOption(commonOption));
+    vecOpt.push_back(ServerOptions::createAcceptOption(acceptOption));
+
+    {
+        Server srv(vecOpt);
+        srv.pbRegisterCallback<EchoReq, EchoRsp>(onEchoReq);
+        srv.run();
+    }
+    _exit(0);
+}
+
+static void stopServer(pid_t pid) {
+    // the watcher stops its workers and removes the accept lock
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+static bool waitServer(const ClientOptions& opt) {
+    for (int i = 0; i < 50; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        PbClient client(opt);
+        if (client.isOk()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void runStrategy(const BenchStrategy& bs, int workerNum, int connNum,
+                        int threadNum, int port) {
+    pid_t pid = startServer(bs, workerNum, port);
+
+    ClientOptions opt;
+    opt.serviceAddrOption.ip_ = "127.0.0.1";
+    opt.serviceAddrOption.port_ = port;
+    if (!waitServer(opt)) {
+        cout << bs.name << ": server is not ready!" << endl;
+        stopServer(pid);
+        return;
+    }
+    // let the probe conn be closed
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::mutex mtx;
+    map<string, int> connPerWorker;
+    vector<unique_ptr<PbClient>> clients;
+    std::atomic<int> next(0);
+    std::atomic<int> failCnt(0);
+
+    auto storm = [&]() {
+        EchoReq req;
+        req.set_sid("accept");
+        std::shared_ptr<EchoRsp> rsp;
+        while (next.fetch_add(1) < connNum) {
+            unique_ptr<PbClient> client(new PbClient(opt));
+            if (!client->isOk() ||
+                !client->synCall<EchoReq, EchoRsp>(req, rsp)) {
+                failCnt++;
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mtx);
+            connPerWorker[rsp->sid()]++;
+            clients.push_back(std::move(client));
+        }
+    };
+
+    auto begin = chrono::steady_clock::now();
+    vector<std::thread> threads;
+    for (int i = 0; i < threadNum; i++) {
+        threads.emplace_back(storm);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    double sec = chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now() - begin).count() / 1e6;
+
+    clients.clear();
+    stopServer(pid);
+
+    int maxConn = 0;
+    int minConn = connPerWorker.size() < (size_t)workerNum ? 0 : connNum;
+    for (auto& it : connPerWorker) {
+        maxConn = std::max(maxConn, it.second);
+        minConn = std::min(minConn, it.second);
+    }
+    int okCnt = connNum - failCnt.load();
+    double avg = (double)okCnt / workerNum;
+
+    printf("%-10s conns:%d fail:%d elapsed:%.3fs rate:%.0f conn/s "
+           "min:%d max:%d max/avg:%.2f |", bs.name, okCnt, failCnt.load(),
+           sec, okCnt / sec, minConn, maxConn, avg > 0 ? maxConn / avg : 0);
+    for (auto& it : connPerWorker) {
+        printf(" %s:%d", it.first.c_str(), it.second);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 5) {
+        cout << "usage:" << argv[0]
+            << " [workers] [connections] [client threads] [port]" << endl;
+        return -1;
+    }
+
+    int workerNum = atoi(argv[1]);
+    int connNum = atoi(argv[2]);
+    int threadNum = atoi(argv[3]);
+    int port = atoi(argv[4]);
+
+    BenchStrategy strategies[] = {
+        {"reuseport", ACCEPT_STRATEGY_REUSEPORT, false},
+        // worker N on cpu N, conns follow the rx cpu: skewed by design when
+        // clients run on few cpus(loopback rx cpu is the sender's cpu)
+        {"reuse-cpu", ACCEPT_STRATEGY_REUSEPORT, true},
+        {"exclusive", ACCEPT_STRATEGY_EXCLUSIVE, false},
+        {"semlock", ACCEPT_STRATEGY_SEMLOCK, false},
+        {"watcher", ACCEPT_STRATEGY_WATCHER, false},
+    };
+
+    for (const BenchStrategy& bs : strategies) {
+        runStrategy(bs, workerNum, connNum, threadNum, port);
+    }
+
+    return 0;
+}
+
+/*
+
+$ ./exe_accept_bench 4 2000 8 8940
+
+connections are kept open until the storm ends, so the skew is the number
+of live connections per worker. ulimit -n must be > connections.
+
+ */
@@ -0,0 +1,172 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// a client pipelines [depth] EchoReqs, the server reads them in one go:
+//   inline: pbRegisterCallback, a backend query per request
+//   batch:  pbRegisterBatchCallback, a backend query per read
+// the backend query costs [queryUs] + 50ns per key(busy wait), 0: no
+// backend, the cost of batching itself. responses go to a unix socketpair.
+
+#include "codec.h"
+#include "connection.h"
+#include "poller.h"
+#include "responder.h"
+#include "test_util.h"
+#include "proto_pb/echo.pb.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+using EchoReqPtr = std::shared_ptr<EchoReq>;
+using EchoRspPtr = std::shared_ptr<EchoRsp>;
+
+static int64_t g_queryNs = 0;
+
+// one round trip to the backend for keyNum keys
+static void queryBackend(size_t keyNum) {
+    if (0 == g_queryNs) {
+        return;
+    }
+    auto end = chrono::steady_clock::now() +
+        chrono::nanoseconds(g_queryNs + 50 * keyNum);
+    while (chrono::steady_clock::now() < end) {
+    }
+}
+
+static void fill(const EchoReq& req, EchoRsp& rsp) {
+    rsp.set_retcode(1);
+    rsp.set_info("world");
+    rsp.set_sid(req.sid());
+    rsp.set_loginid(req.loginid());
+}
+
+static void onEchoReq(const EchoReqPtr& req, const EchoRspPtr& rsp) {
+    queryBackend(1);
+    fill(*req, *rsp);
+}
+
+static void onEchoReqs(const vector<EchoReqPtr>& reqs,
+                       const vector<EchoRspPtr>& rsps) {
+    queryBackend(reqs.size());
+    for (size_t i = 0; i < reqs.size(); i++) {
+        fill(*reqs[i], *rsps[i]);
+    }
+}
+
+static string makeFrame() {
+    EchoReq req;
+    req.set_sid("bench-sid-0123456789");
+    req.set_loginid(7);
+    req.set_info("hello");
+    return test::packPbFrame(req);
+}
+
+// ns per request
+static double run(bool isBatch, int depth, int reads) {
+    int fds[2];
+    if (!test::makeSocketPair(fds)) {
+        return 0;
+    }
+    Connection conn(fds[0]);
+
+    // the worker's side: a loop whose AFTER_EVENTS hook is played by the
+    // flush() below, responses are sent like Server::onPendingResponse
+    Poller poller(1024);
+    ResponseQueue rspQueue;
+    rspQueue.init(&poller, [&conn](PendingResponse& rsp) {
+        conn.subInflight();
+        Codec::sendMessage(&conn, rsp.protocolType, rsp.rspUri, rsp.data,
+            rsp.traceId);
+    });
+    BatchQueue batchQueue(&rspQueue);
+
+    Codec codec;
+    HandlerContext context;
+    context.rspQueue = &rspQueue;
+    context.batchQueue = &batchQueue;
+    codec.setHandlerContext(context);
+    auto dispatcher = std::static_pointer_cast<pb::Dispatcher>(
+        codec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher());
+    if (isBatch) {
+        dispatcher->registerBatchCallback<EchoReq, EchoRsp>(onEchoReqs);
+    } else {
+        dispatcher->registerCallback<EchoReq, EchoRsp>(onEchoReq);
+    }
+
+    string frames;
+    string frame = makeFrame();
+    for (int i = 0; i < depth; i++) {
+        frames += frame;
+    }
+
+    auto begin = chrono::steady_clock::now();
+    for (int i = 0; i < reads; i++) {
+        if (send(fds[1], frames.data(), frames.size(), 0) !=
+                (ssize_t)frames.size()) {
+            cout << "send failed!" << endl;
+            break;
+        }
+        conn.tcpRecv();
+        codec.processMessage(&conn);
+        if (!batchQueue.empty()) {
+            batchQueue.flush();
+        }
+        test::drainFd(fds[1]);
+    }
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    close(fds[1]);
+    return (double)ns / ((uint64_t)reads * depth);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        cout << "usage:" << argv[0] << " [requests] [queryUs]" << endl;
+        return -1;
+    }
+
+    int requests = atoi(argv[1]);
+    g_queryNs = atoi(argv[2]) * 1000;
+
+    printf("queryUs:%d\n", atoi(argv[2]));
+    for (int depth : {1, 8, 32}) {
+        int reads = requests / depth + 1;
+        // warm up
+        run(false, depth, reads / 10 + 1);
+        run(true, depth, reads / 10 + 1);
+        double inlineNs = run(false, depth, reads);
+        double batchNs = run(true, depth, reads);
+        printf("depth:%-3d inline ns/req:%8.1f  batch ns/req:%8.1f\n", depth,
+            inlineNs, batchNs);
+    }
+    return 0;
+}
+
+/*
+
+(-O2, 1 cpu)
+$ ./exe_batch_bench 200000 0
+queryUs:0
+depth:1   inline ns/req:  5239.0  batch ns/req:  5506.6
+depth:8   inline ns/req:  2572.8  batch ns/req:  2736.9
+depth:32  inline ns/req:  2053.2  batch ns/req:  2242.2
+$ ./exe_batch_bench 200000 5
+queryUs:5
+depth:1   inline ns/req: 10666.5  batch ns/req: 10654.4
+depth:8   inline ns/req:  7880.7  batch ns/req:  3317.6
+depth:32  inline ns/req:  7796.0  batch ns/req:  2415.5
+
+batching itself costs 5-9%: the requests wait in vectors and each
+response goes through a PendingResponse.
+
+ */
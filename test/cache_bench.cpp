@@ -0,0 +1,296 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// EchoReqs to an inline handler costing [handlerUs](busy wait), 32 frames
+// per read, responses go to a unix socketpair:
+//   no cache:  setResponseCache not called
+//   hit:       one request body over and over, answered from cache
+//   miss:      4096 bodies in turn through a 64KB cache, every one a miss, a put
+//              and an eviction: what the cache costs when it does not help
+//   shared hit: hit, in a ShmCache(UriCache::isShared_): the lock of a shard
+//              and a copy of the response out of shared memory
+// the responses are counted, and the traceId of each is checked to be the
+// request's own. a uri of a pool callback is refused by setUri, so is one
+// with an interceptor; one intercepted after setUri is still turned down.
+
+#include "codec.h"
+#include "connection.h"
+#include "response_cache.h"
+#include "shm_cache.h"
+#include "test_util.h"
+#include "proto_pb/echo.pb.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+static int64_t g_handlerNs = 0;
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    auto end = chrono::steady_clock::now() + chrono::nanoseconds(g_handlerNs);
+    while (g_handlerNs > 0 && chrono::steady_clock::now() < end) {
+    }
+    rsp->set_retcode(1);
+    rsp->set_info("world");
+    rsp->set_sid(req->sid());
+    rsp->set_loginid(req->loginid());
+}
+
+static string makeFrame(int key, int seq) {
+    EchoReq req;
+    req.set_sid("bench-sid-" + to_string(key));
+    req.set_loginid(7);
+    req.set_info("hello");
+    return test::packPbFrame(req, to_string(seq));
+}
+
+// distinct frames(traceIds) per run, and bodies in MODE_MISS
+static const int FRAME_NUM = 4096;
+
+// responses read, -1 on a traceId that is not the request's
+static int drain(Connection& client, int& seq) {
+    int num = 0;
+    client.tcpRecv();
+    while (true) {
+        ProtocolHead head;
+        char* package = nullptr;
+        uint32_t packageSize = 0;
+        Codec codec;
+        if (codec.unpack(&client, head, &package, packageSize) <= 0) {
+            break;
+        }
+        if (EchoRsp::URI != head.protocolUri ||
+            atoi(head.traceId) != seq++ % FRAME_NUM) {
+            return -1;
+        }
+        num++;
+    }
+    return num;
+}
+
+// turns every request down, answers nothing
+class RejectInterceptor : public Interceptor {
+public:
+    bool onRequest(CallContext& ctx) override { return false; }
+};
+
+// a request of a uri cached and then intercepted is turned down, a uri
+// intercepted before is not cached
+static bool checkIntercepted() {
+    int fds[2];
+    if (!test::makeSocketPair(fds)) {
+        return false;
+    }
+    Connection conn(fds[0]);
+    Connection client(fds[1]);
+    client.setStatus(CONN_STATUS_OK);
+
+    Codec codec;
+    std::static_pointer_cast<pb::Dispatcher>(
+        codec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher())
+        ->registerCallback<EchoReq, EchoRsp>(onEchoReq);
+    ResponseCache cache;
+    cache.setCacheableCheck([&codec](uint32_t uri) {
+        return codec.isCacheableUri(uri);
+    });
+    if (!cache.setUri(EchoReq::URI, UriCache())) {
+        cout << "setUri failed!" << endl;
+        return false;
+    }
+    codec.setResponseCache(&cache);
+
+    // the first is put, the second a hit
+    int seq = 0;
+    string frame = makeFrame(0, 0) + makeFrame(0, 1);
+    send(fds[1], frame.data(), frame.size(), 0);
+    conn.tcpRecv();
+    codec.processMessage(&conn);
+    if (2 != drain(client, seq)) {
+        cout << "no cached response!" << endl;
+        return false;
+    }
+
+    codec.addInterceptor(std::make_shared<RejectInterceptor>());
+    frame = makeFrame(0, 2);
+    send(fds[1], frame.data(), frame.size(), 0);
+    conn.tcpRecv();
+    codec.processMessage(&conn);
+    if (0 != drain(client, seq)) {
+        cout << "a rejected request is answered from cache!" << endl;
+        return false;
+    }
+
+    ResponseCache late;
+    late.setCacheableCheck([&codec](uint32_t uri) {
+        return codec.isCacheableUri(uri);
+    });
+    if (late.setUri(EchoReq::URI, UriCache())) {
+        cout << "an intercepted uri is cached!" << endl;
+        return false;
+    }
+    return true;
+}
+
+enum Mode {
+    MODE_NO_CACHE,
+    MODE_HIT,
+    MODE_MISS,
+    MODE_SHARED_HIT,
+};
+
+// ns per request
+static double run(Mode mode, int count, UriCacheStats& stats) {
+    int fds[2];
+    if (!test::makeSocketPair(fds)) {
+        return 0;
+    }
+    Connection conn(fds[0]);
+    Connection client(fds[1]);
+    client.setStatus(CONN_STATUS_OK);
+
+    Codec codec;
+    std::static_pointer_cast<pb::Dispatcher>(
+        codec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher())
+        ->registerCallback<EchoReq, EchoRsp>(onEchoReq);
+    ResponseCache cache;
+    cache.setCacheableCheck([&codec](uint32_t uri) {
+        return codec.isCacheableUri(uri);
+    });
+    ShmCache shared;
+    if (MODE_SHARED_HIT == mode) {
+        shared.create(ShmCacheOption());
+        cache.setSharedCache(&shared);
+    }
+    if (MODE_NO_CACHE != mode) {
+        UriCache uriCache;
+        uriCache.ttlMs_ = 60000;
+        uriCache.maxBytes_ = MODE_MISS == mode ? 64 << 10 : 16 << 20;
+        uriCache.isShared_ = MODE_SHARED_HIT == mode;
+        if (!cache.setUri(EchoReq::URI, uriCache)) {
+            cout << "setUri failed!" << endl;
+            return 0;
+        }
+        codec.setResponseCache(&cache);
+    }
+
+    // reads of depth frames, FRAME_NUM in all
+    const int depth = 32;
+    vector<string> reads;
+    for (int i = 0; i < FRAME_NUM; i += depth) {
+        string frames;
+        for (int n = i; n < i + depth; n++) {
+            bool isHit = MODE_HIT == mode || MODE_SHARED_HIT == mode;
+            frames += makeFrame(isHit ? 0 : n, n);
+        }
+        reads.push_back(frames);
+    }
+
+    int seq = 0;
+    int rspSeq = 0;
+    int rspNum = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int i = 0; i < count; i += depth, seq += depth) {
+        const string& frames = reads[(i / depth) % reads.size()];
+        send(fds[1], frames.data(), frames.size(), 0);
+        conn.tcpRecv();
+        codec.processMessage(&conn);
+        int num = drain(client, rspSeq);
+        if (num < 0) {
+            cout << "wrong response!" << endl;
+            break;
+        }
+        rspNum += num;
+    }
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    if (rspNum != seq) {
+        printf("responses:%d of %d!\n", rspNum, seq);
+    }
+    if (cache.find(EchoReq::URI)) {
+        stats = cache.find(EchoReq::URI)->getStats();
+    }
+    return (double)ns / seq;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        cout << "usage:" << argv[0] << " [requests] [handlerUs]" << endl;
+        return -1;
+    }
+
+    int count = atoi(argv[1]);
+    g_handlerNs = atoi(argv[2]) * 1000;
+
+    // the response of a pool callback is sent after dispatch returns
+    Codec poolCodec;
+    std::static_pointer_cast<pb::Dispatcher>(
+        poolCodec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher())
+        ->registerCallback<EchoReq, EchoRsp>(onEchoReq, CALLBACK_MODE_POOL);
+    ResponseCache poolCache;
+    poolCache.setCacheableCheck([&poolCodec](uint32_t uri) {
+        return poolCodec.isCacheableUri(uri);
+    });
+    if (poolCache.setUri(EchoReq::URI, UriCache())) {
+        cout << "a pool uri is cached!" << endl;
+        return -1;
+    }
+    if (!checkIntercepted()) {
+        return -1;
+    }
+
+    struct Row {
+        const char* name;
+        Mode mode;
+    } rows[] = {
+        {"no cache", MODE_NO_CACHE},
+        {"hit", MODE_HIT},
+        {"miss", MODE_MISS},
+        {"shared hit", MODE_SHARED_HIT},
+    };
+    printf("handlerUs:%d\n", atoi(argv[2]));
+    for (Row& row : rows) {
+        UriCacheStats stats;
+        // warm up
+        run(row.mode, count / 10 + 1, stats);
+        double ns = run(row.mode, count, stats);
+        printf("%-10s ns/req:%8.1f  hits:%lu misses:%lu evictions:%lu\n",
+            row.name, ns, (unsigned long)stats.hits,
+            (unsigned long)stats.misses, (unsigned long)stats.evictions);
+    }
+    return 0;
+}
+
+/*
+
+(-O2, 1 cpu)
+$ ./exe_cache_bench 300000 0
+handlerUs:0
+no cache   ns/req:  3372.3  hits:0 misses:0 evictions:0
+hit        ns/req:  2488.8  hits:299999 misses:1 evictions:0
+miss       ns/req:  3883.1  hits:0 misses:300000 evictions:299632
+shared hit ns/req:  2214.7  hits:299999 misses:1 evictions:0
+$ ./exe_cache_bench 300000 5
+handlerUs:5
+no cache   ns/req:  9320.4  hits:0 misses:0 evictions:0
+hit        ns/req:  2464.0  hits:299999 misses:1 evictions:0
+miss       ns/req:  9345.9  hits:0 misses:300000 evictions:299632
+shared hit ns/req:  2703.8  hits:299999 misses:1 evictions:0
+
+a hit is the hash, a compare of the body and the send. a miss that is
+put and evicted at once costs 10-20% on top, the copies of the request
+and the response: cache uris that do repeat. a shared hit, uncontended,
+is within the noise of a local one: the key is built and the response
+copied out, and a shard lock is taken. what it buys is one entry for all
+workers instead of one per worker.
+
+ */
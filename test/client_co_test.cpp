@@ -0,0 +1,110 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// build with -std=c++20, see makefile
+
+#include "client/co_channel.h"
+#include "proto_pb/echo.pb.h"
+#include "proto_cc/book.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+static int iSuccCnt = 0;
+static int iFailCnt = 0;
+static int iRunning = 0;
+
+// dependent calls: each step needs the previous response
+co::Task<void> chain(Poller* poller, std::shared_ptr<co::CoChannel> channel,
+                     int id, int rounds) {
+    for (int i = 0; i < rounds; i++) {
+        EchoReq req;
+        req.set_sid(to_string(id));
+        req.set_loginid(i % 2 + 1);
+        req.set_info("hello");
+
+        std::shared_ptr<EchoRsp> rsp = co_await channel->call<EchoReq, EchoRsp>(req);
+        if (!rsp) {
+            iFailCnt++;
+            continue;
+        }
+        iSuccCnt++;
+
+        BookReq bookReq;
+        bookReq.name = rsp->info();
+        bookReq.age = id;
+        std::shared_ptr<BookRsp> bookRsp = co_await channel->call<BookReq, BookRsp>(bookReq);
+        bookRsp ? iSuccCnt++ : iFailCnt++;
+    }
+
+    // fan out, then wait for all
+    EchoReq req;
+    req.set_sid(to_string(id));
+    req.set_loginid(1);
+    auto a = channel->call<EchoReq, EchoRsp>(req);
+    auto b = channel->call<EchoReq, EchoRsp>(req);
+    co_await co::sleepFor(poller, 1);
+    std::shared_ptr<EchoRsp> ra = co_await a;
+    std::shared_ptr<EchoRsp> rb = co_await b;
+    (ra && rb) ? iSuccCnt++ : iFailCnt++;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 5) {
+        cout << "usage:" << argv[0] << " [coroutine num] [rounds] [ip] [port]"
+            << endl;
+        return -1;
+    }
+
+    int coNum = atoi(argv[1]);
+    int rounds = atoi(argv[2]);
+    ServiceAddrOption serviceAddrOption;
+    serviceAddrOption.ip_ = argv[3];
+    serviceAddrOption.port_ = atoi(argv[4]);
+
+    ClientOptions opt;
+    opt.connectTimeoutMs = 3000;
+    opt.setServiceAddrOption(serviceAddrOption);
+
+    Poller poller(Poller::MAX_FD);
+    auto channel = co::CoChannel::create(&poller, opt);
+    if (!channel) {
+        cout << "connect failed!" << endl;
+        return -1;
+    }
+
+    auto begin = chrono::steady_clock::now();
+
+    // all coroutines share one connection and one thread
+    for (int i = 0; i < coNum; i++) {
+        iRunning++;
+        co::spawn(chain(&poller, channel, i, rounds), [&poller]() {
+            if (--iRunning == 0) {
+                poller.stop();
+            }
+        });
+    }
+
+    poller.runLoop();
+
+    auto ms = chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now() - begin).count();
+    cout << "coroutine:" << coNum << ",succ:" << iSuccCnt
+        << ",fail:" << iFailCnt << ",elapsed ms:" << ms << endl;
+
+    return 0;
+}
+
+/*
+
+server:
+$ ./exe_server_test 1 127.0.0.1 8900
+
+client:
+$ ./exe_client_co_test 1000 10 127.0.0.1 8900
+
+ */
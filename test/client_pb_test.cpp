@@ -8,6 +8,7 @@
 #include "proto_pb/hello.pb.h"
 #include <iostream>
 #include <chrono>
+#include <thread>
 
 using namespace std;
 using namespace tinyrpc;
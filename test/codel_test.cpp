@@ -0,0 +1,184 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// CoDel admission{target:5ms, interval:20ms} of the worker side(Codec,
+// inline EchoReq handler) on a loopback tcp conn. the client sends 4 frames
+// per round, they wait [age] ms in the socket before the worker reads them:
+//   age 0:  admitted
+//   age 10: above target, the interval starts, still admitted
+//   age 25: above target for the whole interval, CONGESTED
+//   age 0:  the queue drained, admitted again
+// the sojourn is seen only through the kernel receive time(SO_TIMESTAMP).
+// a frame sent in two segments 25ms apart and read by two reads keeps the
+// stamp of its first segment.
+
+#include "codec.h"
+#include "codel.h"
+#include "connection.h"
+#include "test_util.h"
+#include "proto_pb/echo.pb.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    rsp->set_retcode(1);
+    rsp->set_sid(req->sid());
+}
+
+static string makeFrame(int seq) {
+    EchoReq req;
+    req.set_sid(to_string(seq));
+    return test::packPbFrame(req, "req-" + to_string(seq));
+}
+
+// a connected pair on 127.0.0.1, both non-blocking and TCP_NODELAY
+static bool tcpPair(int& srvFd, int& cliFd) {
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr*)&addr, len) < 0 ||
+        listen(listenFd, 1) < 0 ||
+        getsockname(listenFd, (struct sockaddr*)&addr, &len) < 0) {
+        return false;
+    }
+    cliFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (cliFd < 0 || connect(cliFd, (struct sockaddr*)&addr, len) < 0) {
+        return false;
+    }
+    srvFd = accept(listenFd, nullptr, nullptr);
+    close(listenFd);
+    if (srvFd < 0) {
+        return false;
+    }
+    int on = 1;
+    for (int fd : {srvFd, cliFd}) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    return true;
+}
+
+struct Result {
+    int rspNum;
+    int congestedNum;
+};
+
+// 4 frames wait ageMs in the socket, then one read of the worker
+static Result runRound(Connection& conn, Connection& client, Codec& codec,
+                       int ageMs) {
+    static int seq = 0;
+    string frames;
+    for (int i = 0; i < 4; i++) {
+        frames += makeFrame(seq++);
+    }
+    send(client.getFd(), frames.data(), frames.size(), 0);
+    usleep(ageMs * 1000);
+    conn.tcpRecv();
+    codec.processMessage(&conn);
+
+    // loopback: the responses are there by now
+    usleep(1000);
+    Result result = {0, 0};
+    client.tcpRecv();
+    while (true) {
+        ProtocolHead head;
+        char* package = nullptr;
+        uint32_t packageSize = 0;
+        if (codec.unpack(&client, head, &package, packageSize) <= 0) {
+            break;
+        }
+        if (PROTOCOL_URI_CONGESTED == head.protocolUri) {
+            result.congestedNum++;
+        } else if (EchoRsp::URI == head.protocolUri) {
+            result.rspNum++;
+        }
+    }
+    printf("age %2dms: responses:%d congested:%d\n", ageMs, result.rspNum,
+        result.congestedNum);
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    int srvFd = -1;
+    int cliFd = -1;
+    if (!tcpPair(srvFd, cliFd)) {
+        cout << "tcp pair failed!" << endl;
+        return -1;
+    }
+    Connection conn(srvFd);
+    conn.setStatus(CONN_STATUS_OK);
+    CHECK(conn.enableRxTimestamp());
+    Connection client(cliFd);
+    client.setStatus(CONN_STATUS_OK);
+
+    CoDel codel(5000, 20000);
+    Codec codec;
+    codec.setAdmission(&codel);
+    std::static_pointer_cast<pb::Dispatcher>(
+        codec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher())
+        ->registerCallback<EchoReq, EchoRsp>(onEchoReq);
+
+    Result r = runRound(conn, client, codec, 0);
+    CHECK(r.rspNum == 4 && r.congestedNum == 0);
+
+    // a burst worked off within the interval goes through whole
+    r = runRound(conn, client, codec, 10);
+    CHECK(r.rspNum == 4 && r.congestedNum == 0);
+    CHECK(!codel.isCongested());
+
+    r = runRound(conn, client, codec, 25);
+    CHECK(r.rspNum == 0 && r.congestedNum == 4);
+    CHECK(codel.isCongested() && codel.getCongestedNum() == 1);
+    CHECK(codel.getRejectedNum() == 4);
+
+    r = runRound(conn, client, codec, 0);
+    CHECK(r.rspNum == 4 && r.congestedNum == 0);
+    CHECK(!codel.isCongested());
+
+    // loopback tcp merges segments queued before a read into one skb
+    // stamped with the newest, so the segments are read one by one
+    string frame = makeFrame(100);
+    size_t half = frame.size() / 2;
+    send(cliFd, frame.data(), half, 0);
+    usleep(1000);
+    conn.tcpRecv();
+    int64_t firstRxUs = conn.getRxUs();
+    usleep(25 * 1000);
+    send(cliFd, frame.data() + half, frame.size() - half, 0);
+    usleep(1000);
+    conn.tcpRecv();
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t nowUs = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+    printf("split frame: waited %ldus\n", (long)(nowUs - conn.getRxUs()));
+    CHECK(conn.getRxUs() == firstRxUs);
+    CHECK(nowUs - conn.getRxUs() >= 25000);
+    codec.processMessage(&conn);
+    usleep(1000);
+    test::drainFd(cliFd);
+
+    // rcvbuf drained: the next read is stamped anew
+    r = runRound(conn, client, codec, 0);
+    CHECK(r.rspNum == 4 && r.congestedNum == 0);
+    CHECK(conn.getRxUs() >= firstRxUs + 25000);
+
+    return test::report();
+}
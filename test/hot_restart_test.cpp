@@ -0,0 +1,198 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// restart a server under a stream of short conns(connect, call, close),
+// once by HotRestartOption(the new server takes over the listenfd, the old
+// one drains) and once cold(SIGTERM, then start again). reports the calls
+// that failed and which generation served the rest.
+
+#include "server.h"
+#include "client/client_pb.h"
+#include "proto_pb/echo.pb.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+struct BenchStrategy {
+    const char* name;
+    AcceptStrategy strategy;
+};
+
+static int generation = 0;
+
+// answer with the generation of the server
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    rsp->set_retcode(1);
+    rsp->set_sid(to_string(generation));
+}
+
+// waitFd >= 0: the server starts when a byte is read from it, it is forked
+// before the client threads(no fork from a multi-threaded process)
+static pid_t startServer(AcceptStrategy strategy, int gen, int port,
+                         int waitFd = -1) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    generation = gen;
+
+    char c;
+    if (waitFd >= 0 && read(waitFd, &c, 1) != 1) {
+        _exit(1);
+    }
+
+    ServiceAddrOption serviceAddrOption;
+    serviceAddrOption.ip_ = "127.0.0.1";
+    serviceAddrOption.port_ = port;
+    serviceAddrOption.isIPv6_ = false;
+
+    CommonOption commonOption;
+    commonOption.workerNum_ = 2;
+    commonOption.idleTimeout_ = 600;
+    commonOption.maxConnNum_ = 10000;
+
+    AcceptOption acceptOption;
+    acceptOption.strategy_ = strategy;
+
+    HotRestartOption hotRestartOption;
+    hotRestartOption.enable_ = true;
+    hotRestartOption.drainTimeoutSec_ = 5;
+
+    vector<option> vecOpt;
+    vecOpt.push_back(ServerOptions::createServiceAddrOption(serviceAddrOption));
+    vecOpt.push_back(ServerOptions::createCommonOption(commonOption));
+    vecOpt.push_back(ServerOptions::createAcceptOption(acceptOption));
+    vecOpt.push_back(ServerOptions::createHotRestartOption(hotRestartOption));
+
+    {
+        Server srv(vecOpt);
+        srv.pbRegisterCallback<EchoReq, EchoRsp>(onEchoReq);
+        srv.run();
+    }
+    _exit(0);
+}
+
+static void stopServer(pid_t pid) {
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+static void runRestart(const BenchStrategy& bs, bool isHot, int threadNum,
+                       int port) {
+    ClientOptions opt;
+    opt.serviceAddrOption.ip_ = "127.0.0.1";
+    opt.serviceAddrOption.port_ = port;
+    opt.connectTimeoutMs = 1000;
+
+    pid_t oldPid = startServer(bs.strategy, 1, port);
+    int startPipe[2];
+    if (pipe(startPipe) < 0) {
+        cout << "pipe failed:" << strerror(errno) << endl;
+        return;
+    }
+    pid_t newPid = startServer(bs.strategy, 2, port, startPipe[0]);
+    close(startPipe[0]);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    std::atomic<bool> isStop(false);
+    std::atomic<int> okCnt[3] = {{0}, {0}, {0}};
+    std::atomic<int> connectFail(0);
+    std::atomic<int> callFail(0);
+
+    auto storm = [&]() {
+        EchoReq req;
+        req.set_sid("restart");
+        std::shared_ptr<EchoRsp> rsp;
+        while (!isStop) {
+            PbClient client(opt);
+            if (!client.isOk()) {
+                connectFail++;
+                continue;
+            }
+            if (!client.synCall<EchoReq, EchoRsp>(req, rsp)) {
+                callFail++;
+                continue;
+            }
+            int gen = atoi(rsp->sid().c_str());
+            okCnt[gen >= 1 && gen <= 2 ? gen : 0]++;
+        }
+    };
+
+    vector<std::thread> threads;
+    for (int i = 0; i < threadNum; i++) {
+        threads.emplace_back(storm);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+    // restart
+    auto begin = chrono::steady_clock::now();
+    if (isHot) {
+        (void)!write(startPipe[1], "s", 1);
+        // the old watcher exits once its workers drained
+        waitpid(oldPid, nullptr, 0);
+    } else {
+        stopServer(oldPid);
+        (void)!write(startPipe[1], "s", 1);
+    }
+    close(startPipe[1]);
+    double sec = chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now() - begin).count() / 1e6;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    isStop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    stopServer(newPid);
+
+    printf("%-10s %-4s old exit after:%.3fs ok:%d(old:%d new:%d) "
+           "connect fail:%d call fail:%d\n", bs.name, isHot ? "hot" : "cold",
+           sec, okCnt[1] + okCnt[2], okCnt[1].load(), okCnt[2].load(),
+           connectFail.load(), callFail.load());
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        cout << "usage:" << argv[0] << " [client threads] [port]" << endl;
+        return -1;
+    }
+
+    int threadNum = atoi(argv[1]);
+    int port = atoi(argv[2]);
+
+    BenchStrategy strategies[] = {
+        {"reuseport", ACCEPT_STRATEGY_REUSEPORT},
+        {"exclusive", ACCEPT_STRATEGY_EXCLUSIVE},
+        {"semlock", ACCEPT_STRATEGY_SEMLOCK},
+        {"watcher", ACCEPT_STRATEGY_WATCHER},
+    };
+
+    for (const BenchStrategy& bs : strategies) {
+        runRestart(bs, true, threadNum, port);
+        runRestart(bs, false, threadNum, port);
+    }
+
+    return 0;
+}
+
+/*
+
+$ ./exe_hot_restart_test 4 8950
+
+a cold restart refuses conns between the old server's exit and the new
+server's listen. a hot restart should report no failed call.
+
+ */
@@ -0,0 +1,206 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// ping-pong latency of one connection: default loop vs busy poll loop, and
+// a worker pinned to a cpu with its memory on that cpu's node, and the cost
+// of LoopStats on the default loop, and the handler on a HandlerPool thread
+// instead of the I/O loop.
+// for each mode a server(1 worker) is forked, then measured by a sync client.
+
+#include "server.h"
+#include "client/client_pb.h"
+#include "proto_pb/echo.pb.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+struct BenchMode {
+    const char* name;
+    BusyPollOption busyPoll;
+    LoopStatsOption loopStats;
+    CpuAffinity cpuAffinity = CPU_AFFINITY_NONE;
+    bool numaBind = false;
+    CallbackMode callbackMode = CALLBACK_MODE_INLINE;
+};
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    rsp->set_retcode(1);
+    rsp->set_sid(req->sid());
+    rsp->set_info(req->info());
+}
+
+static pid_t startServer(const BenchMode& mode, int port) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    // own process group, watcher and worker are killed together
+    setpgid(0, 0);
+
+    ServiceAddrOption serviceAddrOption;
+    serviceAddrOption.ip_ = "127.0.0.1";
+    serviceAddrOption.port_ = port;
+    serviceAddrOption.isIPv6_ = false;
+
+    CommonOption commonOption;
+    commonOption.workerNum_ = 1;
+    commonOption.idleTimeout_ = 600;
+    commonOption.maxConnNum_ = 1024;
+    commonOption.cpuAffinity_ = mode.cpuAffinity;
+    commonOption.numaBind_ = mode.numaBind;
+
+    vector<option> vecOpt;
+    vecOpt.push_back(ServerOptions::createServiceAddrOption(serviceAddrOption));
+    vecOpt.push_back(ServerOptions::createCommonOption(commonOption));
+    vecOpt.push_back(ServerOptions::createBusyPollOption(mode.busyPoll));
+    vecOpt.push_back(ServerOptions::createLoopStatsOption(mode.loopStats));
+
+    Server srv(vecOpt);
+    srv.pbRegisterCallback<EchoReq, EchoRsp>(onEchoReq, mode.callbackMode);
+    srv.run();
+    _exit(0);
+}
+
+static void stopServer(pid_t pid) {
+    kill(-pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+}
+
+static void runMode(const BenchMode& mode, int requests, int gapUs, int port) {
+    pid_t pid = startServer(mode, port);
+
+    ClientOptions opt;
+    opt.serviceAddrOption.ip_ = "127.0.0.1";
+    opt.serviceAddrOption.port_ = port;
+
+    // wait for the worker to listen
+    std::unique_ptr<PbClient> client;
+    for (int i = 0; i < 50; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        client.reset(new PbClient(opt));
+        if (client->isOk()) {
+            break;
+        }
+    }
+    if (!client->isOk()) {
+        cout << mode.name << ": connect failed!" << endl;
+        stopServer(pid);
+        return;
+    }
+
+    EchoReq req;
+    req.set_sid("bench");
+    req.set_info("ping");
+    std::shared_ptr<EchoRsp> rsp;
+
+    // warm up
+    for (int i = 0; i < 1000; i++) {
+        client->synCall<EchoReq, EchoRsp>(req, rsp);
+    }
+
+    vector<int64_t> latency;
+    latency.reserve(requests);
+    int failCnt = 0;
+    for (int i = 0; i < requests; i++) {
+        if (gapUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(gapUs));
+        }
+        auto begin = chrono::steady_clock::now();
+        if (!client->synCall<EchoReq, EchoRsp>(req, rsp)) {
+            failCnt++;
+            continue;
+        }
+        latency.push_back(chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - begin).count());
+    }
+
+    client.reset();
+    stopServer(pid);
+
+    if (latency.empty()) {
+        cout << mode.name << ": all failed!" << endl;
+        return;
+    }
+
+    sort(latency.begin(), latency.end());
+    int64_t sum = 0;
+    for (int64_t ns : latency) {
+        sum += ns;
+    }
+    auto pct = [&latency](double p) {
+        return latency[std::min(latency.size() - 1,
+                                (size_t)(latency.size() * p))] / 1000.0;
+    };
+
+    printf("%-24s avg:%8.1fus p50:%8.1fus p90:%8.1fus p99:%8.1fus "
+           "p999:%8.1fus fail:%d\n", mode.name,
+           sum / 1000.0 / latency.size(), pct(0.5), pct(0.9), pct(0.99),
+           pct(0.999), failCnt);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        cout << "usage:" << argv[0] << " [requests] [gap us] [port]" << endl;
+        return -1;
+    }
+
+    int requests = atoi(argv[1]);
+    int gapUs = atoi(argv[2]);
+    int port = atoi(argv[3]);
+
+    vector<BenchMode> modes(6);
+    modes[0].name = "default(10ms timeout)";
+
+    modes[1].name = "busy poll";
+    modes[1].busyPoll.enable_ = true;
+
+    modes[2].name = "busy poll+SO_BUSY_POLL";
+    modes[2].busyPoll.enable_ = true;
+    modes[2].busyPoll.sockBusyPollUs_ = 50;
+    modes[2].busyPoll.preferBusyPoll_ = true;
+
+    // worker 0 on the first allowed cpu, its memory from that cpu's node
+    modes[3].name = "pinned+numa bind";
+    modes[3].cpuAffinity = CPU_AFFINITY_AUTO;
+    modes[3].numaBind = true;
+
+    // cat /tmp/tinyrpc_loop_stats.0 while it runs
+    modes[4].name = "default+loop stats";
+    modes[4].loopStats.enable_ = true;
+    modes[4].loopStats.dumpIntervalMs_ = 1000;
+
+    // the hand-off to a pool thread and the response back to the loop
+    modes[5].name = "default+pool callback";
+    modes[5].callbackMode = CALLBACK_MODE_POOL;
+
+    for (const BenchMode& mode : modes) {
+        runMode(mode, requests, gapUs, port);
+    }
+
+    return 0;
+}
+
+/*
+
+each mode burns one core in the worker while it spins, run on a machine
+with spare cores, and pin the client if possible:
+
+$ ./exe_latency_bench 100000 0 8920
+$ ./exe_latency_bench 20000 100 8920   # 100us between requests
+
+SO_BUSY_POLL larger than net.core.busy_read needs CAP_NET_ADMIN, it only
+helps on a real NIC, not on loopback.
+
+ */
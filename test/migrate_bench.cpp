@@ -0,0 +1,240 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// long-lived conns with skewed load: 2 workers, ACCEPT_STRATEGY_WATCHER
+// spreads 2N conns N/N, then only the N conns of one worker send requests
+// (closed loop, the handler burns cpu). run with and without MigrateOption,
+// reports the latency of the first and the last second and where the busy
+// conns are served at the end.
+
+#include "server.h"
+#include "client/client_pb.h"
+#include "proto_pb/echo.pb.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+static int spinUs = 200;
+
+// burn cpu, answer with the pid of the worker
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    auto end = chrono::steady_clock::now() + chrono::microseconds(spinUs);
+    while (chrono::steady_clock::now() < end) {
+    }
+    rsp->set_retcode(1);
+    rsp->set_sid(to_string(getpid()));
+}
+
+static pid_t startServer(bool isMigrate, int port) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    ServiceAddrOption serviceAddrOption;
+    serviceAddrOption.ip_ = "127.0.0.1";
+    serviceAddrOption.port_ = port;
+    serviceAddrOption.isIPv6_ = false;
+
+    CommonOption commonOption;
+    commonOption.workerNum_ = 2;
+    commonOption.idleTimeout_ = 600;
+
+    AcceptOption acceptOption;
+    acceptOption.strategy_ = ACCEPT_STRATEGY_WATCHER;
+
+    MigrateOption migrateOption;
+    migrateOption.enable_ = isMigrate;
+
+    vector<option> vecOpt;
+    vecOpt.push_back(ServerOptions::createServiceAddrOption(serviceAddrOption));
+    vecOpt.push_back(ServerOptions::createCommonOption(commonOption));
+    vecOpt.push_back(ServerOptions::createAcceptOption(acceptOption));
+    vecOpt.push_back(ServerOptions::createMigrateOption(migrateOption));
+
+    {
+        Server srv(vecOpt);
+        srv.pbRegisterCallback<EchoReq, EchoRsp>(onEchoReq);
+        srv.run();
+    }
+    _exit(0);
+}
+
+static void stopServer(pid_t pid) {
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+static bool waitServer(const ClientOptions& opt) {
+    for (int i = 0; i < 50; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        PbClient client(opt);
+        if (client.isOk()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// latencies(us) of one second
+struct Window {
+    vector<int64_t> lats;
+
+    void print(const char* name) {
+        if (lats.empty()) {
+            printf(" %s none |", name);
+            return;
+        }
+        sort(lats.begin(), lats.end());
+        int64_t sum = 0;
+        for (int64_t lat : lats) {
+            sum += lat;
+        }
+        printf(" %s reqs:%zu avg:%ldus p99:%ldus |", name, lats.size(),
+            sum / (int64_t)lats.size(), lats[lats.size() * 99 / 100]);
+    }
+};
+
+static void runBench(bool isMigrate, int busyNum, int durationSec, int port) {
+    pid_t pid = startServer(isMigrate, port);
+
+    ClientOptions opt;
+    opt.serviceAddrOption.ip_ = "127.0.0.1";
+    opt.serviceAddrOption.port_ = port;
+    if (!waitServer(opt)) {
+        cout << "server is not ready!" << endl;
+        stopServer(pid);
+        return;
+    }
+    // let the probe conn be closed
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    EchoReq req;
+    req.set_sid("migrate");
+    std::shared_ptr<EchoRsp> rsp;
+
+    // least conns: every other conn on the same worker
+    vector<unique_ptr<PbClient>> clients;
+    vector<unique_ptr<PbClient>> busyClients;
+    string busyPid;
+    for (int i = 0; i < busyNum * 2; i++) {
+        unique_ptr<PbClient> client(new PbClient(opt));
+        if (!client->isOk() || !client->synCall<EchoReq, EchoRsp>(req, rsp)) {
+            cout << "conn " << i << " failed" << endl;
+            continue;
+        }
+        if (busyPid.empty()) {
+            busyPid = rsp->sid();
+        }
+        if (rsp->sid() == busyPid) {
+            busyClients.push_back(std::move(client));
+        } else {
+            clients.push_back(std::move(client));
+        }
+    }
+
+    vector<Window> firstSec(busyClients.size());
+    vector<Window> lastSec(busyClients.size());
+    vector<string> lastPid(busyClients.size());
+    auto begin = chrono::steady_clock::now();
+    auto end = begin + chrono::seconds(durationSec);
+
+    vector<std::thread> threads;
+    for (size_t i = 0; i < busyClients.size(); i++) {
+        threads.emplace_back([&, i]() {
+            EchoReq req;
+            req.set_sid("migrate");
+            std::shared_ptr<EchoRsp> rsp;
+            while (true) {
+                auto t0 = chrono::steady_clock::now();
+                if (t0 >= end) {
+                    break;
+                }
+                if (!busyClients[i]->synCall<EchoReq, EchoRsp>(req, rsp)) {
+                    continue;
+                }
+                auto t1 = chrono::steady_clock::now();
+                int64_t lat = chrono::duration_cast<chrono::microseconds>(
+                    t1 - t0).count();
+                if (t0 < begin + chrono::seconds(1)) {
+                    firstSec[i].lats.push_back(lat);
+                } else if (t0 >= end - chrono::seconds(1)) {
+                    lastSec[i].lats.push_back(lat);
+                }
+                lastPid[i] = rsp->sid();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    Window first;
+    Window last;
+    map<string, int> busyPerWorker;
+    for (size_t i = 0; i < busyClients.size(); i++) {
+        first.lats.insert(first.lats.end(), firstSec[i].lats.begin(),
+            firstSec[i].lats.end());
+        last.lats.insert(last.lats.end(), lastSec[i].lats.begin(),
+            lastSec[i].lats.end());
+        busyPerWorker[lastPid[i]]++;
+    }
+
+    busyClients.clear();
+    clients.clear();
+    stopServer(pid);
+
+    printf("migrate %-3s |", isMigrate ? "on" : "off");
+    first.print("first 1s");
+    last.print("last 1s");
+    printf(" busy conns per worker:");
+    for (auto& it : busyPerWorker) {
+        printf(" %s:%d", it.first.c_str(), it.second);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 5) {
+        cout << "usage:" << argv[0]
+            << " [busy conns] [handler spin us] [seconds] [port]" << endl;
+        return -1;
+    }
+
+    int busyNum = atoi(argv[1]);
+    spinUs = atoi(argv[2]);
+    int durationSec = atoi(argv[3]);
+    int port = atoi(argv[4]);
+    if (durationSec < 2) {
+        durationSec = 2;
+    }
+
+    runBench(false, busyNum, durationSec, port);
+    runBench(true, busyNum, durationSec, port);
+
+    return 0;
+}
+
+/*
+
+$ ./exe_migrate_bench 4 200 6 8970
+
+without migration the busy conns share one worker: latency is about
+busy conns * spin us. with it half of them move within a few intervals
+(MigrateOption::intervalMs_) and the latency halves, no reconnect.
+
+ */
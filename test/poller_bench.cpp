@@ -0,0 +1,150 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// cost of dispatching one event in Poller:
+//   callback: std::function per fd + fd -> conn hash lookup(the old
+//             Server::onAccept lambdas)
+//   handler:  epoll data.ptr -> EventHandler, one virtual call
+// every fd stays readable(level triggered, never read), so each epoll_wait
+// returns all of them and the loop is pure dispatch.
+
+#include "poller.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <stdio.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+using namespace tinyrpc;
+
+static uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct FakeConn {
+    uint64_t readCnt;
+    FakeConn() : readCnt(0) {}
+};
+
+class CountHandler : public EventHandler {
+public:
+    CountHandler(Poller* poller, uint64_t* total, uint64_t target)
+        : poller_(poller), total_(total), target_(target), readCnt_(0) {}
+
+    void handleRead(int fd, int events) override {
+        readCnt_++;
+        if (++*total_ >= target_) {
+            poller_->stop();
+        }
+    }
+    void handleWrite(int fd, int events) override {}
+
+private:
+    Poller* poller_;
+    uint64_t* total_;
+    uint64_t target_;
+    uint64_t readCnt_;
+};
+
+static void report(const char* name, uint64_t events, uint64_t ns,
+                   uint64_t cycles) {
+    printf("%-10s events:%lu ns/event:%.1f cycles/event:%.1f\n", name,
+           (unsigned long)events, (double)ns / events,
+           (double)cycles / events);
+}
+
+static void runCallback(const vector<int>& fds, uint64_t target) {
+    Poller poller(Poller::MAX_FD);
+    unordered_map<int, shared_ptr<FakeConn>> connMap;
+    uint64_t total = 0;
+
+    for (int fd : fds) {
+        connMap[fd] = make_shared<FakeConn>();
+        poller.setFdReadCallback(fd,
+            [&connMap, &total, &poller, target](int fd, int events, void*) {
+                connMap[fd]->readCnt++;
+                if (++total >= target) {
+                    poller.stop();
+                }
+            }, nullptr);
+        poller.addFd(fd, EV_READ);
+    }
+
+    auto begin = chrono::steady_clock::now();
+    uint64_t c0 = readCycles();
+    poller.runLoop();
+    uint64_t cycles = readCycles() - c0;
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    report("callback", total, ns, cycles);
+}
+
+static void runHandler(const vector<int>& fds, uint64_t target) {
+    Poller poller(Poller::MAX_FD);
+    vector<unique_ptr<CountHandler>> handlers;
+    uint64_t total = 0;
+
+    for (int fd : fds) {
+        handlers.emplace_back(new CountHandler(&poller, &total, target));
+        poller.addHandler(fd, handlers.back().get(), EV_READ);
+    }
+
+    auto begin = chrono::steady_clock::now();
+    uint64_t c0 = readCycles();
+    poller.runLoop();
+    uint64_t cycles = readCycles() - c0;
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    report("handler", total, ns, cycles);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        cout << "usage:" << argv[0] << " [fd num] [events]" << endl;
+        return -1;
+    }
+
+    int fdNum = atoi(argv[1]);
+    uint64_t target = strtoull(argv[2], nullptr, 10);
+
+    vector<int> fds;
+    for (int i = 0; i < fdNum; i++) {
+        int fd = eventfd(1, EFD_NONBLOCK);
+        if (fd < 0 || fd >= Poller::MAX_FD) {
+            cout << "eventfd failed!" << endl;
+            return -1;
+        }
+        fds.push_back(fd);
+    }
+
+    // twice each, the first round warms up
+    for (int i = 0; i < 2; i++) {
+        runCallback(fds, target);
+        runHandler(fds, target);
+    }
+
+    for (int fd : fds) {
+        close(fd);
+    }
+    return 0;
+}
+
+/*
+
+$ ./exe_poller_bench 1000 10000000
+
+ns/event includes epoll_wait, spread over fd num events per wakeup
+
+ */
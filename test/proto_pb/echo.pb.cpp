@@ -0,0 +1,767 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: echo.proto
+
+#include "echo.pb.h"
+
+#include <algorithm>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/wire_format.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+
+PROTOBUF_PRAGMA_INIT_SEG
+
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
+
+namespace echo_proto {
+PROTOBUF_CONSTEXPR EchoReq::EchoReq(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.sid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.info_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.loginid_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct EchoReqDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR EchoReqDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~EchoReqDefaultTypeInternal() {}
+  union {
+    EchoReq _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 EchoReqDefaultTypeInternal _EchoReq_default_instance_;
+PROTOBUF_CONSTEXPR EchoRsp::EchoRsp(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.sid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.info_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.retcode_)*/0
+  , /*decltype(_impl_.loginid_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct EchoRspDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR EchoRspDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~EchoRspDefaultTypeInternal() {}
+  union {
+    EchoRsp _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 EchoRspDefaultTypeInternal _EchoRsp_default_instance_;
+}  // namespace echo_proto
+static ::_pb::Metadata file_level_metadata_echo_2eproto[2];
+static const ::_pb::EnumDescriptor* file_level_enum_descriptors_echo_2eproto[2];
+static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_echo_2eproto = nullptr;
+
+const uint32_t TableStruct_echo_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoReq, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoReq, _impl_.sid_),
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoReq, _impl_.loginid_),
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoReq, _impl_.info_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoRsp, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoRsp, _impl_.retcode_),
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoRsp, _impl_.sid_),
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoRsp, _impl_.loginid_),
+  PROTOBUF_FIELD_OFFSET(::echo_proto::EchoRsp, _impl_.info_),
+};
+static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  { 0, -1, -1, sizeof(::echo_proto::EchoReq)},
+  { 9, -1, -1, sizeof(::echo_proto::EchoRsp)},
+};
+
+static const ::_pb::Message* const file_default_instances[] = {
+  &::echo_proto::_EchoReq_default_instance_._instance,
+  &::echo_proto::_EchoRsp_default_instance_._instance,
+};
+
+const char descriptor_table_protodef_echo_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
+  "\n\necho.proto\022\necho_proto\"X\n\007EchoReq\022\013\n\003s"
+  "id\030\001 \001(\t\022\017\n\007loginId\030\002 \001(\005\022\014\n\004info\030\003 \001(\t\""
+  "!\n\003Uri\022\017\n\013PLACEHOLDER\020\000\022\t\n\003URI\020\344\366\001\"i\n\007Ec"
+  "hoRsp\022\017\n\007retCode\030\001 \001(\005\022\013\n\003sid\030\002 \001(\t\022\017\n\007l"
+  "oginId\030\003 \001(\005\022\014\n\004info\030\004 \001(\t\"!\n\003Uri\022\017\n\013PLA"
+  "CEHOLDER\020\000\022\t\n\003URI\020\345\366\0012\?\n\013EchoService\0220\n\004"
+  "Echo\022\023.echo_proto.EchoReq\032\023.echo_proto.E"
+  "choRspb\006proto3"
+  ;
+static ::_pbi::once_flag descriptor_table_echo_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_echo_2eproto = {
+    false, false, 294, descriptor_table_protodef_echo_2eproto,
+    "echo.proto",
+    &descriptor_table_echo_2eproto_once, nullptr, 0, 2,
+    schemas, file_default_instances, TableStruct_echo_2eproto::offsets,
+    file_level_metadata_echo_2eproto, file_level_enum_descriptors_echo_2eproto,
+    file_level_service_descriptors_echo_2eproto,
+};
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_echo_2eproto_getter() {
+  return &descriptor_table_echo_2eproto;
+}
+
+// Force running AddDescriptors() at dynamic initialization time.
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_echo_2eproto(&descriptor_table_echo_2eproto);
+namespace echo_proto {
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* EchoReq_Uri_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_echo_2eproto);
+  return file_level_enum_descriptors_echo_2eproto[0];
+}
+bool EchoReq_Uri_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 31588:
+      return true;
+    default:
+      return false;
+  }
+}
+
+#if (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+constexpr EchoReq_Uri EchoReq::PLACEHOLDER;
+constexpr EchoReq_Uri EchoReq::URI;
+constexpr EchoReq_Uri EchoReq::Uri_MIN;
+constexpr EchoReq_Uri EchoReq::Uri_MAX;
+constexpr int EchoReq::Uri_ARRAYSIZE;
+#endif  // (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* EchoRsp_Uri_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_echo_2eproto);
+  return file_level_enum_descriptors_echo_2eproto[1];
+}
+bool EchoRsp_Uri_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 31589:
+      return true;
+    default:
+      return false;
+  }
+}
+
+#if (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+constexpr EchoRsp_Uri EchoRsp::PLACEHOLDER;
+constexpr EchoRsp_Uri EchoRsp::URI;
+constexpr EchoRsp_Uri EchoRsp::Uri_MIN;
+constexpr EchoRsp_Uri EchoRsp::Uri_MAX;
+constexpr int EchoRsp::Uri_ARRAYSIZE;
+#endif  // (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
+
+// ===================================================================
+
+class EchoReq::_Internal {
+ public:
+};
+
+EchoReq::EchoReq(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:echo_proto.EchoReq)
+}
+EchoReq::EchoReq(const EchoReq& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  EchoReq* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.sid_){}
+    , decltype(_impl_.info_){}
+    , decltype(_impl_.loginid_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.sid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_sid().empty()) {
+    _this->_impl_.sid_.Set(from._internal_sid(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.info_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.info_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_info().empty()) {
+    _this->_impl_.info_.Set(from._internal_info(), 
+      _this->GetArenaForAllocation());
+  }
+  _this->_impl_.loginid_ = from._impl_.loginid_;
+  // @@protoc_insertion_point(copy_constructor:echo_proto.EchoReq)
+}
+
+inline void EchoReq::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.sid_){}
+    , decltype(_impl_.info_){}
+    , decltype(_impl_.loginid_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.sid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.info_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.info_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+EchoReq::~EchoReq() {
+  // @@protoc_insertion_point(destructor:echo_proto.EchoReq)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void EchoReq::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.sid_.Destroy();
+  _impl_.info_.Destroy();
+}
+
+void EchoReq::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void EchoReq::Clear() {
+// @@protoc_insertion_point(message_clear_start:echo_proto.EchoReq)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.sid_.ClearToEmpty();
+  _impl_.info_.ClearToEmpty();
+  _impl_.loginid_ = 0;
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* EchoReq::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string sid = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_sid();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "echo_proto.EchoReq.sid"));
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 loginId = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.loginid_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string info = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_info();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "echo_proto.EchoReq.info"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* EchoReq::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:echo_proto.EchoReq)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string sid = 1;
+  if (!this->_internal_sid().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_sid().data(), static_cast<int>(this->_internal_sid().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "echo_proto.EchoReq.sid");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_sid(), target);
+  }
+
+  // int32 loginId = 2;
+  if (this->_internal_loginid() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(2, this->_internal_loginid(), target);
+  }
+
+  // string info = 3;
+  if (!this->_internal_info().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_info().data(), static_cast<int>(this->_internal_info().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "echo_proto.EchoReq.info");
+    target = stream->WriteStringMaybeAliased(
+        3, this->_internal_info(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:echo_proto.EchoReq)
+  return target;
+}
+
+size_t EchoReq::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:echo_proto.EchoReq)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string sid = 1;
+  if (!this->_internal_sid().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_sid());
+  }
+
+  // string info = 3;
+  if (!this->_internal_info().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_info());
+  }
+
+  // int32 loginId = 2;
+  if (this->_internal_loginid() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_loginid());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData EchoReq::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    EchoReq::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*EchoReq::GetClassData() const { return &_class_data_; }
+
+
+void EchoReq::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<EchoReq*>(&to_msg);
+  auto& from = static_cast<const EchoReq&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:echo_proto.EchoReq)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_sid().empty()) {
+    _this->_internal_set_sid(from._internal_sid());
+  }
+  if (!from._internal_info().empty()) {
+    _this->_internal_set_info(from._internal_info());
+  }
+  if (from._internal_loginid() != 0) {
+    _this->_internal_set_loginid(from._internal_loginid());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void EchoReq::CopyFrom(const EchoReq& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:echo_proto.EchoReq)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool EchoReq::IsInitialized() const {
+  return true;
+}
+
+void EchoReq::InternalSwap(EchoReq* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.sid_, lhs_arena,
+      &other->_impl_.sid_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.info_, lhs_arena,
+      &other->_impl_.info_, rhs_arena
+  );
+  swap(_impl_.loginid_, other->_impl_.loginid_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata EchoReq::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_echo_2eproto_getter, &descriptor_table_echo_2eproto_once,
+      file_level_metadata_echo_2eproto[0]);
+}
+
+// ===================================================================
+
+class EchoRsp::_Internal {
+ public:
+};
+
+EchoRsp::EchoRsp(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:echo_proto.EchoRsp)
+}
+EchoRsp::EchoRsp(const EchoRsp& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  EchoRsp* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.sid_){}
+    , decltype(_impl_.info_){}
+    , decltype(_impl_.retcode_){}
+    , decltype(_impl_.loginid_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.sid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_sid().empty()) {
+    _this->_impl_.sid_.Set(from._internal_sid(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.info_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.info_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_info().empty()) {
+    _this->_impl_.info_.Set(from._internal_info(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.retcode_, &from._impl_.retcode_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.loginid_) -
+    reinterpret_cast<char*>(&_impl_.retcode_)) + sizeof(_impl_.loginid_));
+  // @@protoc_insertion_point(copy_constructor:echo_proto.EchoRsp)
+}
+
+inline void EchoRsp::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.sid_){}
+    , decltype(_impl_.info_){}
+    , decltype(_impl_.retcode_){0}
+    , decltype(_impl_.loginid_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.sid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.info_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.info_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+EchoRsp::~EchoRsp() {
+  // @@protoc_insertion_point(destructor:echo_proto.EchoRsp)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void EchoRsp::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.sid_.Destroy();
+  _impl_.info_.Destroy();
+}
+
+void EchoRsp::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void EchoRsp::Clear() {
+// @@protoc_insertion_point(message_clear_start:echo_proto.EchoRsp)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.sid_.ClearToEmpty();
+  _impl_.info_.ClearToEmpty();
+  ::memset(&_impl_.retcode_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.loginid_) -
+      reinterpret_cast<char*>(&_impl_.retcode_)) + sizeof(_impl_.loginid_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* EchoRsp::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // int32 retCode = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.retcode_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string sid = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_sid();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "echo_proto.EchoRsp.sid"));
+        } else
+          goto handle_unusual;
+        continue;
+      // int32 loginId = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.loginid_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string info = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          auto str = _internal_mutable_info();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "echo_proto.EchoRsp.info"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* EchoRsp::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:echo_proto.EchoRsp)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // int32 retCode = 1;
+  if (this->_internal_retcode() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(1, this->_internal_retcode(), target);
+  }
+
+  // string sid = 2;
+  if (!this->_internal_sid().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_sid().data(), static_cast<int>(this->_internal_sid().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "echo_proto.EchoRsp.sid");
+    target = stream->WriteStringMaybeAliased(
+        2, this->_internal_sid(), target);
+  }
+
+  // int32 loginId = 3;
+  if (this->_internal_loginid() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(3, this->_internal_loginid(), target);
+  }
+
+  // string info = 4;
+  if (!this->_internal_info().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_info().data(), static_cast<int>(this->_internal_info().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "echo_proto.EchoRsp.info");
+    target = stream->WriteStringMaybeAliased(
+        4, this->_internal_info(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:echo_proto.EchoRsp)
+  return target;
+}
+
+size_t EchoRsp::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:echo_proto.EchoRsp)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string sid = 2;
+  if (!this->_internal_sid().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_sid());
+  }
+
+  // string info = 4;
+  if (!this->_internal_info().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_info());
+  }
+
+  // int32 retCode = 1;
+  if (this->_internal_retcode() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_retcode());
+  }
+
+  // int32 loginId = 3;
+  if (this->_internal_loginid() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_loginid());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData EchoRsp::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    EchoRsp::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*EchoRsp::GetClassData() const { return &_class_data_; }
+
+
+void EchoRsp::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<EchoRsp*>(&to_msg);
+  auto& from = static_cast<const EchoRsp&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:echo_proto.EchoRsp)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_sid().empty()) {
+    _this->_internal_set_sid(from._internal_sid());
+  }
+  if (!from._internal_info().empty()) {
+    _this->_internal_set_info(from._internal_info());
+  }
+  if (from._internal_retcode() != 0) {
+    _this->_internal_set_retcode(from._internal_retcode());
+  }
+  if (from._internal_loginid() != 0) {
+    _this->_internal_set_loginid(from._internal_loginid());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void EchoRsp::CopyFrom(const EchoRsp& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:echo_proto.EchoRsp)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool EchoRsp::IsInitialized() const {
+  return true;
+}
+
+void EchoRsp::InternalSwap(EchoRsp* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.sid_, lhs_arena,
+      &other->_impl_.sid_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.info_, lhs_arena,
+      &other->_impl_.info_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(EchoRsp, _impl_.loginid_)
+      + sizeof(EchoRsp::_impl_.loginid_)
+      - PROTOBUF_FIELD_OFFSET(EchoRsp, _impl_.retcode_)>(
+          reinterpret_cast<char*>(&_impl_.retcode_),
+          reinterpret_cast<char*>(&other->_impl_.retcode_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata EchoRsp::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_echo_2eproto_getter, &descriptor_table_echo_2eproto_once,
+      file_level_metadata_echo_2eproto[1]);
+}
+
+// @@protoc_insertion_point(namespace_scope)
+}  // namespace echo_proto
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::echo_proto::EchoReq*
+Arena::CreateMaybeMessage< ::echo_proto::EchoReq >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::echo_proto::EchoReq >(arena);
+}
+template<> PROTOBUF_NOINLINE ::echo_proto::EchoRsp*
+Arena::CreateMaybeMessage< ::echo_proto::EchoRsp >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::echo_proto::EchoRsp >(arena);
+}
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+#include <google/protobuf/port_undef.inc>
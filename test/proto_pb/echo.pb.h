@@ -0,0 +1,846 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: echo.proto
+
+#ifndef GOOGLE_PROTOBUF_INCLUDED_echo_2eproto
+#define GOOGLE_PROTOBUF_INCLUDED_echo_2eproto
+
+#include <limits>
+#include <string>
+
+#include <google/protobuf/port_def.inc>
+#if PROTOBUF_VERSION < 3021000
+#error This file was generated by a newer version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please update
+#error your headers.
+#endif
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
+#error This file was generated by an older version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please
+#error regenerate this file with a newer version of protoc.
+#endif
+
+#include <google/protobuf/port_undef.inc>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/arenastring.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/metadata_lite.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>  // IWYU pragma: export
+#include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/generated_enum_reflection.h>
+#include <google/protobuf/unknown_field_set.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+#define PROTOBUF_INTERNAL_EXPORT_echo_2eproto
+PROTOBUF_NAMESPACE_OPEN
+namespace internal {
+class AnyMetadata;
+}  // namespace internal
+PROTOBUF_NAMESPACE_CLOSE
+
+// Internal implementation detail -- do not use these members.
+struct TableStruct_echo_2eproto {
+  static const uint32_t offsets[];
+};
+extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_echo_2eproto;
+namespace echo_proto {
+class EchoReq;
+struct EchoReqDefaultTypeInternal;
+extern EchoReqDefaultTypeInternal _EchoReq_default_instance_;
+class EchoRsp;
+struct EchoRspDefaultTypeInternal;
+extern EchoRspDefaultTypeInternal _EchoRsp_default_instance_;
+}  // namespace echo_proto
+PROTOBUF_NAMESPACE_OPEN
+template<> ::echo_proto::EchoReq* Arena::CreateMaybeMessage<::echo_proto::EchoReq>(Arena*);
+template<> ::echo_proto::EchoRsp* Arena::CreateMaybeMessage<::echo_proto::EchoRsp>(Arena*);
+PROTOBUF_NAMESPACE_CLOSE
+namespace echo_proto {
+
+enum EchoReq_Uri : int {
+  EchoReq_Uri_PLACEHOLDER = 0,
+  EchoReq_Uri_URI = 31588,
+  EchoReq_Uri_EchoReq_Uri_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  EchoReq_Uri_EchoReq_Uri_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool EchoReq_Uri_IsValid(int value);
+constexpr EchoReq_Uri EchoReq_Uri_Uri_MIN = EchoReq_Uri_PLACEHOLDER;
+constexpr EchoReq_Uri EchoReq_Uri_Uri_MAX = EchoReq_Uri_URI;
+constexpr int EchoReq_Uri_Uri_ARRAYSIZE = EchoReq_Uri_Uri_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* EchoReq_Uri_descriptor();
+template<typename T>
+inline const std::string& EchoReq_Uri_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, EchoReq_Uri>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function EchoReq_Uri_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    EchoReq_Uri_descriptor(), enum_t_value);
+}
+inline bool EchoReq_Uri_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, EchoReq_Uri* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<EchoReq_Uri>(
+    EchoReq_Uri_descriptor(), name, value);
+}
+enum EchoRsp_Uri : int {
+  EchoRsp_Uri_PLACEHOLDER = 0,
+  EchoRsp_Uri_URI = 31589,
+  EchoRsp_Uri_EchoRsp_Uri_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  EchoRsp_Uri_EchoRsp_Uri_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool EchoRsp_Uri_IsValid(int value);
+constexpr EchoRsp_Uri EchoRsp_Uri_Uri_MIN = EchoRsp_Uri_PLACEHOLDER;
+constexpr EchoRsp_Uri EchoRsp_Uri_Uri_MAX = EchoRsp_Uri_URI;
+constexpr int EchoRsp_Uri_Uri_ARRAYSIZE = EchoRsp_Uri_Uri_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* EchoRsp_Uri_descriptor();
+template<typename T>
+inline const std::string& EchoRsp_Uri_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, EchoRsp_Uri>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function EchoRsp_Uri_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    EchoRsp_Uri_descriptor(), enum_t_value);
+}
+inline bool EchoRsp_Uri_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, EchoRsp_Uri* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<EchoRsp_Uri>(
+    EchoRsp_Uri_descriptor(), name, value);
+}
+// ===================================================================
+
+class EchoReq final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:echo_proto.EchoReq) */ {
+ public:
+  inline EchoReq() : EchoReq(nullptr) {}
+  ~EchoReq() override;
+  explicit PROTOBUF_CONSTEXPR EchoReq(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  EchoReq(const EchoReq& from);
+  EchoReq(EchoReq&& from) noexcept
+    : EchoReq() {
+    *this = ::std::move(from);
+  }
+
+  inline EchoReq& operator=(const EchoReq& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline EchoReq& operator=(EchoReq&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const EchoReq& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const EchoReq* internal_default_instance() {
+    return reinterpret_cast<const EchoReq*>(
+               &_EchoReq_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(EchoReq& a, EchoReq& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(EchoReq* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(EchoReq* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  EchoReq* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<EchoReq>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const EchoReq& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const EchoReq& from) {
+    EchoReq::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(EchoReq* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "echo_proto.EchoReq";
+  }
+  protected:
+  explicit EchoReq(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef EchoReq_Uri Uri;
+  static constexpr Uri PLACEHOLDER =
+    EchoReq_Uri_PLACEHOLDER;
+  static constexpr Uri URI =
+    EchoReq_Uri_URI;
+  static inline bool Uri_IsValid(int value) {
+    return EchoReq_Uri_IsValid(value);
+  }
+  static constexpr Uri Uri_MIN =
+    EchoReq_Uri_Uri_MIN;
+  static constexpr Uri Uri_MAX =
+    EchoReq_Uri_Uri_MAX;
+  static constexpr int Uri_ARRAYSIZE =
+    EchoReq_Uri_Uri_ARRAYSIZE;
+  static inline const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor*
+  Uri_descriptor() {
+    return EchoReq_Uri_descriptor();
+  }
+  template<typename T>
+  static inline const std::string& Uri_Name(T enum_t_value) {
+    static_assert(::std::is_same<T, Uri>::value ||
+      ::std::is_integral<T>::value,
+      "Incorrect type passed to function Uri_Name.");
+    return EchoReq_Uri_Name(enum_t_value);
+  }
+  static inline bool Uri_Parse(::PROTOBUF_NAMESPACE_ID::ConstStringParam name,
+      Uri* value) {
+    return EchoReq_Uri_Parse(name, value);
+  }
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSidFieldNumber = 1,
+    kInfoFieldNumber = 3,
+    kLoginIdFieldNumber = 2,
+  };
+  // string sid = 1;
+  void clear_sid();
+  const std::string& sid() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_sid(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_sid();
+  PROTOBUF_NODISCARD std::string* release_sid();
+  void set_allocated_sid(std::string* sid);
+  private:
+  const std::string& _internal_sid() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_sid(const std::string& value);
+  std::string* _internal_mutable_sid();
+  public:
+
+  // string info = 3;
+  void clear_info();
+  const std::string& info() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_info(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_info();
+  PROTOBUF_NODISCARD std::string* release_info();
+  void set_allocated_info(std::string* info);
+  private:
+  const std::string& _internal_info() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_info(const std::string& value);
+  std::string* _internal_mutable_info();
+  public:
+
+  // int32 loginId = 2;
+  void clear_loginid();
+  int32_t loginid() const;
+  void set_loginid(int32_t value);
+  private:
+  int32_t _internal_loginid() const;
+  void _internal_set_loginid(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:echo_proto.EchoReq)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr sid_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr info_;
+    int32_t loginid_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_echo_2eproto;
+};
+// -------------------------------------------------------------------
+
+class EchoRsp final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:echo_proto.EchoRsp) */ {
+ public:
+  inline EchoRsp() : EchoRsp(nullptr) {}
+  ~EchoRsp() override;
+  explicit PROTOBUF_CONSTEXPR EchoRsp(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  EchoRsp(const EchoRsp& from);
+  EchoRsp(EchoRsp&& from) noexcept
+    : EchoRsp() {
+    *this = ::std::move(from);
+  }
+
+  inline EchoRsp& operator=(const EchoRsp& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline EchoRsp& operator=(EchoRsp&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const EchoRsp& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const EchoRsp* internal_default_instance() {
+    return reinterpret_cast<const EchoRsp*>(
+               &_EchoRsp_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(EchoRsp& a, EchoRsp& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(EchoRsp* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(EchoRsp* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  EchoRsp* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<EchoRsp>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const EchoRsp& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const EchoRsp& from) {
+    EchoRsp::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(EchoRsp* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "echo_proto.EchoRsp";
+  }
+  protected:
+  explicit EchoRsp(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef EchoRsp_Uri Uri;
+  static constexpr Uri PLACEHOLDER =
+    EchoRsp_Uri_PLACEHOLDER;
+  static constexpr Uri URI =
+    EchoRsp_Uri_URI;
+  static inline bool Uri_IsValid(int value) {
+    return EchoRsp_Uri_IsValid(value);
+  }
+  static constexpr Uri Uri_MIN =
+    EchoRsp_Uri_Uri_MIN;
+  static constexpr Uri Uri_MAX =
+    EchoRsp_Uri_Uri_MAX;
+  static constexpr int Uri_ARRAYSIZE =
+    EchoRsp_Uri_Uri_ARRAYSIZE;
+  static inline const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor*
+  Uri_descriptor() {
+    return EchoRsp_Uri_descriptor();
+  }
+  template<typename T>
+  static inline const std::string& Uri_Name(T enum_t_value) {
+    static_assert(::std::is_same<T, Uri>::value ||
+      ::std::is_integral<T>::value,
+      "Incorrect type passed to function Uri_Name.");
+    return EchoRsp_Uri_Name(enum_t_value);
+  }
+  static inline bool Uri_Parse(::PROTOBUF_NAMESPACE_ID::ConstStringParam name,
+      Uri* value) {
+    return EchoRsp_Uri_Parse(name, value);
+  }
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSidFieldNumber = 2,
+    kInfoFieldNumber = 4,
+    kRetCodeFieldNumber = 1,
+    kLoginIdFieldNumber = 3,
+  };
+  // string sid = 2;
+  void clear_sid();
+  const std::string& sid() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_sid(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_sid();
+  PROTOBUF_NODISCARD std::string* release_sid();
+  void set_allocated_sid(std::string* sid);
+  private:
+  const std::string& _internal_sid() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_sid(const std::string& value);
+  std::string* _internal_mutable_sid();
+  public:
+
+  // string info = 4;
+  void clear_info();
+  const std::string& info() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_info(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_info();
+  PROTOBUF_NODISCARD std::string* release_info();
+  void set_allocated_info(std::string* info);
+  private:
+  const std::string& _internal_info() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_info(const std::string& value);
+  std::string* _internal_mutable_info();
+  public:
+
+  // int32 retCode = 1;
+  void clear_retcode();
+  int32_t retcode() const;
+  void set_retcode(int32_t value);
+  private:
+  int32_t _internal_retcode() const;
+  void _internal_set_retcode(int32_t value);
+  public:
+
+  // int32 loginId = 3;
+  void clear_loginid();
+  int32_t loginid() const;
+  void set_loginid(int32_t value);
+  private:
+  int32_t _internal_loginid() const;
+  void _internal_set_loginid(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:echo_proto.EchoRsp)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr sid_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr info_;
+    int32_t retcode_;
+    int32_t loginid_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_echo_2eproto;
+};
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// EchoReq
+
+// string sid = 1;
+inline void EchoReq::clear_sid() {
+  _impl_.sid_.ClearToEmpty();
+}
+inline const std::string& EchoReq::sid() const {
+  // @@protoc_insertion_point(field_get:echo_proto.EchoReq.sid)
+  return _internal_sid();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void EchoReq::set_sid(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.sid_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:echo_proto.EchoReq.sid)
+}
+inline std::string* EchoReq::mutable_sid() {
+  std::string* _s = _internal_mutable_sid();
+  // @@protoc_insertion_point(field_mutable:echo_proto.EchoReq.sid)
+  return _s;
+}
+inline const std::string& EchoReq::_internal_sid() const {
+  return _impl_.sid_.Get();
+}
+inline void EchoReq::_internal_set_sid(const std::string& value) {
+  
+  _impl_.sid_.Set(value, GetArenaForAllocation());
+}
+inline std::string* EchoReq::_internal_mutable_sid() {
+  
+  return _impl_.sid_.Mutable(GetArenaForAllocation());
+}
+inline std::string* EchoReq::release_sid() {
+  // @@protoc_insertion_point(field_release:echo_proto.EchoReq.sid)
+  return _impl_.sid_.Release();
+}
+inline void EchoReq::set_allocated_sid(std::string* sid) {
+  if (sid != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.sid_.SetAllocated(sid, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.sid_.IsDefault()) {
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:echo_proto.EchoReq.sid)
+}
+
+// int32 loginId = 2;
+inline void EchoReq::clear_loginid() {
+  _impl_.loginid_ = 0;
+}
+inline int32_t EchoReq::_internal_loginid() const {
+  return _impl_.loginid_;
+}
+inline int32_t EchoReq::loginid() const {
+  // @@protoc_insertion_point(field_get:echo_proto.EchoReq.loginId)
+  return _internal_loginid();
+}
+inline void EchoReq::_internal_set_loginid(int32_t value) {
+  
+  _impl_.loginid_ = value;
+}
+inline void EchoReq::set_loginid(int32_t value) {
+  _internal_set_loginid(value);
+  // @@protoc_insertion_point(field_set:echo_proto.EchoReq.loginId)
+}
+
+// string info = 3;
+inline void EchoReq::clear_info() {
+  _impl_.info_.ClearToEmpty();
+}
+inline const std::string& EchoReq::info() const {
+  // @@protoc_insertion_point(field_get:echo_proto.EchoReq.info)
+  return _internal_info();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void EchoReq::set_info(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.info_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:echo_proto.EchoReq.info)
+}
+inline std::string* EchoReq::mutable_info() {
+  std::string* _s = _internal_mutable_info();
+  // @@protoc_insertion_point(field_mutable:echo_proto.EchoReq.info)
+  return _s;
+}
+inline const std::string& EchoReq::_internal_info() const {
+  return _impl_.info_.Get();
+}
+inline void EchoReq::_internal_set_info(const std::string& value) {
+  
+  _impl_.info_.Set(value, GetArenaForAllocation());
+}
+inline std::string* EchoReq::_internal_mutable_info() {
+  
+  return _impl_.info_.Mutable(GetArenaForAllocation());
+}
+inline std::string* EchoReq::release_info() {
+  // @@protoc_insertion_point(field_release:echo_proto.EchoReq.info)
+  return _impl_.info_.Release();
+}
+inline void EchoReq::set_allocated_info(std::string* info) {
+  if (info != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.info_.SetAllocated(info, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.info_.IsDefault()) {
+    _impl_.info_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:echo_proto.EchoReq.info)
+}
+
+// -------------------------------------------------------------------
+
+// EchoRsp
+
+// int32 retCode = 1;
+inline void EchoRsp::clear_retcode() {
+  _impl_.retcode_ = 0;
+}
+inline int32_t EchoRsp::_internal_retcode() const {
+  return _impl_.retcode_;
+}
+inline int32_t EchoRsp::retcode() const {
+  // @@protoc_insertion_point(field_get:echo_proto.EchoRsp.retCode)
+  return _internal_retcode();
+}
+inline void EchoRsp::_internal_set_retcode(int32_t value) {
+  
+  _impl_.retcode_ = value;
+}
+inline void EchoRsp::set_retcode(int32_t value) {
+  _internal_set_retcode(value);
+  // @@protoc_insertion_point(field_set:echo_proto.EchoRsp.retCode)
+}
+
+// string sid = 2;
+inline void EchoRsp::clear_sid() {
+  _impl_.sid_.ClearToEmpty();
+}
+inline const std::string& EchoRsp::sid() const {
+  // @@protoc_insertion_point(field_get:echo_proto.EchoRsp.sid)
+  return _internal_sid();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void EchoRsp::set_sid(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.sid_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:echo_proto.EchoRsp.sid)
+}
+inline std::string* EchoRsp::mutable_sid() {
+  std::string* _s = _internal_mutable_sid();
+  // @@protoc_insertion_point(field_mutable:echo_proto.EchoRsp.sid)
+  return _s;
+}
+inline const std::string& EchoRsp::_internal_sid() const {
+  return _impl_.sid_.Get();
+}
+inline void EchoRsp::_internal_set_sid(const std::string& value) {
+  
+  _impl_.sid_.Set(value, GetArenaForAllocation());
+}
+inline std::string* EchoRsp::_internal_mutable_sid() {
+  
+  return _impl_.sid_.Mutable(GetArenaForAllocation());
+}
+inline std::string* EchoRsp::release_sid() {
+  // @@protoc_insertion_point(field_release:echo_proto.EchoRsp.sid)
+  return _impl_.sid_.Release();
+}
+inline void EchoRsp::set_allocated_sid(std::string* sid) {
+  if (sid != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.sid_.SetAllocated(sid, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.sid_.IsDefault()) {
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:echo_proto.EchoRsp.sid)
+}
+
+// int32 loginId = 3;
+inline void EchoRsp::clear_loginid() {
+  _impl_.loginid_ = 0;
+}
+inline int32_t EchoRsp::_internal_loginid() const {
+  return _impl_.loginid_;
+}
+inline int32_t EchoRsp::loginid() const {
+  // @@protoc_insertion_point(field_get:echo_proto.EchoRsp.loginId)
+  return _internal_loginid();
+}
+inline void EchoRsp::_internal_set_loginid(int32_t value) {
+  
+  _impl_.loginid_ = value;
+}
+inline void EchoRsp::set_loginid(int32_t value) {
+  _internal_set_loginid(value);
+  // @@protoc_insertion_point(field_set:echo_proto.EchoRsp.loginId)
+}
+
+// string info = 4;
+inline void EchoRsp::clear_info() {
+  _impl_.info_.ClearToEmpty();
+}
+inline const std::string& EchoRsp::info() const {
+  // @@protoc_insertion_point(field_get:echo_proto.EchoRsp.info)
+  return _internal_info();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void EchoRsp::set_info(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.info_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:echo_proto.EchoRsp.info)
+}
+inline std::string* EchoRsp::mutable_info() {
+  std::string* _s = _internal_mutable_info();
+  // @@protoc_insertion_point(field_mutable:echo_proto.EchoRsp.info)
+  return _s;
+}
+inline const std::string& EchoRsp::_internal_info() const {
+  return _impl_.info_.Get();
+}
+inline void EchoRsp::_internal_set_info(const std::string& value) {
+  
+  _impl_.info_.Set(value, GetArenaForAllocation());
+}
+inline std::string* EchoRsp::_internal_mutable_info() {
+  
+  return _impl_.info_.Mutable(GetArenaForAllocation());
+}
+inline std::string* EchoRsp::release_info() {
+  // @@protoc_insertion_point(field_release:echo_proto.EchoRsp.info)
+  return _impl_.info_.Release();
+}
+inline void EchoRsp::set_allocated_info(std::string* info) {
+  if (info != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.info_.SetAllocated(info, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.info_.IsDefault()) {
+    _impl_.info_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:echo_proto.EchoRsp.info)
+}
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic pop
+#endif  // __GNUC__
+// -------------------------------------------------------------------
+
+
+// @@protoc_insertion_point(namespace_scope)
+
+}  // namespace echo_proto
+
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::echo_proto::EchoReq_Uri> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::echo_proto::EchoReq_Uri>() {
+  return ::echo_proto::EchoReq_Uri_descriptor();
+}
+template <> struct is_proto_enum< ::echo_proto::EchoRsp_Uri> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::echo_proto::EchoRsp_Uri>() {
+  return ::echo_proto::EchoRsp_Uri_descriptor();
+}
+
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+
+#include <google/protobuf/port_undef.inc>
+#endif  // GOOGLE_PROTOBUF_INCLUDED_GOOGLE_PROTOBUF_INCLUDED_echo_2eproto
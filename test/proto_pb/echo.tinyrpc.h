@@ -0,0 +1,21 @@
+// Generated by protoc-gen-tinyrpc from echo.proto. DO NOT EDIT!
+
+#ifndef __ECHO_TINYRPC_H__
+#define __ECHO_TINYRPC_H__
+
+#include "dispatcher_base/service.h"
+#include "echo.pb.h"
+
+namespace echo_proto {
+
+// IMPL implements, called inline on the worker loop:
+//   void Echo(const ::echo_proto::EchoReq& req, ::echo_proto::EchoRsp& rsp);
+// srv.registerService<EchoServiceDef<IMPL>>(&impl);
+template<typename IMPL>
+using EchoServiceDef = ::tinyrpc::ServiceDef<IMPL,
+    ::tinyrpc::Method<IMPL, ::echo_proto::EchoReq,
+        ::echo_proto::EchoRsp, &IMPL::Echo>>;
+
+} // namespace echo_proto
+
+#endif // __ECHO_TINYRPC_H__
@@ -0,0 +1,846 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: hello.proto
+
+#ifndef GOOGLE_PROTOBUF_INCLUDED_hello_2eproto
+#define GOOGLE_PROTOBUF_INCLUDED_hello_2eproto
+
+#include <limits>
+#include <string>
+
+#include <google/protobuf/port_def.inc>
+#if PROTOBUF_VERSION < 3021000
+#error This file was generated by a newer version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please update
+#error your headers.
+#endif
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
+#error This file was generated by an older version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please
+#error regenerate this file with a newer version of protoc.
+#endif
+
+#include <google/protobuf/port_undef.inc>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/arenastring.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/metadata_lite.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>  // IWYU pragma: export
+#include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/generated_enum_reflection.h>
+#include <google/protobuf/unknown_field_set.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+#define PROTOBUF_INTERNAL_EXPORT_hello_2eproto
+PROTOBUF_NAMESPACE_OPEN
+namespace internal {
+class AnyMetadata;
+}  // namespace internal
+PROTOBUF_NAMESPACE_CLOSE
+
+// Internal implementation detail -- do not use these members.
+struct TableStruct_hello_2eproto {
+  static const uint32_t offsets[];
+};
+extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_hello_2eproto;
+namespace hello_proto {
+class HelloReq;
+struct HelloReqDefaultTypeInternal;
+extern HelloReqDefaultTypeInternal _HelloReq_default_instance_;
+class HelloRsp;
+struct HelloRspDefaultTypeInternal;
+extern HelloRspDefaultTypeInternal _HelloRsp_default_instance_;
+}  // namespace hello_proto
+PROTOBUF_NAMESPACE_OPEN
+template<> ::hello_proto::HelloReq* Arena::CreateMaybeMessage<::hello_proto::HelloReq>(Arena*);
+template<> ::hello_proto::HelloRsp* Arena::CreateMaybeMessage<::hello_proto::HelloRsp>(Arena*);
+PROTOBUF_NAMESPACE_CLOSE
+namespace hello_proto {
+
+enum HelloReq_Uri : int {
+  HelloReq_Uri_PLACEHOLDER = 0,
+  HelloReq_Uri_URI = 31590,
+  HelloReq_Uri_HelloReq_Uri_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  HelloReq_Uri_HelloReq_Uri_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool HelloReq_Uri_IsValid(int value);
+constexpr HelloReq_Uri HelloReq_Uri_Uri_MIN = HelloReq_Uri_PLACEHOLDER;
+constexpr HelloReq_Uri HelloReq_Uri_Uri_MAX = HelloReq_Uri_URI;
+constexpr int HelloReq_Uri_Uri_ARRAYSIZE = HelloReq_Uri_Uri_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* HelloReq_Uri_descriptor();
+template<typename T>
+inline const std::string& HelloReq_Uri_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, HelloReq_Uri>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function HelloReq_Uri_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    HelloReq_Uri_descriptor(), enum_t_value);
+}
+inline bool HelloReq_Uri_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, HelloReq_Uri* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<HelloReq_Uri>(
+    HelloReq_Uri_descriptor(), name, value);
+}
+enum HelloRsp_Uri : int {
+  HelloRsp_Uri_PLACEHOLDER = 0,
+  HelloRsp_Uri_URI = 31591,
+  HelloRsp_Uri_HelloRsp_Uri_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  HelloRsp_Uri_HelloRsp_Uri_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool HelloRsp_Uri_IsValid(int value);
+constexpr HelloRsp_Uri HelloRsp_Uri_Uri_MIN = HelloRsp_Uri_PLACEHOLDER;
+constexpr HelloRsp_Uri HelloRsp_Uri_Uri_MAX = HelloRsp_Uri_URI;
+constexpr int HelloRsp_Uri_Uri_ARRAYSIZE = HelloRsp_Uri_Uri_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* HelloRsp_Uri_descriptor();
+template<typename T>
+inline const std::string& HelloRsp_Uri_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, HelloRsp_Uri>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function HelloRsp_Uri_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    HelloRsp_Uri_descriptor(), enum_t_value);
+}
+inline bool HelloRsp_Uri_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, HelloRsp_Uri* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<HelloRsp_Uri>(
+    HelloRsp_Uri_descriptor(), name, value);
+}
+// ===================================================================
+
+class HelloReq final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:hello_proto.HelloReq) */ {
+ public:
+  inline HelloReq() : HelloReq(nullptr) {}
+  ~HelloReq() override;
+  explicit PROTOBUF_CONSTEXPR HelloReq(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  HelloReq(const HelloReq& from);
+  HelloReq(HelloReq&& from) noexcept
+    : HelloReq() {
+    *this = ::std::move(from);
+  }
+
+  inline HelloReq& operator=(const HelloReq& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline HelloReq& operator=(HelloReq&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const HelloReq& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const HelloReq* internal_default_instance() {
+    return reinterpret_cast<const HelloReq*>(
+               &_HelloReq_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(HelloReq& a, HelloReq& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(HelloReq* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(HelloReq* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  HelloReq* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<HelloReq>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const HelloReq& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const HelloReq& from) {
+    HelloReq::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(HelloReq* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "hello_proto.HelloReq";
+  }
+  protected:
+  explicit HelloReq(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef HelloReq_Uri Uri;
+  static constexpr Uri PLACEHOLDER =
+    HelloReq_Uri_PLACEHOLDER;
+  static constexpr Uri URI =
+    HelloReq_Uri_URI;
+  static inline bool Uri_IsValid(int value) {
+    return HelloReq_Uri_IsValid(value);
+  }
+  static constexpr Uri Uri_MIN =
+    HelloReq_Uri_Uri_MIN;
+  static constexpr Uri Uri_MAX =
+    HelloReq_Uri_Uri_MAX;
+  static constexpr int Uri_ARRAYSIZE =
+    HelloReq_Uri_Uri_ARRAYSIZE;
+  static inline const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor*
+  Uri_descriptor() {
+    return HelloReq_Uri_descriptor();
+  }
+  template<typename T>
+  static inline const std::string& Uri_Name(T enum_t_value) {
+    static_assert(::std::is_same<T, Uri>::value ||
+      ::std::is_integral<T>::value,
+      "Incorrect type passed to function Uri_Name.");
+    return HelloReq_Uri_Name(enum_t_value);
+  }
+  static inline bool Uri_Parse(::PROTOBUF_NAMESPACE_ID::ConstStringParam name,
+      Uri* value) {
+    return HelloReq_Uri_Parse(name, value);
+  }
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSidFieldNumber = 1,
+    kInfoFieldNumber = 3,
+    kLoginIdFieldNumber = 2,
+  };
+  // string sid = 1;
+  void clear_sid();
+  const std::string& sid() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_sid(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_sid();
+  PROTOBUF_NODISCARD std::string* release_sid();
+  void set_allocated_sid(std::string* sid);
+  private:
+  const std::string& _internal_sid() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_sid(const std::string& value);
+  std::string* _internal_mutable_sid();
+  public:
+
+  // string info = 3;
+  void clear_info();
+  const std::string& info() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_info(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_info();
+  PROTOBUF_NODISCARD std::string* release_info();
+  void set_allocated_info(std::string* info);
+  private:
+  const std::string& _internal_info() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_info(const std::string& value);
+  std::string* _internal_mutable_info();
+  public:
+
+  // int32 loginId = 2;
+  void clear_loginid();
+  int32_t loginid() const;
+  void set_loginid(int32_t value);
+  private:
+  int32_t _internal_loginid() const;
+  void _internal_set_loginid(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:hello_proto.HelloReq)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr sid_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr info_;
+    int32_t loginid_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_hello_2eproto;
+};
+// -------------------------------------------------------------------
+
+class HelloRsp final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:hello_proto.HelloRsp) */ {
+ public:
+  inline HelloRsp() : HelloRsp(nullptr) {}
+  ~HelloRsp() override;
+  explicit PROTOBUF_CONSTEXPR HelloRsp(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  HelloRsp(const HelloRsp& from);
+  HelloRsp(HelloRsp&& from) noexcept
+    : HelloRsp() {
+    *this = ::std::move(from);
+  }
+
+  inline HelloRsp& operator=(const HelloRsp& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline HelloRsp& operator=(HelloRsp&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const HelloRsp& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const HelloRsp* internal_default_instance() {
+    return reinterpret_cast<const HelloRsp*>(
+               &_HelloRsp_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(HelloRsp& a, HelloRsp& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(HelloRsp* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(HelloRsp* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  HelloRsp* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<HelloRsp>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const HelloRsp& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const HelloRsp& from) {
+    HelloRsp::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(HelloRsp* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "hello_proto.HelloRsp";
+  }
+  protected:
+  explicit HelloRsp(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef HelloRsp_Uri Uri;
+  static constexpr Uri PLACEHOLDER =
+    HelloRsp_Uri_PLACEHOLDER;
+  static constexpr Uri URI =
+    HelloRsp_Uri_URI;
+  static inline bool Uri_IsValid(int value) {
+    return HelloRsp_Uri_IsValid(value);
+  }
+  static constexpr Uri Uri_MIN =
+    HelloRsp_Uri_Uri_MIN;
+  static constexpr Uri Uri_MAX =
+    HelloRsp_Uri_Uri_MAX;
+  static constexpr int Uri_ARRAYSIZE =
+    HelloRsp_Uri_Uri_ARRAYSIZE;
+  static inline const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor*
+  Uri_descriptor() {
+    return HelloRsp_Uri_descriptor();
+  }
+  template<typename T>
+  static inline const std::string& Uri_Name(T enum_t_value) {
+    static_assert(::std::is_same<T, Uri>::value ||
+      ::std::is_integral<T>::value,
+      "Incorrect type passed to function Uri_Name.");
+    return HelloRsp_Uri_Name(enum_t_value);
+  }
+  static inline bool Uri_Parse(::PROTOBUF_NAMESPACE_ID::ConstStringParam name,
+      Uri* value) {
+    return HelloRsp_Uri_Parse(name, value);
+  }
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSidFieldNumber = 2,
+    kInfoFieldNumber = 4,
+    kRetCodeFieldNumber = 1,
+    kLoginIdFieldNumber = 3,
+  };
+  // string sid = 2;
+  void clear_sid();
+  const std::string& sid() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_sid(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_sid();
+  PROTOBUF_NODISCARD std::string* release_sid();
+  void set_allocated_sid(std::string* sid);
+  private:
+  const std::string& _internal_sid() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_sid(const std::string& value);
+  std::string* _internal_mutable_sid();
+  public:
+
+  // string info = 4;
+  void clear_info();
+  const std::string& info() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_info(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_info();
+  PROTOBUF_NODISCARD std::string* release_info();
+  void set_allocated_info(std::string* info);
+  private:
+  const std::string& _internal_info() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_info(const std::string& value);
+  std::string* _internal_mutable_info();
+  public:
+
+  // int32 retCode = 1;
+  void clear_retcode();
+  int32_t retcode() const;
+  void set_retcode(int32_t value);
+  private:
+  int32_t _internal_retcode() const;
+  void _internal_set_retcode(int32_t value);
+  public:
+
+  // int32 loginId = 3;
+  void clear_loginid();
+  int32_t loginid() const;
+  void set_loginid(int32_t value);
+  private:
+  int32_t _internal_loginid() const;
+  void _internal_set_loginid(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:hello_proto.HelloRsp)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr sid_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr info_;
+    int32_t retcode_;
+    int32_t loginid_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_hello_2eproto;
+};
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// HelloReq
+
+// string sid = 1;
+inline void HelloReq::clear_sid() {
+  _impl_.sid_.ClearToEmpty();
+}
+inline const std::string& HelloReq::sid() const {
+  // @@protoc_insertion_point(field_get:hello_proto.HelloReq.sid)
+  return _internal_sid();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void HelloReq::set_sid(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.sid_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:hello_proto.HelloReq.sid)
+}
+inline std::string* HelloReq::mutable_sid() {
+  std::string* _s = _internal_mutable_sid();
+  // @@protoc_insertion_point(field_mutable:hello_proto.HelloReq.sid)
+  return _s;
+}
+inline const std::string& HelloReq::_internal_sid() const {
+  return _impl_.sid_.Get();
+}
+inline void HelloReq::_internal_set_sid(const std::string& value) {
+  
+  _impl_.sid_.Set(value, GetArenaForAllocation());
+}
+inline std::string* HelloReq::_internal_mutable_sid() {
+  
+  return _impl_.sid_.Mutable(GetArenaForAllocation());
+}
+inline std::string* HelloReq::release_sid() {
+  // @@protoc_insertion_point(field_release:hello_proto.HelloReq.sid)
+  return _impl_.sid_.Release();
+}
+inline void HelloReq::set_allocated_sid(std::string* sid) {
+  if (sid != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.sid_.SetAllocated(sid, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.sid_.IsDefault()) {
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:hello_proto.HelloReq.sid)
+}
+
+// int32 loginId = 2;
+inline void HelloReq::clear_loginid() {
+  _impl_.loginid_ = 0;
+}
+inline int32_t HelloReq::_internal_loginid() const {
+  return _impl_.loginid_;
+}
+inline int32_t HelloReq::loginid() const {
+  // @@protoc_insertion_point(field_get:hello_proto.HelloReq.loginId)
+  return _internal_loginid();
+}
+inline void HelloReq::_internal_set_loginid(int32_t value) {
+  
+  _impl_.loginid_ = value;
+}
+inline void HelloReq::set_loginid(int32_t value) {
+  _internal_set_loginid(value);
+  // @@protoc_insertion_point(field_set:hello_proto.HelloReq.loginId)
+}
+
+// string info = 3;
+inline void HelloReq::clear_info() {
+  _impl_.info_.ClearToEmpty();
+}
+inline const std::string& HelloReq::info() const {
+  // @@protoc_insertion_point(field_get:hello_proto.HelloReq.info)
+  return _internal_info();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void HelloReq::set_info(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.info_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:hello_proto.HelloReq.info)
+}
+inline std::string* HelloReq::mutable_info() {
+  std::string* _s = _internal_mutable_info();
+  // @@protoc_insertion_point(field_mutable:hello_proto.HelloReq.info)
+  return _s;
+}
+inline const std::string& HelloReq::_internal_info() const {
+  return _impl_.info_.Get();
+}
+inline void HelloReq::_internal_set_info(const std::string& value) {
+  
+  _impl_.info_.Set(value, GetArenaForAllocation());
+}
+inline std::string* HelloReq::_internal_mutable_info() {
+  
+  return _impl_.info_.Mutable(GetArenaForAllocation());
+}
+inline std::string* HelloReq::release_info() {
+  // @@protoc_insertion_point(field_release:hello_proto.HelloReq.info)
+  return _impl_.info_.Release();
+}
+inline void HelloReq::set_allocated_info(std::string* info) {
+  if (info != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.info_.SetAllocated(info, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.info_.IsDefault()) {
+    _impl_.info_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:hello_proto.HelloReq.info)
+}
+
+// -------------------------------------------------------------------
+
+// HelloRsp
+
+// int32 retCode = 1;
+inline void HelloRsp::clear_retcode() {
+  _impl_.retcode_ = 0;
+}
+inline int32_t HelloRsp::_internal_retcode() const {
+  return _impl_.retcode_;
+}
+inline int32_t HelloRsp::retcode() const {
+  // @@protoc_insertion_point(field_get:hello_proto.HelloRsp.retCode)
+  return _internal_retcode();
+}
+inline void HelloRsp::_internal_set_retcode(int32_t value) {
+  
+  _impl_.retcode_ = value;
+}
+inline void HelloRsp::set_retcode(int32_t value) {
+  _internal_set_retcode(value);
+  // @@protoc_insertion_point(field_set:hello_proto.HelloRsp.retCode)
+}
+
+// string sid = 2;
+inline void HelloRsp::clear_sid() {
+  _impl_.sid_.ClearToEmpty();
+}
+inline const std::string& HelloRsp::sid() const {
+  // @@protoc_insertion_point(field_get:hello_proto.HelloRsp.sid)
+  return _internal_sid();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void HelloRsp::set_sid(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.sid_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:hello_proto.HelloRsp.sid)
+}
+inline std::string* HelloRsp::mutable_sid() {
+  std::string* _s = _internal_mutable_sid();
+  // @@protoc_insertion_point(field_mutable:hello_proto.HelloRsp.sid)
+  return _s;
+}
+inline const std::string& HelloRsp::_internal_sid() const {
+  return _impl_.sid_.Get();
+}
+inline void HelloRsp::_internal_set_sid(const std::string& value) {
+  
+  _impl_.sid_.Set(value, GetArenaForAllocation());
+}
+inline std::string* HelloRsp::_internal_mutable_sid() {
+  
+  return _impl_.sid_.Mutable(GetArenaForAllocation());
+}
+inline std::string* HelloRsp::release_sid() {
+  // @@protoc_insertion_point(field_release:hello_proto.HelloRsp.sid)
+  return _impl_.sid_.Release();
+}
+inline void HelloRsp::set_allocated_sid(std::string* sid) {
+  if (sid != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.sid_.SetAllocated(sid, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.sid_.IsDefault()) {
+    _impl_.sid_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:hello_proto.HelloRsp.sid)
+}
+
+// int32 loginId = 3;
+inline void HelloRsp::clear_loginid() {
+  _impl_.loginid_ = 0;
+}
+inline int32_t HelloRsp::_internal_loginid() const {
+  return _impl_.loginid_;
+}
+inline int32_t HelloRsp::loginid() const {
+  // @@protoc_insertion_point(field_get:hello_proto.HelloRsp.loginId)
+  return _internal_loginid();
+}
+inline void HelloRsp::_internal_set_loginid(int32_t value) {
+  
+  _impl_.loginid_ = value;
+}
+inline void HelloRsp::set_loginid(int32_t value) {
+  _internal_set_loginid(value);
+  // @@protoc_insertion_point(field_set:hello_proto.HelloRsp.loginId)
+}
+
+// string info = 4;
+inline void HelloRsp::clear_info() {
+  _impl_.info_.ClearToEmpty();
+}
+inline const std::string& HelloRsp::info() const {
+  // @@protoc_insertion_point(field_get:hello_proto.HelloRsp.info)
+  return _internal_info();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void HelloRsp::set_info(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.info_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:hello_proto.HelloRsp.info)
+}
+inline std::string* HelloRsp::mutable_info() {
+  std::string* _s = _internal_mutable_info();
+  // @@protoc_insertion_point(field_mutable:hello_proto.HelloRsp.info)
+  return _s;
+}
+inline const std::string& HelloRsp::_internal_info() const {
+  return _impl_.info_.Get();
+}
+inline void HelloRsp::_internal_set_info(const std::string& value) {
+  
+  _impl_.info_.Set(value, GetArenaForAllocation());
+}
+inline std::string* HelloRsp::_internal_mutable_info() {
+  
+  return _impl_.info_.Mutable(GetArenaForAllocation());
+}
+inline std::string* HelloRsp::release_info() {
+  // @@protoc_insertion_point(field_release:hello_proto.HelloRsp.info)
+  return _impl_.info_.Release();
+}
+inline void HelloRsp::set_allocated_info(std::string* info) {
+  if (info != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.info_.SetAllocated(info, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.info_.IsDefault()) {
+    _impl_.info_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:hello_proto.HelloRsp.info)
+}
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic pop
+#endif  // __GNUC__
+// -------------------------------------------------------------------
+
+
+// @@protoc_insertion_point(namespace_scope)
+
+}  // namespace hello_proto
+
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::hello_proto::HelloReq_Uri> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::hello_proto::HelloReq_Uri>() {
+  return ::hello_proto::HelloReq_Uri_descriptor();
+}
+template <> struct is_proto_enum< ::hello_proto::HelloRsp_Uri> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::hello_proto::HelloRsp_Uri>() {
+  return ::hello_proto::HelloRsp_Uri_descriptor();
+}
+
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+
+#include <google/protobuf/port_undef.inc>
+#endif  // GOOGLE_PROTOBUF_INCLUDED_GOOGLE_PROTOBUF_INCLUDED_hello_2eproto
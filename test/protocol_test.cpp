@@ -0,0 +1,124 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// a wire format of our own at PROTOCOL_TYPE_USER: RawEchoProtocol sends the
+// body back as it is, with the request's traceId. frames of it and of pb
+// come in on one read and each goes to its own protocol. a taken or out of
+// range type is refused by registerProtocol. the worker side(Codec) runs in
+// process, the client is the other end of a unix socketpair.
+
+#include "codec.h"
+#include "connection.h"
+#include "test_util.h"
+#include "proto_pb/echo.pb.h"
+#include <memory>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+// a wire format of our own: the body is sent back as it is
+class RawEchoProtocol : public Protocol {
+public:
+    enum {
+        TYPE = PROTOCOL_TYPE_USER,
+    };
+
+    bool parseToMessage(const char* package, uint32_t packageSize,
+                        uint32_t protocolUri, VoidPtr& message) override {
+        uint32_t headLen = ProtocolHead::getLen();
+        message = std::make_shared<std::string>(package + headLen,
+            packageSize - headLen);
+        return true;
+    }
+
+    bool serializeToString(VoidPtr& message, std::string& data) override {
+        data = *std::static_pointer_cast<std::string>(message);
+        return true;
+    }
+
+    bool dispatch(const char* package, uint32_t packageSize,
+                  uint32_t protocolUri, Connection* conn) override {
+        uint32_t headLen = ProtocolHead::getLen();
+        std::string body(package + headLen, packageSize - headLen);
+        return Codec::sendMessage(conn, TYPE, protocolUri, body,
+            ProtocolHead::traceIdOf(package));
+    }
+
+    VoidPtr getDispatcher() override { return nullptr; }
+};
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    rsp->set_retcode(1);
+    rsp->set_sid(req->sid());
+}
+
+int main(int argc, char *argv[]) {
+    int fds[2];
+    if (!test::makeSocketPair(fds)) {
+        return -1;
+    }
+    Connection conn(fds[0]);
+    conn.setStatus(CONN_STATUS_OK);
+    Connection client(fds[1]);
+    client.setStatus(CONN_STATUS_OK);
+
+    Codec codec;
+    auto raw = std::make_shared<RawEchoProtocol>();
+    CHECK(codec.registerProtocol(RawEchoProtocol::TYPE, raw));
+    CHECK(codec.getProtocol(RawEchoProtocol::TYPE) == raw);
+    // taken, out of range
+    CHECK(!codec.registerProtocol(PROTOCOL_TYPE_PB, raw));
+    CHECK(!codec.registerProtocol(RawEchoProtocol::TYPE, raw));
+    CHECK(!codec.registerProtocol(PROTOCOL_TYPE_MAX, raw));
+
+    auto dispatcher = std::static_pointer_cast<pb::Dispatcher>(
+        codec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher());
+    dispatcher->registerCallback<EchoReq, EchoRsp>(onEchoReq);
+
+    EchoReq req;
+    req.set_sid("pb");
+    string frames = test::packFrame(RawEchoProtocol::TYPE, 0x1234,
+        "raw body", "raw-1");
+    frames += test::packPbFrame(req, "pb-1");
+    CHECK(send(fds[1], frames.data(), frames.size(), 0) ==
+        (ssize_t)frames.size());
+    conn.tcpRecv();
+    CHECK(codec.processMessage(&conn));
+
+    client.tcpRecv();
+    int rawNum = 0;
+    int pbNum = 0;
+    while (true) {
+        ProtocolHead head;
+        char* package = nullptr;
+        uint32_t packageSize = 0;
+        if (codec.unpack(&client, head, &package, packageSize) <= 0) {
+            break;
+        }
+        string body(package + ProtocolHead::getLen(),
+            packageSize - ProtocolHead::getLen());
+        if (RawEchoProtocol::TYPE == head.protocolType) {
+            rawNum++;
+            CHECK(0x1234 == head.protocolUri && "raw body" == body);
+            CHECK(0 == strcmp(head.traceId, "raw-1"));
+        } else if (PROTOCOL_TYPE_PB == head.protocolType) {
+            pbNum++;
+            EchoRsp rsp;
+            CHECK(EchoRsp::URI == head.protocolUri &&
+                rsp.ParseFromString(body) && "pb" == rsp.sid());
+            CHECK(0 == strcmp(head.traceId, "pb-1"));
+        }
+    }
+    printf("responses: raw:%d pb:%d\n", rawNum, pbNum);
+    CHECK(1 == rawNum && 1 == pbNum);
+
+    return test::report();
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// RateLimitOption{ip_:{10/s, burst 5}, uris_:{EchoReq:{10/s, burst 3}},
+// maxIpNum_:8}:
+//   8 pipelined EchoReqs of one conn: 3 pass(uri burst), 5 are answered
+//       with PROTOCOL_URI_RATE_LIMITED before being parsed
+//   a forked process spends 3 tokens of an ip, this one gets the other 2
+//   after an interval(100ms) the ip has a token again
+//   8 ip slots: the 9th ip is untracked, once the others are idle it takes
+//       over a slot
+//   an ipv6 text of 39 bytes is kept whole in its slot and its report line
+// the worker side(Codec) runs in process, the client is the other end of a
+// unix socketpair.
+
+#include "codec.h"
+#include "connection.h"
+#include "rate_limit.h"
+#include "test_util.h"
+#include "proto_pb/echo.pb.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+// any uri without a bucket of its own
+static const uint32_t OTHER_URI = 0x1234;
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    rsp->set_retcode(1);
+    rsp->set_sid(req->sid());
+}
+
+static string makeFrame(int seq) {
+    EchoReq req;
+    req.set_sid(to_string(seq));
+    return test::packPbFrame(req, "req-" + to_string(seq));
+}
+
+static int admitNum(RateLimiter& limiter, const char* ip, int num) {
+    int passed = 0;
+    for (int i = 0; i < num; i++) {
+        passed += limiter.admit(ip, OTHER_URI) ? 1 : 0;
+    }
+    return passed;
+}
+
+int main(int argc, char *argv[]) {
+    RateLimitOption opt;
+    opt.enable_ = true;
+    opt.ip_ = RateLimit(10, 5);
+    opt.maxIpNum_ = 8;
+    opt.uris_[EchoReq::URI] = RateLimit(10, 3);
+    RateLimiter limiter;
+    CHECK(limiter.create(opt));
+
+    int fds[2];
+    if (!test::makeSocketPair(fds)) {
+        return -1;
+    }
+    Connection conn(fds[0]);
+    conn.setStatus(CONN_STATUS_OK);
+    snprintf(conn.getRemoteAddr()->ip, AddrInfo::IP_SIZE, "10.0.0.1");
+    Connection client(fds[1]);
+    client.setStatus(CONN_STATUS_OK);
+
+    Codec codec;
+    codec.setRateLimiter(&limiter);
+    std::static_pointer_cast<pb::Dispatcher>(
+        codec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher())
+        ->registerCallback<EchoReq, EchoRsp>(onEchoReq);
+
+    string frames;
+    for (int i = 0; i < 8; i++) {
+        frames += makeFrame(i);
+    }
+    send(fds[1], frames.data(), frames.size(), 0);
+    conn.tcpRecv();
+    codec.processMessage(&conn);
+
+    int rspNum = 0;
+    int limitedNum = 0;
+    client.tcpRecv();
+    while (true) {
+        ProtocolHead head;
+        char* package = nullptr;
+        uint32_t packageSize = 0;
+        if (codec.unpack(&client, head, &package, packageSize) <= 0) {
+            break;
+        }
+        if (PROTOCOL_URI_RATE_LIMITED == head.protocolUri) {
+            limitedNum++;
+        } else if (EchoRsp::URI == head.protocolUri) {
+            rspNum++;
+        }
+    }
+    printf("8 requests: responses:%d rate limited:%d\n", rspNum, limitedNum);
+    CHECK(rspNum == 3 && limitedNum == 5);
+
+    // the buckets are shared with forked processes
+    pid_t pid = fork();
+    if (0 == pid) {
+        _exit(admitNum(limiter, "10.0.0.2", 3));
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    int childPassed = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    int passed = admitNum(limiter, "10.0.0.2", 5);
+    printf("shared ip: child passed:%d, then this process passed:%d of 5\n",
+        childPassed, passed);
+    CHECK(childPassed == 3 && passed == 2);
+
+    usleep(110 * 1000);
+    passed = admitNum(limiter, "10.0.0.2", 2);
+    printf("after 110ms: passed:%d of 2\n", passed);
+    CHECK(passed == 1);
+
+    // fill the 8 slots with busy ips(10.0.0.1/2 hold one each)
+    for (int i = 3; i <= 8; i++) {
+        string ip = "10.0.0." + to_string(i);
+        CHECK(admitNum(limiter, ip.c_str(), 5) == 5);
+    }
+    string report;
+    limiter.report(report);
+    printf("%s", report.c_str());
+    CHECK(admitNum(limiter, "10.0.1.1", 6) == 6);
+    // 10.0.0.x stay busy for 500ms, then 10.0.1.1 takes an idle slot
+    usleep(510 * 1000);
+    CHECK(admitNum(limiter, "10.0.1.1", 6) == 5);
+
+    report.clear();
+    limiter.report(report);
+    printf("%s", report.c_str());
+    CHECK(report.find("rate_limit uri 0x") != string::npos);
+    CHECK(report.find("untracked 6") != string::npos);
+    CHECK(report.find("ip 10.0.1.1 passed 5 rejected 1") != string::npos);
+
+    const char* ipv6 = "2001:0db8:85a3:0000:0000:8a2e:0370:7334";
+    usleep(510 * 1000);
+    CHECK(admitNum(limiter, ipv6, 6) == 5);
+    CHECK(admitNum(limiter, ipv6, 1) == 0);
+    report.clear();
+    limiter.report(report);
+    CHECK(report.find(string("ip ") + ipv6 + " passed 5 rejected 2") !=
+        string::npos);
+
+    return test::report();
+}
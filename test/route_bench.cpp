@@ -0,0 +1,148 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// cost of resolving a request uri in dispatch:
+//   maps:  the old GenericDispatcher, descriptor/req2rsp/callback
+//          unordered_maps, four lookups(req and rsp descriptor, rsp uri,
+//          callback)
+//   table: RouteTable, one probe returns all of them
+// uris look like the generated ones(service << 8 | cmd), looked up in a
+// random order so the hot set does not fit in L1.
+
+#include "dispatcher_base/route_table.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <stdio.h>
+
+using namespace std;
+using namespace tinyrpc;
+
+struct FakeCallback {
+    uint64_t callCnt;
+    FakeCallback() : callCnt(0) {}
+};
+
+using PrototypePtr = const void*;
+using CallbackPtr = shared_ptr<FakeCallback>;
+
+struct FakeRoute {
+    uint32_t uri;
+    uint32_t rspUri;
+    PrototypePtr prototype;
+    PrototypePtr rspPrototype;
+    CallbackPtr callback;
+
+    FakeRoute() : uri(0), rspUri(0), prototype(nullptr),
+        rspPrototype(nullptr) {}
+};
+
+static void report(const char* name, uint64_t lookups, uint64_t ns,
+                   uint64_t sum) {
+    printf("%-6s lookups:%lu ns/dispatch:%.1f (sum:%lu)\n", name,
+           (unsigned long)lookups, (double)ns / lookups, (unsigned long)sum);
+}
+
+static void runMaps(const vector<uint32_t>& reqUris,
+                    const vector<uint32_t>& seq, int rounds) {
+    unordered_map<uint32_t, PrototypePtr> descriptor;
+    unordered_map<uint32_t, uint32_t> req2rsp;
+    unordered_map<uint32_t, CallbackPtr> callback;
+    for (uint32_t uri : reqUris) {
+        descriptor[uri] = &reqUris;
+        descriptor[uri + 1] = &reqUris;
+        req2rsp[uri] = uri + 1;
+        callback[uri] = make_shared<FakeCallback>();
+    }
+
+    uint64_t sum = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (uint32_t uri : seq) {
+            auto it = descriptor.find(uri);
+            if (it == descriptor.end()) {
+                continue;
+            }
+            auto rspIt = req2rsp.find(uri);
+            uint32_t rspUri = rspIt != req2rsp.end() ? rspIt->second : 0;
+            auto rspDesc = descriptor.find(rspUri);
+            auto cbIt = callback.find(uri);
+            if (rspDesc != descriptor.end() && cbIt != callback.end()) {
+                cbIt->second->callCnt++;
+                sum += rspUri;
+            }
+        }
+    }
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    report("maps", (uint64_t)rounds * seq.size(), ns, sum);
+}
+
+static void runTable(const vector<uint32_t>& reqUris,
+                     const vector<uint32_t>& seq, int rounds) {
+    detail::RouteTable<FakeRoute> routes;
+    for (uint32_t uri : reqUris) {
+        routes.insert(uri + 1).prototype = &reqUris;
+        FakeRoute& route = routes.insert(uri);
+        route.rspUri = uri + 1;
+        route.prototype = &reqUris;
+        route.rspPrototype = &reqUris;
+        route.callback = make_shared<FakeCallback>();
+    }
+
+    uint64_t sum = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (uint32_t uri : seq) {
+            const FakeRoute* route = routes.find(uri);
+            if (route && route->prototype && route->callback) {
+                route->callback->callCnt++;
+                sum += route->rspUri;
+            }
+        }
+    }
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    report("table", (uint64_t)rounds * seq.size(), ns, sum);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        cout << "usage:" << argv[0] << " [uri num] [rounds]" << endl;
+        return -1;
+    }
+
+    int uriNum = atoi(argv[1]);
+    int rounds = atoi(argv[2]);
+
+    // req uri even, rsp uri = req uri + 1, 100 cmds per service
+    vector<uint32_t> reqUris;
+    for (int i = 0; i < uriNum; i++) {
+        reqUris.push_back((uint32_t)((100 + i / 100) << 8 | (i % 100) * 2));
+    }
+
+    mt19937 rng(42);
+    vector<uint32_t> seq(1 << 16);
+    for (uint32_t& uri : seq) {
+        uri = reqUris[rng() % reqUris.size()];
+    }
+
+    // twice each, the first round warms up
+    for (int i = 0; i < 2; i++) {
+        runMaps(reqUris, seq, rounds);
+        runTable(reqUris, seq, rounds);
+    }
+    return 0;
+}
+
+/*
+
+$ ./exe_route_bench 500 200
+
+ns/dispatch covers the uri resolution only, parse and callback excluded
+
+ */
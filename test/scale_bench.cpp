@@ -0,0 +1,197 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// worker scaling under a load step: the server starts with 1 worker and
+// ScaleOption(max 4), client threads call a cpu burning handler, reconnect
+// every few calls, then stop. prints the workers alive and the qps every
+// half second.
+
+#include "server.h"
+#include "client/client_pb.h"
+#include "proto_pb/echo.pb.h"
+#include <atomic>
+#include <chrono>
+#include <dirent.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+static int spinUs = 200;
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    auto end = chrono::steady_clock::now() + chrono::microseconds(spinUs);
+    while (chrono::steady_clock::now() < end) {
+    }
+    rsp->set_retcode(1);
+    rsp->set_sid(req->sid());
+}
+
+static pid_t startServer(int port) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    ServiceAddrOption serviceAddrOption;
+    serviceAddrOption.ip_ = "127.0.0.1";
+    serviceAddrOption.port_ = port;
+    serviceAddrOption.isIPv6_ = false;
+
+    CommonOption commonOption;
+    commonOption.workerNum_ = 1;
+    commonOption.idleTimeout_ = 600;
+
+    AcceptOption acceptOption;
+    acceptOption.strategy_ = ACCEPT_STRATEGY_WATCHER;
+
+    ScaleOption scaleOption;
+    scaleOption.enable_ = true;
+    scaleOption.maxWorkerNum_ = 4;
+    scaleOption.intervalMs_ = 500;
+    scaleOption.upRounds_ = 2;
+    scaleOption.downRounds_ = 4;
+
+    HotRestartOption hotRestartOption;
+    hotRestartOption.drainIdleSec_ = 0;
+
+    // per worker load, one line per worker alive
+    WorkerStatsOption workerStatsOption;
+    workerStatsOption.enable_ = true;
+    workerStatsOption.dumpIntervalMs_ = 500;
+
+    vector<option> vecOpt;
+    vecOpt.push_back(ServerOptions::createServiceAddrOption(serviceAddrOption));
+    vecOpt.push_back(ServerOptions::createCommonOption(commonOption));
+    vecOpt.push_back(ServerOptions::createAcceptOption(acceptOption));
+    vecOpt.push_back(ServerOptions::createScaleOption(scaleOption));
+    vecOpt.push_back(ServerOptions::createHotRestartOption(hotRestartOption));
+    vecOpt.push_back(ServerOptions::createWorkerStatsOption(workerStatsOption));
+
+    {
+        Server srv(vecOpt);
+        srv.pbRegisterCallback<EchoReq, EchoRsp>(onEchoReq);
+        srv.run();
+    }
+    _exit(0);
+}
+
+static void stopServer(pid_t pid) {
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+// children of the watcher
+static int countWorkers(pid_t watcher) {
+    int num = 0;
+    DIR* dir = opendir("/proc");
+    if (!dir) {
+        return -1;
+    }
+    while (struct dirent* ent = readdir(dir)) {
+        char path[300];
+        snprintf(path, sizeof(path), "/proc/%s/stat", ent->d_name);
+        FILE* fp = fopen(path, "r");
+        if (!fp) {
+            continue;
+        }
+        int pid = 0;
+        int ppid = 0;
+        char comm[64];
+        char state;
+        if (4 == fscanf(fp, "%d %63s %c %d", &pid, comm, &state, &ppid) &&
+                ppid == watcher && state != 'Z') {
+            num++;
+        }
+        fclose(fp);
+    }
+    closedir(dir);
+    return num;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 6) {
+        cout << "usage:" << argv[0] << " [client threads] [handler spin us]"
+            " [load seconds] [idle seconds] [port]" << endl;
+        return -1;
+    }
+
+    int threadNum = atoi(argv[1]);
+    spinUs = atoi(argv[2]);
+    int loadSec = atoi(argv[3]);
+    int idleSec = atoi(argv[4]);
+    int port = atoi(argv[5]);
+
+    pid_t pid = startServer(port);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    ClientOptions opt;
+    opt.serviceAddrOption.ip_ = "127.0.0.1";
+    opt.serviceAddrOption.port_ = port;
+
+    std::atomic<bool> isStop(false);
+    std::atomic<uint64_t> okCnt(0);
+    std::atomic<uint64_t> failCnt(0);
+    auto storm = [&]() {
+        EchoReq req;
+        req.set_sid("scale");
+        std::shared_ptr<EchoRsp> rsp;
+        while (!isStop) {
+            // a new conn now and then, it lands on the least loaded worker
+            PbClient client(opt);
+            for (int i = 0; i < 50 && !isStop; i++) {
+                if (!client.isOk() ||
+                    !client.synCall<EchoReq, EchoRsp>(req, rsp)) {
+                    failCnt++;
+                    break;
+                }
+                okCnt++;
+            }
+        }
+    };
+
+    vector<std::thread> threads;
+    for (int i = 0; i < threadNum; i++) {
+        threads.emplace_back(storm);
+    }
+
+    uint64_t lastOk = 0;
+    for (int i = 0; i < (loadSec + idleSec) * 2; i++) {
+        if (i == loadSec * 2) {
+            isStop = true;
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        uint64_t ok = okCnt.load();
+        printf("%4.1fs %-4s workers:%d qps:%lu\n", (i + 1) / 2.0,
+            i < loadSec * 2 ? "load" : "idle", countWorkers(pid),
+            (unsigned long)((ok - lastOk) * 2));
+        lastOk = ok;
+    }
+
+    stopServer(pid);
+    printf("ok:%lu fail:%lu\n", (unsigned long)okCnt.load(),
+        (unsigned long)failCnt.load());
+    return 0;
+}
+
+/*
+
+$ ./exe_scale_bench 8 200 5 10 8980
+
+workers go up to 4 while the loops are busy, then down to 1 one by one
+once idle(downRounds_ rounds each), a retired worker drains first.
+cat /tmp/tinyrpc_worker_stats while it runs for the conns, qps and busy
+percent of each worker.
+
+ */
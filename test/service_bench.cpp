@@ -0,0 +1,115 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// cost of dispatching one EchoReq frame, parse + handler + serialize + send:
+//   callback: pbRegisterCallback path, std::function behind ICallback,
+//             shared_ptr<void> req/rsp and casts
+//   service:  EchoServiceDef(protoc-gen-tinyrpc), req/rsp on the stack, the
+//             member function is called directly
+// the response goes to a unix socketpair, drained now and then.
+
+#include "codec.h"
+#include "connection.h"
+#include "dispatcher_base/service.h"
+#include "test_util.h"
+#include "proto_pb/echo.pb.h"
+#include "proto_pb/echo.tinyrpc.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+class EchoImpl {
+public:
+    void Echo(const EchoReq& req, EchoRsp& rsp) {
+        rsp.set_retcode(1);
+        rsp.set_info("world");
+        rsp.set_sid(req.sid());
+        rsp.set_loginid(req.loginid());
+    }
+};
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp) {
+    rsp->set_retcode(1);
+    rsp->set_info("world");
+    rsp->set_sid(req->sid());
+    rsp->set_loginid(req->loginid());
+}
+
+static string makeFrame() {
+    EchoReq req;
+    req.set_sid("bench-sid-0123456789");
+    req.set_loginid(7);
+    req.set_info("hello");
+    return test::packPbFrame(req);
+}
+
+static void run(const char* name, Protocol& protocol, int count) {
+    int fds[2];
+    if (!test::makeSocketPair(fds)) {
+        return;
+    }
+    Connection conn(fds[0]);
+    string frame = makeFrame();
+
+    int fail = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        if (!protocol.dispatch(frame.data(), frame.size(), EchoReq::URI,
+                               &conn)) {
+            fail++;
+        }
+        if ((i & 63) == 63) {
+            test::drainFd(fds[1]);
+        }
+    }
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    test::drainFd(fds[1]);
+    close(fds[1]);
+
+    printf("%-8s calls:%d fail:%d ns/call:%.1f\n", name, count, fail,
+           (double)ns / count);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        cout << "usage:" << argv[0] << " [calls]" << endl;
+        return -1;
+    }
+
+    int count = atoi(argv[1]);
+
+    pb::PbProtocol callbackProtocol;
+    auto dispatcher = std::static_pointer_cast<pb::Dispatcher>(
+        callbackProtocol.getDispatcher());
+    dispatcher->registerCallback<EchoReq, EchoRsp>(onEchoReq);
+
+    EchoImpl impl;
+    detail::ServiceProtocol<EchoServiceDef<EchoImpl>> serviceProtocol(&impl,
+        nullptr);
+
+    // twice each, the first round warms up
+    for (int i = 0; i < 2; i++) {
+        run("callback", callbackProtocol, count);
+        run("service", serviceProtocol, count);
+    }
+    return 0;
+}
+
+/*
+
+$ ./exe_service_bench 1000000
+
+ns/call includes a send(2) per call on both paths
+
+ */
@@ -0,0 +1,156 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// ShmCache created before fork:
+//   a forked process sets 1000 keys, this one reads them with their flags,
+//       and a key set here is read there
+//   a set of a key replaces its value, erase drops it
+//   an item of ttl 50ms is gone after 100ms
+//   1 shard of 4 pages of 64KB, 1KB values: sets go on past the memory by
+//       evicting the oldest items of the class
+//   a value over maxItemBytes_ is refused
+//   maxItemBytes_ of 4097: items up to it share pages in chunks of 4104
+
+#include "shm_cache.h"
+#include "test_util.h"
+#include <string>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+
+static string makeKey(int i) {
+    return "key-" + to_string(i);
+}
+
+static void testFork() {
+    ShmCache cache;
+    CHECK(cache.create(ShmCacheOption()));
+
+    cache.set("parent", "from parent");
+    pid_t pid = fork();
+    if (0 == pid) {
+        for (int i = 0; i < 1000; i++) {
+            cache.set(makeKey(i), "value-" + to_string(i), 0, i);
+        }
+        string value;
+        _exit(cache.get("parent", value) && "from parent" == value ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    CHECK(WIFEXITED(status) && 0 == WEXITSTATUS(status));
+
+    int found = 0;
+    for (int i = 0; i < 1000; i++) {
+        string value;
+        uint32_t flags = 0;
+        if (cache.get(makeKey(i), value, &flags) &&
+            "value-" + to_string(i) == value && (uint32_t)i == flags) {
+            found++;
+        }
+    }
+    CHECK(1000 == found);
+
+    cache.set(makeKey(0), "replaced");
+    string value;
+    CHECK(cache.get(makeKey(0), value) && "replaced" == value);
+    CHECK(cache.erase(makeKey(0)));
+    CHECK(!cache.get(makeKey(0), value));
+
+    ShmCacheStats stats = cache.getStats();
+    CHECK(1000 == stats.items);
+    CHECK(0 == stats.evictions);
+}
+
+static void testTtl() {
+    ShmCache cache;
+    CHECK(cache.create(ShmCacheOption()));
+
+    cache.set("short", "value", 50);
+    cache.set("long", "value", 10000);
+    string value;
+    CHECK(cache.get("short", value));
+    usleep(100 * 1000);
+    CHECK(!cache.get("short", value));
+    CHECK(cache.get("long", value));
+    CHECK(1 == cache.getStats().expirations);
+}
+
+static void testEvict() {
+    ShmCacheOption opt;
+    opt.shardNum_ = 1;
+    opt.slabBytes_ = 64 << 10;
+    opt.maxItemBytes_ = 4 << 10;
+    opt.memBytes_ = 5 * opt.slabBytes_;
+    ShmCache cache;
+    CHECK(cache.create(opt));
+
+    const string big(1000, 'x');
+    const int num = 2000;
+    for (int i = 0; i < num; i++) {
+        CHECK(cache.set(makeKey(i), big));
+    }
+    ShmCacheStats stats = cache.getStats();
+    CHECK(stats.usedPages == stats.pages);
+    CHECK(stats.items > 0 && stats.items < (uint64_t)num);
+    CHECK(stats.evictions == num - stats.items);
+
+    // LRU: the last ones are kept, the first ones gone
+    string value;
+    CHECK(cache.get(makeKey(num - 1), value) && big == value);
+    CHECK(!cache.get(makeKey(0), value));
+
+    // no page left for a class that has none: the set fails
+    CHECK(!cache.set("small", "v"));
+}
+
+static void testOversize() {
+    ShmCacheOption opt;
+    opt.maxItemBytes_ = 4 << 10;
+    ShmCache cache;
+    CHECK(cache.create(opt));
+
+    CHECK(!cache.set("big", string(opt.maxItemBytes_, 'x')));
+    CHECK(cache.set("fit", string(1 << 10, 'x')));
+    CHECK(1 == cache.getStats().failedSets);
+
+    string report;
+    cache.report(report);
+    printf("%s", report.c_str());
+}
+
+static void testUnaligned() {
+    ShmCacheOption opt;
+    opt.shardNum_ = 1;
+    opt.slabBytes_ = 64 << 10;
+    opt.maxItemBytes_ = 4097;
+    opt.memBytes_ = 4 * opt.slabBytes_;
+    ShmCache cache;
+    CHECK(cache.create(opt));
+
+    // 3900 bytes and up: the last class only
+    const int num = 20;
+    for (int i = 0; i < num; i++) {
+        string value(3900 + i, 'a' + i);
+        CHECK(cache.set(makeKey(i), value));
+    }
+    for (int i = 0; i < num; i++) {
+        string value;
+        CHECK(cache.get(makeKey(i), value) &&
+            string(3900 + i, 'a' + i) == value);
+    }
+    CHECK(0 == cache.getStats().evictions);
+}
+
+int main(int argc, char *argv[]) {
+    testFork();
+    testTtl();
+    testEvict();
+    testOversize();
+    testUnaligned();
+
+    return test::report();
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// frames and socket pairs of the codec level tests and benches(the worker
+// side runs in process, the client is the other end of a socket pair), and
+// the CHECKs of the tests.
+
+#ifndef __TEST_UTIL_H__
+#define __TEST_UTIL_H__
+
+#include "protocol.h"
+#include <string>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// counts a failed cond and goes on, see test::report
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL line %d: %s\n", __LINE__, #cond); \
+        ::tinyrpc::test::failNum()++; \
+    } \
+} while (0)
+
+namespace tinyrpc {
+namespace test {
+
+// failed CHECKs
+inline int& failNum() {
+    static int num = 0;
+    return num;
+}
+
+// OK or FAILED, the exit code of main
+inline int report() {
+    printf("%s\n", 0 == failNum() ? "OK" : "FAILED");
+    return 0 == failNum() ? 0 : 1;
+}
+
+// head + body, traceId cut to PROTOCOL_TRACEID_SIZE - 1
+inline std::string packFrame(uint32_t protocolType, uint32_t uri,
+                             const std::string& body,
+                             const std::string& traceId = std::string()) {
+    ProtocolHead head;
+    head.length = ProtocolHead::getLen() + body.size();
+    head.protocolType = protocolType;
+    head.protocolUri = uri;
+    snprintf(head.traceId, sizeof(head.traceId), "%s", traceId.c_str());
+    std::string frame(ProtocolHead::getLen(), '\0');
+    head.pack(&frame[0], frame.size());
+    return frame + body;
+}
+
+template<typename REQ>
+inline std::string packPbFrame(const REQ& req,
+                               const std::string& traceId = std::string()) {
+    std::string body;
+    req.SerializeToString(&body);
+    return packFrame(PROTOCOL_TYPE_PB, REQ::URI, body, traceId);
+}
+
+// non-blocking unix stream pair, fds[0] is the worker's end
+inline bool makeSocketPair(int fds[2]) {
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) < 0) {
+        printf("socketpair failed!\n");
+        return false;
+    }
+    return true;
+}
+
+// read and drop what is queued on fd
+inline void drainFd(int fd) {
+    char buf[65536];
+    while (recv(fd, buf, sizeof(buf), 0) > 0) {
+    }
+}
+
+} // namespace test
+} // namespace tinyrpc
+
+#endif // __TEST_UTIL_H__
@@ -0,0 +1,191 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+// a deferred uri with UriLimit{maxConcurrent_:2, maxQueued_:3} gets 8
+// pipelined EchoReqs on one read: 2 start, 3 wait, 3 are answered with
+// PROTOCOL_URI_OVERLOADED at once. then the handlers finish one by one and
+// the waiting ones take their slots. a Responder dropped without done()
+// gives its slot back too, and the request waiting for it starts on the
+// next loop iteration. the worker side(Codec, ResponseQueue, UriLimiter) runs in process,
+// the client is the other end of a unix socketpair.
+
+#include "codec.h"
+#include "connection.h"
+#include "poller.h"
+#include "responder.h"
+#include "uri_limit.h"
+#include "test_util.h"
+#include "proto_pb/echo.pb.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace tinyrpc;
+using namespace echo_proto;
+
+static vector<ResponderPtr> g_responders;
+
+static void onEchoReq(const std::shared_ptr<EchoReq>& req,
+                      const std::shared_ptr<EchoRsp>& rsp,
+                      const ResponderPtr& responder) {
+    rsp->set_retcode(1);
+    rsp->set_sid(req->sid());
+    g_responders.push_back(responder);
+}
+
+static string makeFrame(int seq) {
+    EchoReq req;
+    req.set_sid(to_string(seq));
+    return test::packPbFrame(req, "req-" + to_string(seq));
+}
+
+// frames the worker sent, by uri
+static void readFrames(Connection& client, int& rspNum, int& overloadedNum) {
+    client.tcpRecv();
+    while (true) {
+        ProtocolHead head;
+        char* package = nullptr;
+        uint32_t packageSize = 0;
+        Codec codec;
+        if (codec.unpack(&client, head, &package, packageSize) <= 0) {
+            break;
+        }
+        if (PROTOCOL_URI_OVERLOADED == head.protocolUri) {
+            overloadedNum++;
+        } else if (EchoRsp::URI == head.protocolUri) {
+            rspNum++;
+        }
+    }
+}
+
+// one loop iteration: done() responses are drained and sent
+static void runOnce(Poller& poller) {
+    poller.addTimer(1, false, [&poller](int, int, void*) {
+        poller.stop();
+    }, nullptr);
+    poller.runLoop();
+}
+
+int main(int argc, char *argv[]) {
+    int fds[2];
+    if (!test::makeSocketPair(fds)) {
+        return -1;
+    }
+    Connection conn(fds[0]);
+    conn.setStatus(CONN_STATUS_OK);
+    conn.setId(1);
+    Connection client(fds[1]);
+    client.setStatus(CONN_STATUS_OK);
+
+    Poller poller(1024);
+    UriLimiter limiter;
+    ResponseQueue rspQueue;
+    // Server::onPendingResponse and its BEFORE_POLL hook
+    rspQueue.init(&poller, [&](PendingResponse& rsp) {
+        conn.subInflight();
+        if (!rsp.isDropped) {
+            Codec::sendMessage(&conn, rsp.protocolType, rsp.rspUri, rsp.data,
+                rsp.traceId);
+        }
+    });
+    poller.addLoopHook(LOOP_HOOK_BEFORE_POLL, [&limiter]() {
+        limiter.pumpReleased();
+    });
+
+    UriLimit limit;
+    limit.maxConcurrent_ = 2;
+    limit.maxQueued_ = 3;
+    CHECK(limiter.setLimit(EchoReq::URI, limit));
+    limiter.setConnFinder([&conn](int fd, uint64_t connId) {
+        return fd == conn.getFd() && connId == conn.getId() ? &conn : nullptr;
+    });
+    const UriLimitStats& stats = limiter.find(EchoReq::URI)->getStats();
+
+    Codec codec;
+    HandlerContext context;
+    context.rspQueue = &rspQueue;
+    context.uriLimiter = &limiter;
+    codec.setHandlerContext(context);
+    auto dispatcher = std::static_pointer_cast<pb::Dispatcher>(
+        codec.getProtocol(PROTOCOL_TYPE_PB)->getDispatcher());
+    dispatcher->registerDeferredCallback<EchoReq, EchoRsp>(onEchoReq);
+
+    string frames;
+    for (int i = 0; i < 8; i++) {
+        frames += makeFrame(i);
+    }
+    CHECK(send(fds[1], frames.data(), frames.size(), 0) ==
+        (ssize_t)frames.size());
+    conn.tcpRecv();
+    CHECK(codec.processMessage(&conn));
+
+    int rspNum = 0;
+    int overloadedNum = 0;
+    readFrames(client, rspNum, overloadedNum);
+    printf("8 requests: running:%zu concurrent:%u queued:%u rejected:%lu "
+        "overloaded frames:%d\n", g_responders.size(),
+        stats.concurrent.load(), stats.queued.load(),
+        (unsigned long)stats.rejected.load(), overloadedNum);
+    CHECK(g_responders.size() == 2);
+    CHECK(stats.concurrent == 2 && stats.queued == 3 && stats.rejected == 3);
+    CHECK(overloadedNum == 3 && rspNum == 0);
+    // 2 running + 3 waiting keep the conn busy
+    CHECK(conn.getInflight() == 5);
+
+    // finish the running ones, the waiting ones start as slots free up
+    size_t doneNum = 0;
+    while (doneNum < g_responders.size()) {
+        g_responders[doneNum++]->done();
+        runOnce(poller);
+    }
+    readFrames(client, rspNum, overloadedNum);
+    printf("all done: started:%lu concurrent:%u queued:%u responses:%d\n",
+        (unsigned long)stats.started.load(), stats.concurrent.load(),
+        stats.queued.load(), rspNum);
+    CHECK(g_responders.size() == 5 && stats.started == 5);
+    CHECK(stats.concurrent == 0 && stats.queued == 0);
+    CHECK(rspNum == 5 && conn.getInflight() == 0);
+
+    // a responder dropped without done() gives its slot back
+    g_responders.clear();
+    frames = makeFrame(8);
+    send(fds[1], frames.data(), frames.size(), 0);
+    conn.tcpRecv();
+    codec.processMessage(&conn);
+    CHECK(stats.concurrent == 1);
+    g_responders.clear();
+    printf("dropped responder: concurrent:%u\n", stats.concurrent.load());
+    CHECK(stats.concurrent == 0);
+    runOnce(poller);
+    CHECK(conn.getInflight() == 0);
+
+    // 2 running, 1 waiting: one running is dropped without done(), the
+    // waiting one starts with no response or request of the uri after it
+    frames = makeFrame(9) + makeFrame(10) + makeFrame(11);
+    send(fds[1], frames.data(), frames.size(), 0);
+    conn.tcpRecv();
+    codec.processMessage(&conn);
+    CHECK(g_responders.size() == 2 && stats.queued == 1);
+    g_responders.erase(g_responders.begin());
+    runOnce(poller);
+    CHECK(g_responders.size() == 2 && stats.queued == 0);
+    CHECK(stats.concurrent == 2 && 2 == conn.getInflight());
+    for (auto& responder : g_responders) {
+        responder->done();
+    }
+    g_responders.clear();
+    runOnce(poller);
+    printf("waiting behind a dropped responder: started:%lu concurrent:%u "
+        "queued:%u inflight:%u\n", (unsigned long)stats.started.load(),
+        stats.concurrent.load(), stats.queued.load(), conn.getInflight());
+    CHECK(stats.concurrent == 0 && stats.queued == 0);
+    CHECK(0 == conn.getInflight());
+
+    return test::report();
+}
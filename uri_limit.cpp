@@ -0,0 +1,89 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "uri_limit.h"
+#include "connection.h"
+#include "log.h"
+
+using namespace tinyrpc;
+
+bool UriLimiter::setLimit(uint32_t uri, const UriLimit& limit) {
+    if (0 == limit.maxConcurrent_) {
+        LOG(Error, "setLimit failed, maxConcurrent is 0! uri:0x%xu", uri);
+        return false;
+    }
+    bulkheads_[uri].reset(new UriBulkhead(limit));
+    return true;
+}
+
+bool UriLimiter::tryAcquire(UriBulkhead* bulkhead) {
+    pump(bulkhead);
+
+    UriLimitStats& stats = bulkhead->stats_;
+    if (!bulkhead->waiting_.empty() || stats.concurrent.load(
+            std::memory_order_relaxed) >= bulkhead->limit_.maxConcurrent_) {
+        return false;
+    }
+    stats.concurrent.fetch_add(1, std::memory_order_relaxed);
+    stats.started.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool UriLimiter::wait(UriBulkhead* bulkhead, Connection* conn,
+                      UriStart&& start) {
+    UriLimitStats& stats = bulkhead->stats_;
+    if (bulkhead->waiting_.size() >= bulkhead->limit_.maxQueued_) {
+        stats.rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bulkhead->waiting_.push_back({conn->getFd(), conn->getId(),
+        std::move(start)});
+    stats.queued.store(bulkhead->waiting_.size(), std::memory_order_relaxed);
+    // the conn is not idle while its request waits
+    conn->addInflight();
+    return true;
+}
+
+void UriLimiter::pumpReleased() {
+    for (auto& it : bulkheads_) {
+        UriBulkhead* bulkhead = it.second.get();
+        if (bulkhead->isReleased_.load(std::memory_order_acquire) &&
+            bulkhead->isReleased_.exchange(false, std::memory_order_acquire) &&
+            !bulkhead->waiting_.empty()) {
+            pump(bulkhead);
+        }
+    }
+}
+
+void UriLimiter::pump(UriBulkhead* bulkhead) {
+    UriLimitStats& stats = bulkhead->stats_;
+    while (!bulkhead->waiting_.empty() && stats.concurrent.load(
+            std::memory_order_relaxed) < bulkhead->limit_.maxConcurrent_) {
+        UriBulkhead::Waiting waiting = std::move(bulkhead->waiting_.front());
+        bulkhead->waiting_.pop_front();
+        stats.queued.store(bulkhead->waiting_.size(),
+            std::memory_order_relaxed);
+
+        Connection* conn = connFinder_ ?
+            connFinder_(waiting.fd, waiting.connId) : nullptr;
+        if (!conn) {
+            LOG(Warn, "conn closed, drop waiting request. fd:%d",
+                waiting.fd);
+            continue;
+        }
+
+        conn->subInflight();
+        stats.concurrent.fetch_add(1, std::memory_order_relaxed);
+        stats.started.fetch_add(1, std::memory_order_relaxed);
+        waiting.start(conn);
+    }
+}
+
+void UriLimiter::forEach(const std::function<void (uint32_t,
+                         const UriLimitStats&)>& visit) const {
+    for (auto& it : bulkheads_) {
+        visit(it.first, it.second->stats_);
+    }
+}
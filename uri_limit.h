@@ -0,0 +1,133 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __URI_LIMIT_H__
+#define __URI_LIMIT_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace tinyrpc {
+
+class Connection;
+
+// bulkhead of one uri, see Server::setUriLimit
+struct UriLimit {
+    uint32_t maxConcurrent_;    // started and not done() yet
+    uint32_t maxQueued_;        // waiting for one of those slots
+
+    UriLimit()
+        : maxConcurrent_(0)
+        , maxQueued_(0) {}
+};
+
+// starts a waiting request on its conn, once the slot is taken
+using UriStart = std::function<void (Connection*)>;
+
+struct UriLimitStats {
+    std::atomic<uint32_t> concurrent;
+    std::atomic<uint32_t> queued;
+    std::atomic<uint64_t> started;
+    std::atomic<uint64_t> rejected;
+
+    UriLimitStats()
+        : concurrent(0)
+        , queued(0)
+        , started(0)
+        , rejected(0) {}
+};
+
+// the slots and the waiting requests of one uri, owned by UriLimiter
+class UriBulkhead {
+public:
+    explicit UriBulkhead(const UriLimit& limit)
+        : limit_(limit), isReleased_(false) {}
+    UriBulkhead(const UriBulkhead&) = delete;
+    UriBulkhead& operator = (const UriBulkhead&) = delete;
+
+    // a slot is given back, any thread. the loop starts the next waiting
+    // request in UriLimiter::pumpReleased
+    void release() {
+        stats_.concurrent.fetch_sub(1, std::memory_order_relaxed);
+        isReleased_.store(true, std::memory_order_release);
+    }
+
+    const UriLimitStats& getStats() const { return stats_; }
+
+private:
+    friend class UriLimiter;
+
+    struct Waiting {
+        int fd;
+        uint64_t connId;
+        UriStart start;
+    };
+
+    UriLimit limit_;
+    UriLimitStats stats_;
+    std::deque<Waiting> waiting_;   // loop only
+    std::atomic<bool> isReleased_;  // a slot given back since the last pump
+};
+
+/*
+ * Per uri bulkheads of a worker. At most maxConcurrent_ requests of a uri
+ * are handled at once, up to maxQueued_ more wait on the loop for a slot,
+ * the others are answered with PROTOCOL_URI_OVERLOADED at once. Only
+ * requests answered later are limited(CALLBACK_MODE_DEFERRED/POOL): an
+ * inline handler is done before the next request is read.
+ *
+ * A slot is taken on the loop and given back by Responder, from any thread.
+ * The waiting requests are started by pumpReleased, before the loop polls,
+ * or when the next request of the uri comes. The Responder's response, or
+ * its drop, wakes the loop up.
+ */
+class UriLimiter {
+public:
+    // the conn of a waiting request, nullptr if it is closed
+    using ConnFinder = std::function<Connection* (int fd, uint64_t connId)>;
+
+    UriLimiter() = default;
+    UriLimiter(const UriLimiter&) = delete;
+    UriLimiter& operator = (const UriLimiter&) = delete;
+
+    // before the loop runs. false if maxConcurrent_ is 0
+    bool setLimit(uint32_t uri, const UriLimit& limit);
+    void setConnFinder(const ConnFinder& finder) { connFinder_ = finder; }
+    bool empty() const { return bulkheads_.empty(); }
+
+    // nullptr: uri is not limited
+    UriBulkhead* find(uint32_t uri) const {
+        auto it = bulkheads_.find(uri);
+        return it != bulkheads_.end() ? it->second.get() : nullptr;
+    }
+
+    // take a slot for a request to start now. false: no free slot, or
+    // earlier requests are waiting for one
+    bool tryAcquire(UriBulkhead* bulkhead);
+    // queue a request until a slot is free. false: the queue is full, the
+    // request is rejected
+    bool wait(UriBulkhead* bulkhead, Connection* conn, UriStart&& start);
+    // on the loop: start waiting requests of the uris whose slots were
+    // given back, while there are free slots
+    void pumpReleased();
+
+    // visit every limited uri, for stats
+    void forEach(const std::function<void (uint32_t, const UriLimitStats&)>&
+                 visit) const;
+
+private:
+    void pump(UriBulkhead* bulkhead);
+
+    ConnFinder connFinder_;
+    // read only after the loop runs
+    std::unordered_map<uint32_t, std::unique_ptr<UriBulkhead>> bulkheads_;
+};
+
+} // namespace tinyrpc
+
+#endif // __URI_LIMIT_H__
@@ -4,6 +4,13 @@
 
 #include "util.h"
 #include "log.h"
+#include <sched.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <errno.h>
+#include <string.h>
 
 using namespace tinyrpc;
 
@@ -51,3 +58,92 @@ sighandler_t Util::registerSignal(int signo, sighandler_t func,
         
     return oldsig.sa_handler;
 }
+
+bool Util::setCpuAffinity(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (-1 == sched_setaffinity(0, sizeof(set), &set)) {
+        LOG(Error, "sched_setaffinity failed, cpu:%d, err:%s", cpu,
+            strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int Util::getCpuNum() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+bool Util::getAllowedCpus(std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (-1 == sched_getaffinity(0, sizeof(set), &set)) {
+        LOG(Error, "sched_getaffinity failed, err:%s", strerror(errno));
+        return false;
+    }
+
+    cpus.clear();
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return !cpus.empty();
+}
+
+int Util::getCpuNode(int cpu) {
+    // /sys/devices/system/cpu/cpuN/nodeM links to its node
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return -1;
+    }
+
+    int node = -1;
+    struct dirent* entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (1 == sscanf(entry->d_name, "node%d", &node)) {
+            break;
+        }
+        node = -1;
+    }
+    closedir(dir);
+    return node;
+}
+
+bool Util::bindMemoryToNode(int node) {
+    // mask of 1024 nodes, no libnuma
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {0};
+    const int bits = 8 * sizeof(unsigned long);
+    if (node < 0 || node >= (int)(sizeof(mask) * 8)) {
+        return false;
+    }
+    mask[node / bits] |= 1UL << (node % bits);
+
+    if (-1 == syscall(SYS_set_mempolicy, MPOL_BIND, mask,
+                      sizeof(mask) * 8)) {
+        LOG(Error, "set_mempolicy failed, node:%d, err:%s", node,
+            strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+uint64_t Util::hashBytes(const char* data, size_t len, uint64_t seed) {
+    const uint64_t mul = 0x9e3779b97f4a7c15ULL;
+    uint64_t h = (seed + 1) * mul ^ len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = (h ^ w) * mul;
+        h ^= h >> 32;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, len - i);
+    h = (h ^ tail) * mul;
+    return h ^ (h >> 29);
+}
@@ -8,6 +8,9 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
 
 
 /*
@@ -32,6 +35,26 @@ public:
 
     // clear file flags by fcntl, eg: clr_fl(sockfd, O_NONBLOCK);
     static int clear_fl(int fd, int flags);
+
+    // pin the calling process to one cpu, sched_setaffinity
+    static bool setCpuAffinity(int cpu);
+
+    // online cpus
+    static int getCpuNum();
+
+    // cpus this process may run on(sched_getaffinity), ascending
+    static bool getAllowedCpus(std::vector<int>& cpus);
+
+    // numa node of a cpu from sysfs, -1 if unknown(no NUMA)
+    static int getCpuNode(int cpu);
+
+    // set_mempolicy(MPOL_BIND): later page faults of the calling process
+    // are served from the node only, memory touched before stays where it is
+    static bool bindMemoryToNode(int node);
+
+    // 64 bit hash of bytes, 8 a step. not for untrusted keys that pick
+    // collisions on purpose: compare the bytes too
+    static uint64_t hashBytes(const char* data, size_t len, uint64_t seed = 0);
 };
 
 } // namespace tinyrpc
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#include "worker_load.h"
+#include "log.h"
+#include <sys/mman.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+using namespace tinyrpc;
+
+bool WorkerLoadTable::create(uint32_t workerNum) {
+    void* addr = mmap(nullptr, sizeof(WorkerLoad) * workerNum,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == addr) {
+        LOG(Error, "mmap failed, err:%s", strerror(errno));
+        return false;
+    }
+
+    loads_ = static_cast<WorkerLoad*>(addr);
+    workerNum_ = workerNum;
+    for (uint32_t i = 0; i < workerNum_; i++) {
+        new (&loads_[i]) WorkerLoad();
+        loads_[i].reset();
+    }
+    return true;
+}
+
+void WorkerLoadTable::destroy() {
+    if (loads_) {
+        munmap(loads_, sizeof(WorkerLoad) * workerNum_);
+        loads_ = nullptr;
+        workerNum_ = 0;
+    }
+}
+
+// counters restart from 0 with a new worker
+static uint64_t delta(uint64_t cur, uint64_t last) {
+    return cur >= last ? cur - last : cur;
+}
+
+void WorkerLoadTable::report(std::vector<WorkerLoadSample>& samples,
+                             int64_t nowUs, std::string& out) const {
+    samples.resize(workerNum_);
+
+    char line[256];
+    snprintf(line, sizeof(line), "workers %u\n", workerNum_);
+    out.append(line);
+
+    uint32_t totalConn = 0;
+    uint32_t totalInflight = 0;
+    double totalQps = 0;
+    double totalIn = 0;
+    double totalOut = 0;
+    double totalBusy = 0;
+    for (uint32_t i = 0; i < workerNum_; i++) {
+        const WorkerLoad& load = loads_[i];
+        WorkerLoadSample cur;
+        cur.us = nowUs;
+        cur.reqNum = load.reqNum.load(std::memory_order_relaxed);
+        cur.bytesIn = load.bytesIn.load(std::memory_order_relaxed);
+        cur.bytesOut = load.bytesOut.load(std::memory_order_relaxed);
+        cur.busyUs = load.busyUs.load(std::memory_order_relaxed);
+        uint32_t conn = load.connNum.load(std::memory_order_relaxed);
+        uint32_t inflight = load.inflight.load(std::memory_order_relaxed);
+
+        WorkerLoadSample& last = samples[i];
+        double sec = last.us > 0 && nowUs > last.us ?
+            (nowUs - last.us) / 1e6 : 0;
+        double qps = 0;
+        double inBps = 0;
+        double outBps = 0;
+        double busy = 0;
+        if (sec > 0) {
+            qps = delta(cur.reqNum, last.reqNum) / sec;
+            inBps = delta(cur.bytesIn, last.bytesIn) / sec;
+            outBps = delta(cur.bytesOut, last.bytesOut) / sec;
+            busy = delta(cur.busyUs, last.busyUs) / (sec * 1e4);
+        }
+        last = cur;
+
+        snprintf(line, sizeof(line), "worker %u conns %u inflight %u "
+            "paused %u qps %.0f in_bps %.0f out_bps %.0f busy_pct %.1f\n",
+            i, conn, inflight,
+            load.acceptPaused.load(std::memory_order_relaxed), qps, inBps,
+            outBps, busy);
+        out.append(line);
+
+        totalConn += conn;
+        totalInflight += inflight;
+        totalQps += qps;
+        totalIn += inBps;
+        totalOut += outBps;
+        totalBusy += busy;
+    }
+
+    snprintf(line, sizeof(line), "total conns %u inflight %u qps %.0f "
+        "in_bps %.0f out_bps %.0f busy_pct %.1f\n", totalConn, totalInflight,
+        totalQps, totalIn, totalOut,
+        workerNum_ > 0 ? totalBusy / workerNum_ : 0);
+    out.append(line);
+}
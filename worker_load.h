@@ -0,0 +1,114 @@
+// Copyright (c) 2025 <York Zeng> All rights reserved.
+// Use of this source code is governed by a MIT-style license that can be
+// found in the LICENSE file.
+
+#ifndef __WORKER_LOAD_H__
+#define __WORKER_LOAD_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace tinyrpc {
+
+// load of one worker, a cache line each: written by its worker(and by the
+// watcher when it hands out a conn), read by the watcher. the worker
+// publishes its plain counters once per loop iteration, relaxed stores
+struct alignas(64) WorkerLoad {
+    std::atomic<uint32_t> connNum;
+    std::atomic<uint32_t> inflight;     // requests waiting for response
+    std::atomic<uint32_t> acceptPaused; // 1: over the conn high watermark
+    std::atomic<uint64_t> acceptPausedUs;   // total, the current pause too
+    std::atomic<uint32_t> ready;        // 1: the worker loop is running
+    std::atomic<uint64_t> reqNum;       // requests dispatched, total
+    std::atomic<uint64_t> bytesIn;      // read from conns, total
+    std::atomic<uint64_t> bytesOut;     // written to conns, total
+    std::atomic<uint64_t> busyUs;       // loop out of epoll_wait, total
+
+    void reset() {
+        connNum.store(0, std::memory_order_relaxed);
+        inflight.store(0, std::memory_order_relaxed);
+        acceptPaused.store(0, std::memory_order_relaxed);
+        acceptPausedUs.store(0, std::memory_order_relaxed);
+        ready.store(0, std::memory_order_relaxed);
+        reqNum.store(0, std::memory_order_relaxed);
+        bytesIn.store(0, std::memory_order_relaxed);
+        bytesOut.store(0, std::memory_order_relaxed);
+        busyUs.store(0, std::memory_order_relaxed);
+    }
+};
+
+static_assert(sizeof(WorkerLoad) == 64, "WorkerLoad is one cache line");
+
+// totals of a WorkerLoad at some time, rates are taken between two samples
+struct WorkerLoadSample {
+    int64_t us;         // monotonic, 0: no sample yet
+    uint64_t reqNum;
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    uint64_t busyUs;
+
+    WorkerLoadSample() : us(0), reqNum(0), bytesIn(0), bytesOut(0), busyUs(0) {}
+};
+
+/*
+ * Per-worker load in shared memory(MAP_SHARED | MAP_ANONYMOUS), created by
+ * the watcher before fork so every process maps the same pages.
+ */
+class WorkerLoadTable {
+public:
+    WorkerLoadTable() : loads_(nullptr), workerNum_(0) {}
+    WorkerLoadTable(const WorkerLoadTable&) = delete;
+    WorkerLoadTable& operator = (const WorkerLoadTable&) = delete;
+    ~WorkerLoadTable() { destroy(); }
+
+    bool create(uint32_t workerNum);
+    void destroy();
+
+    WorkerLoad* at(int workerIndex) {
+        return (loads_ && workerIndex >= 0 && (uint32_t)workerIndex < workerNum_)
+            ? &loads_[workerIndex] : nullptr;
+    }
+
+    // text report, a line per worker and the total: conns, inflight, qps,
+    // bytes/s in and out, busy percent of the loop. rates since samples,
+    // which are updated to nowUs
+    void report(std::vector<WorkerLoadSample>& samples, int64_t nowUs,
+                std::string& out) const;
+
+    // least conns, then least inflight; isAlive(index) filters dead workers,
+    // paused workers are skipped. -1 if none
+    template<typename ALIVE>
+    int pickLeastLoaded(ALIVE isAlive) const;
+
+private:
+    WorkerLoad* loads_;
+    uint32_t workerNum_;
+};
+
+template<typename ALIVE>
+int WorkerLoadTable::pickLeastLoaded(ALIVE isAlive) const {
+    int best = -1;
+    uint32_t bestConn = 0;
+    uint32_t bestInflight = 0;
+    for (uint32_t i = 0; i < workerNum_; i++) {
+        if (!isAlive(i) ||
+                loads_[i].acceptPaused.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        uint32_t conn = loads_[i].connNum.load(std::memory_order_relaxed);
+        uint32_t inflight = loads_[i].inflight.load(std::memory_order_relaxed);
+        if (best < 0 || conn < bestConn ||
+            (conn == bestConn && inflight < bestInflight)) {
+            best = i;
+            bestConn = conn;
+            bestInflight = inflight;
+        }
+    }
+    return best;
+}
+
+} // namespace tinyrpc
+
+#endif // __WORKER_LOAD_H__